@@ -33,6 +33,12 @@
 int st_main(int argc, char** argv, const char* app_name, const st_cl_arg* args,
     size_t num_args, st_test* tests, size_t num_tests);
 
+/** Like st_main, but also runs the tests registered with ST_TEST, whose
+ * descriptors lie in [`reg_begin`, `reg_end`). */
+int st_main_ex(int argc, char** argv, const char* app_name, const st_cl_arg* args,
+    size_t num_args, st_test* tests, size_t num_tests, const st_test_reg* const* reg_begin,
+    const st_test_reg* const* reg_end);
+
 bool st_validate_config(const char* app_name, const st_test* tests, size_t num_tests);
 bool st_prepare_tests(st_test* tests, size_t num_tests);
 
@@ -44,10 +50,238 @@ void st_print_test_summary(size_t passed, size_t to_run, const st_test* tests,
 void st_print_failed_test_intro(size_t passed, size_t to_run);
 void st_print_failed_test(const char* const name);
 
-/** Marks a test to be executed during the current run. Returns false if unable to
- * locate the specified test. */
+/** Marks a test (or, given 'name/case', a single case of a parameterized test) to be
+ * executed during the current run. Returns false if unable to locate the specified
+ * test. */
 bool st_mark_test_to_run(const char* const name, st_test* tests, size_t num_tests);
 
+/** Builds a hash index of the names of `tests`, used by st_find_test. Fails (and
+ * reports an error) if more than one test has the same name. */
+bool st_index_tests(st_test_index* index, const st_test* tests, size_t num_tests);
+
+/** Releases the memory used by an index built by st_index_tests. */
+void st_free_test_index(st_test_index* index);
+
+/** Returns the test named `name` (exactly), or NULL if there isn't one. */
+st_test* st_find_test(const char* name, st_test* tests, size_t num_tests);
+
+/** Returns the 64-bit FNV-1a hash of a string. */
+uint64_t st_hash_str(const char* str);
+
+/** Returns true if `str` matches the glob `pattern` ('*', '?', and [sets]). */
+bool st_glob_match(const char* pattern, const char* str);
+
+/** Selects the tests that match the patterns given to --filter (and, if given,
+ * were named by --only). Fails if no tests are selected. */
+bool st_apply_filters(st_cl_config* config, st_test* tests, size_t num_tests);
+
+/** Releases the patterns given to --filter. */
+void st_free_filters(st_cl_config* config);
+
+/** Builds the table of all tags and suites used by `tests`, and each test's
+ * tagset. */
+bool st_index_tags(st_tag_table* table, st_test* tests, size_t num_tests);
+
+/** Compiles a --tags expression (e.g. 'fast & !(network | io)') against `table`. */
+bool st_compile_tag_expr(const char* str, const st_tag_table* table, st_tag_expr* expr);
+
+/** Evaluates a compiled --tags expression for a test's tagset. */
+bool st_eval_tag_expr(const st_tag_expr* expr, const st_tagset* tagset);
+
+/** Selects the tests that match the expression given to --tags (and were selected
+ * by --only/--filter, if given). Fails if no tests are selected. */
+bool st_select_tagged(st_cl_config* config, st_test* tests, size_t num_tests);
+
+/** Prints the list of available tests, grouped by suite or by tag. */
+bool st_print_test_groups(st_test* tests, size_t num_tests, bool by_tag);
+
+/** Begins an iteration over the cases of a parameterized test. Returns false if
+ * its data file could not be opened or mapped. */
+bool st_cases_begin(st_case_iter* iter, const st_case_source* source);
+
+/** Produces the next case of an iteration. Returns false if there are no more. */
+bool st_cases_next(st_case_iter* iter, st_case* out);
+
+/** Ends an iteration over the cases of a parameterized test. */
+void st_cases_end(st_case_iter* iter);
+
+/** Maps a file into memory, read-only. `data` is NULL if the file is empty. */
+bool st_map_file(const char* path, const char** data, size_t* size);
+
+/** Unmaps a file mapped by st_map_file. */
+void st_unmap_file(const char* data, size_t size);
+
+/** Allocates `size` bytes of scratch memory, which remain valid until the current
+ * test ends. Returns NULL if unable to allocate. */
+void* st_scratch_alloc(size_t size);
+
+/** Returns true if no two of the `count` elements of `arr` are equal, otherwise printing
+ * the indices of the first duplicate. Elements are compared bitwise, unless `kind` is
+ * ST_VALUE_REAL, in which case they are compared as by == (so 0.0 equals -0.0, and NaN
+ * equals nothing). Used by ST_ARRAY_UNIQUE. */
+bool st_array_unique(const void* arr, size_t count, size_t elem_size, int kind);
+
+/** Returns true if `rhs` is a rearrangement of `lhs` (the same values, each occurring
+ * the same number of times), with elements compared as by st_array_unique. Used by
+ * ST_ARRAY_PERMUTATION_OF. */
+bool st_array_permutation_of(const void* lhs, size_t lhs_count, const void* rhs,
+    size_t rhs_count, size_t elem_size, int kind);
+
+/** Returns true if `lhs` and `rhs` contain the same distinct values, regardless of
+ * order or repetition, with elements compared as by st_array_unique. Used by
+ * ST_ARRAY_SET_EQUAL. */
+bool st_array_set_equal(const void* lhs, size_t lhs_count, const void* rhs,
+    size_t rhs_count, size_t elem_size, int kind);
+
+/** Returns true if the spans `lhs` and `rhs` have the same number of equal elements,
+ * otherwise printing the index and values of the first pair that differ. Elements of
+ * the same (non-floating-point) kind are compared bitwise. Used by ST_SPAN_EQUAL. */
+bool st_span_equal(const void* lhs, size_t lhs_count, int lhs_kind, const void* rhs,
+    size_t rhs_count, int rhs_kind, size_t elem_size);
+
+/** Returns true if an element of `span` is equal in value to `value`. Used by
+ * ST_SPAN_CONTAINS. */
+bool st_span_contains(const void* span, size_t count, size_t elem_size, int kind,
+    st_value value);
+
+/** Returns true if no element of `span` is equal in value to `value`, otherwise
+ * printing the index of the first that is. Used by ST_SPAN_NOT_CONTAINS. */
+bool st_span_not_contains(const void* span, size_t count, size_t elem_size, int kind,
+    st_value value);
+
+/** Returns true if each of the `len` bytes at `ptr` is `byte`, otherwise printing the
+ * offset of the first that isn't and a hex window around it. Used by ST_MEM_FILLED
+ * and ST_BITWISE_ZEROED. */
+bool st_mem_filled(const void* ptr, size_t len, uint8_t byte);
+
+/** Returns true if any of the `len` bytes at `ptr` is not `byte`. Used by
+ * ST_BITWISE_NOT_ZEROED. */
+bool st_mem_not_filled(const void* ptr, size_t len, uint8_t byte);
+
+/** Returns true if the `len` bytes at `ptr` repeat the `pattern_len` bytes at
+ * `pattern` (the last repetition may be partial), otherwise printing the offset of
+ * the first that don't and a hex window around it. Used by ST_MEM_PATTERN. */
+bool st_mem_pattern(const void* ptr, size_t len, const void* pattern, size_t pattern_len);
+
+/** Returns true if each of the first `len` characters of `str` is one of those in
+ * `set`, otherwise printing the index of the first that isn't. Used by
+ * ST_STR_ONLY_CHARS, ST_STR_ALPHA, ST_STR_NUMERIC and ST_STR_ALPHANUMERIC. */
+bool st_str_only_chars(const char* str, size_t len, const char* set);
+
+/** Returns true if the `len` bytes at `str` are well-formed UTF-8 (RFC 3629),
+ * otherwise printing the offset of the first invalid sequence. Used by
+ * ST_STR_UTF8_VALID. */
+bool st_str_utf8_valid(const char* str, size_t len);
+
+/** Returns true if `str` contains a match for the extended regular expression
+ * `pattern`. The first pattern compiled at `site` (an ST_STR_MATCHES call site) is
+ * kept until st_main returns. Used by ST_STR_MATCHES. */
+bool st_str_matches(st_regex_site* site, const char* str, const char* pattern);
+
+/** Returns true if `str` contains no match for `pattern`, otherwise printing the
+ * first. Used by ST_STR_NOT_MATCHES. */
+bool st_str_not_matches(st_regex_site* site, const char* str, const char* pattern);
+
+/** Returns true if the `lhs_len` bytes at `lhs` equal the `rhs_len` bytes at `rhs`
+ * (ignoring the case of ASCII letters if `ignore_case`), otherwise printing the
+ * first difference. Used by ST_BUF_EQUAL and ST_BUF_EQUAL_I. */
+bool st_buf_equal(const char* lhs, size_t lhs_len, const char* rhs, size_t rhs_len,
+    bool ignore_case);
+
+/** The negation of st_buf_equal. Used by ST_BUF_NOT_EQUAL and ST_BUF_NOT_EQUAL_I. */
+bool st_buf_not_equal(const char* lhs, size_t lhs_len, const char* rhs, size_t rhs_len,
+    bool ignore_case);
+
+/** Returns true if the `needle_len` bytes at `needle` occur in the `haystack_len`
+ * bytes at `haystack`. The search takes linear time, and neither buffer need be
+ * NUL-terminated. Used by ST_BUF_CONTAINS and ST_BUF_CONTAINS_I. */
+bool st_buf_contains(const char* needle, size_t needle_len, const char* haystack,
+    size_t haystack_len, bool ignore_case);
+
+/** The negation of st_buf_contains; prints the offset of the first occurrence. Used
+ * by ST_BUF_NOT_CONTAINS and ST_BUF_NOT_CONTAINS_I. */
+bool st_buf_not_contains(const char* needle, size_t needle_len, const char* haystack,
+    size_t haystack_len, bool ignore_case);
+
+/** Returns true if `haystack` begins (or ends) with `needle`, otherwise printing the
+ * first difference. Used by ST_BUF_BEGINSWITH, ST_BUF_ENDSWITH and their _I forms. */
+bool st_buf_begins_with(const char* needle, size_t needle_len, const char* haystack,
+    size_t haystack_len, bool ignore_case);
+bool st_buf_ends_with(const char* needle, size_t needle_len, const char* haystack,
+    size_t haystack_len, bool ignore_case);
+
+/** The negations of st_buf_begins_with and st_buf_ends_with. Used by
+ * ST_BUF_NOT_BEGINSWITH, ST_BUF_NOT_ENDSWITH and their _I forms. */
+bool st_buf_not_begins_with(const char* needle, size_t needle_len, const char* haystack,
+    size_t haystack_len, bool ignore_case);
+bool st_buf_not_ends_with(const char* needle, size_t needle_len, const char* haystack,
+    size_t haystack_len, bool ignore_case);
+
+/** Returns true if `lhs` and `rhs` are equal, both NaN, within `abs_tol` of each other,
+ * or at most `max_ulps` representable values apart (counted in single precision if
+ * `single`), otherwise printing both values and how far apart they are. Used by
+ * ST_NEAR and ST_NEAR_ULPS. */
+bool st_near(double lhs, double rhs, double abs_tol, uint64_t max_ulps, bool single);
+
+/** Returns true if every element of the `rows` x `cols` matrix `lhs` is near (as in
+ * st_near) the corresponding element of `rhs`, otherwise printing how many are not and
+ * the worst of them. Strides are in elements; `elem_size` is that of float, double or
+ * long double. Used by ST_SPAN_NEAR and ST_MATRIX_NEAR. */
+bool st_matrix_near(const void* lhs, size_t lhs_stride, const void* rhs, size_t rhs_stride,
+    size_t rows, size_t cols, size_t elem_size, double abs_tol, uint64_t max_ulps);
+
+/** Compares `size` bytes at `data` with the snapshot (golden file) `name` in
+ * ST_SNAPSHOT_DIR, printing the first difference. With --update-snapshots, a missing
+ * or differing snapshot is rewritten instead. Used by ST_SNAPSHOT_EQUAL. */
+bool st_snapshot_equal(const char* name, const void* data, size_t size);
+
+/** Writes the snapshot `name` in ST_SNAPSHOT_DIR from the `size` bytes at `data`, as
+ * --update-snapshots does, creating any directories in `name` (e.g. "parser/empty"). */
+bool st_snapshot_update(const char* name, const void* data, size_t size);
+
+/** Compares the contents of two files, printing the first difference. Used by
+ * ST_FILE_EQUAL. */
+bool st_file_equal(const char* path_a, const char* path_b);
+
+/** Returns a case's label or, if it has none, its index formatted in `buf`. */
+const char* st_format_case(const st_case* test_case, char buf[ST_MAX_CASE_STR_LEN]);
+
+/** Returns the case of a parameterized test being run by this thread, or NULL. */
+const st_case* st_current_case(void);
+
+/** Constructs (if not already constructed) the fixtures used by a test. Returns
+ * false if any could not be constructed. */
+bool st_acquire_fixtures(st_test* test);
+
+/** Releases the fixtures used by a test, destroying those no longer needed. */
+void st_release_fixtures(const st_test* test);
+
+/** Returns the shared data of a fixture, or NULL if it isn't constructed. */
+const void* st_fixture_data(st_fixture* fixture);
+
+/** Locks and unlocks a mutex. */
+void st_mutex_lock(st_mutex* mutex);
+void st_mutex_unlock(st_mutex* mutex);
+
+/** Marks the tests named in the file at `path` (one per line) as quarantined: they
+ * still run and are reported, but their failure does not affect the exit code. */
+bool st_load_quarantine(const char* path, st_test* tests, size_t num_tests);
+
+/** Restores the results of the tests recorded in the journal at `path`. Sets
+ * `complete` to true if the journaled run finished. */
+bool st_journal_load(const char* path, st_test* tests, size_t num_tests, bool* complete);
+
+/** Creates (or truncates) the journal at `path`, carrying over the records of
+ * tests whose results were restored by st_journal_load. */
+bool st_journal_open(st_journal* journal, const char* path, const st_test* tests,
+    size_t num_tests);
+
+/** Appends the result of a completed test to the journal. */
+void st_journal_record(st_journal* journal, const st_test* test);
+
+/** Syncs and closes the journal, marking the run as finished if `complete`. */
+void st_journal_close(st_journal* journal, bool complete);
+
 /** Prints the entire list of available tests. */
 void st_print_test_list(const st_test* tests, size_t num_tests);
 
@@ -84,12 +318,127 @@ long st_timer_getres(void);
 bool st_clock_gettime(int clock, time_t* tbuf, double* msecbuf);
 double st_msec_since(const st_timer* when, st_timer* out);
 
+/** Returns the current value of the monotonic interval clock, in nanoseconds. */
+uint64_t st_clock_nsec(void);
+
+/** Enters a section (see ST_SECTION), making it the innermost active section on
+ * the calling thread. Returns `section`. */
+st_section* st_section_enter(st_section* section);
+
+/** Exits a section, recording its elapsed time. Always returns NULL. */
+st_section* st_section_leave(st_section* section);
+
+/** Attributes an evaluator failure to the innermost active section, if any.
+ * Returns a label identifying the section (or an empty string). */
+const char* st_section_on_failure(bool fatal);
+
+/** Prints the failure of the evaluator `name` at `line` (an error if `fatal`, otherwise
+ * a warning) in `color`, along with `expr`, the text of its expression. Shared by every
+ * evaluator, so that only a call is expanded in place. */
+_ST_COLD void st_eval_failed(const char* name, const char* expr, uint32_t line, int color,
+    bool fatal);
+
+/** Reports the failure of the comparison evaluator at `site` (as st_eval_failed), after
+ * printing the values of its operands, to which `lhs` and `rhs` point. */
+_ST_COLD void st_cmp_failed(const st_cmp_site* site, const void* lhs, const void* rhs);
+
+/** Records that the predicate of an ST_FOR_ALL (or ST_FOR_NONE) failed for `index`. */
+_ST_COLD void st_for_all_fail(st_for_all* all, size_t index);
+
+/** Reports the failure of the ST_FOR_ALL (or, if `expected` is false, ST_FOR_NONE) at
+ * `line` (as st_eval_failed), after printing the number of the `count` values of `index`
+ * for which `predicate` was not `expected`, and the first of them. */
+_ST_COLD void st_for_all_failed(const st_for_all* all, size_t count, const char* index,
+    const char* predicate, bool expected, uint32_t line);
+
+/** Initializes a benchmark (see ST_BENCHMARK). */
+st_benchmark st_benchmark_init(const char* name, uint64_t iterations);
+
+/** Called by ST_BENCHMARK each time a batch of iterations completes. Starts the
+ * next batch and returns true, or reports the result and returns false. */
+bool st_benchmark_next(st_benchmark* bench);
+
+/** Begins a streaming digest (see ST_DIGEST_BEGIN). */
+st_digest st_digest_begin(void);
+
+/** Adds `size` bytes at `data` to a digest. Only a partial stripe of input is ever
+ * buffered, so a digest may span any amount of data. */
+void st_digest_update(st_digest* digest, const void* data, size_t size);
+
+/** Returns the XXH3 (64-bit, seed 0) hash of the data added to a digest so far;
+ * identical to that computed by e.g. 'xxhsum -H3'. */
+uint64_t st_digest_xxh3(const st_digest* digest);
+
+/** Returns the CRC32C (Castagnoli) of the data added to a digest so far. */
+uint32_t st_digest_crc32c(const st_digest* digest);
+
+/** Compares a digest with `expected_hex`: 16 hex digits (an XXH3 hash) or 8 (a
+ * CRC32C). Prints the actual digest if they differ. */
+bool st_digest_equal(const st_digest* digest, const char* expected_hex);
+
+/** Checks a property (see ST_PROPERTY): runs `body` for up to `num_cases` cases of
+ * generated input, then shrinks the first failing case to a minimal counterexample
+ * and runs it once more, printing the values generated. */
+st_testres st_check_property(const char* name, st_test_fn body, size_t num_cases);
+
+/** Draws a choice in [0, `max`] for the current case of a property. All generators
+ * are built on it, so that their values shrink when the choices do. */
+uint64_t st_prop_draw(uint64_t max);
+
+/** Allocates `size` bytes that remain valid until the current case of a property
+ * ends. Returns NULL if the storage is exhausted. */
+void* st_prop_alloc(size_t size);
+
+/** Generators for properties: values in [`lo`, `hi`], shrinking toward zero (or the
+ * bound nearest to it). */
+int64_t st_gen_int(int64_t lo, int64_t hi);
+uint64_t st_gen_uint(uint64_t lo, uint64_t hi);
+double st_gen_double(double lo, double hi);
+bool st_gen_bool(void);
+
+/** Generates a NUL-terminated string of up to `max_len` characters from `alphabet`
+ * (printable ASCII if NULL), shrinking toward shorter strings of its first
+ * characters. */
+const char* st_gen_string(size_t max_len, const char* alphabet);
+
+/** Generates up to `max_len` arbitrary bytes, storing the length in `len`. */
+const uint8_t* st_gen_bytes(size_t* len, size_t max_len);
+
+/** Generates an array of up to `max_len` integers in [`lo`, `hi`], storing the
+ * number of elements in `len`. */
+int64_t* st_gen_int_array(size_t* len, size_t max_len, int64_t lo, int64_t hi);
+
+/** Returns true if output is currently suppressed (while checking a property). */
+bool st_output_muted(void);
+
+/** Returns true if the calling thread's test has printed as many evaluator failures as
+ * it may (see --max-failures); further failures are counted but not printed. */
+bool st_failures_suppressed(void);
+
+/** Seeds a pseudorandom number generator. */
+void st_rng_seed(st_rng* rng, uint64_t seed);
+
+/** Returns the next 64 pseudorandom bits from a generator. */
+uint64_t st_rng_next(st_rng* rng);
+
+/** Pins the calling thread to the specified CPU. */
+bool st_pin_thread_to_cpu(uint32_t cpu);
+
+/** Returns the CPU the calling thread is executing on, or -1 if unknown. */
+int st_get_current_cpu(void);
+
+/** Samples the frequency scaling state of the specified CPU. */
+bool st_get_cpu_freq(int cpu, st_cpu_freq* freq);
+
 /** Retrieves a formatted error message for the specified code. */
 char* st_format_error_msg(int code, char message[ST_MAX_ERROR_STR_LEN]);
 
 /** Puts the current thread to sleep for `msec` milliseconds. */
 void st_sleep_msec(uint32_t msec);
 
+/** Flushes the OS's buffers for `file` to disk. */
+bool st_sync_file(FILE* file);
+
 /** Returns the current working directory. */
 char* st_getcwd(void);
 
@@ -57,6 +57,174 @@
  * value: 500 MiB. */
 # define ST_MIN_FS_AVAIL (500 * 1024 * 1024)
 
+/** The number of slowest sections (see ST_SECTION) retained for each test and
+ * displayed in its outro. */
+# define ST_SECTION_TOP_N 5
+
+/** The maximum size, in characters, of the section label appended to evaluator
+ * failure messages (including the section's name). */
+# define ST_MAX_SECTION_LABEL_LEN 64
+
+/** The maximum number of warmup batches executed by ST_BENCHMARK before its
+ * measured run, unless timing stabilizes sooner. May be overridden with --warmup. */
+# define ST_BENCH_WARMUP_MAX 50
+
+/** ST_BENCHMARK warmup batches contain 1/n of the requested iterations. */
+# define ST_BENCH_WARMUP_DIVISOR 10
+
+/** The number of consecutive warmup batches whose timings must agree (within
+ * ST_BENCH_STABLE_PCT) for timing to be considered stable. */
+# define ST_BENCH_WARMUP_WINDOW 3
+
+/** The maximum spread, in percent, between the fastest and slowest of the last
+ * ST_BENCH_WARMUP_WINDOW warmup batches for timing to be considered stable. */
+# define ST_BENCH_STABLE_PCT 5.0
+
+/** The maximum change, in percent, of the CPU's frequency during a benchmark's
+ * measured run before its result is flagged as noisy. */
+# define ST_BENCH_FREQ_PCT 5.0
+
+/** The maximum size, in characters, of a CPU frequency governor's name. */
+# define ST_MAX_GOVERNOR_STR_LEN 32
+
+/** The maximum size, in characters, of a formatted duration (e.g. '12.345ms'). */
+# define ST_MAX_DURATION_STR_LEN 32
+
+/** The maximum number of times a test may be run by --repeat. */
+# define ST_MAX_REPEAT 10000000
+
+/** The number of times a test is run by --repeat-until-fail, unless --repeat is
+ * also specified. */
+# define ST_REPEAT_UNTIL_FAIL_MAX 100000
+
+/** The coefficient of variation (stddev / mean), in percent, of the durations of
+ * a repeated test above which its timing is considered unstable. */
+# define ST_REPEAT_UNSTABLE_PCT 25.0
+
+/** The standard deviation, in microseconds, of the durations of a repeated test at or
+ * below which its timing is never considered unstable (as it is mostly timer jitter,
+ * which dwarfs the durations of the shortest tests). */
+# define ST_REPEAT_UNSTABLE_MIN_USEC 50.0
+
+/** The maximum number of durations of a repeated test kept (a uniform sample of them,
+ * if it is run more times) to find their median. */
+# define ST_REPEAT_MAX_SAMPLES 4096
+
+/** The maximum number of times a failed test may be retried (see --retries). */
+# define ST_MAX_RETRIES 100
+
+/** The maximum size, in characters, of a line in a file read by seatest (e.g.
+ * a quarantine list). Longer lines are truncated. */
+# define ST_MAX_LINE_STR_LEN 1024
+
+/** The default time limit, in seconds, for a single run of a test that doesn't
+ * declare its own (see ST_DECLARE_TEST_LIST_ENTRY_EX). May be overridden with
+ * --timeout. 0 disables the default time limit. */
+# define ST_DEFAULT_TIMEOUT_SEC 300
+
+/** The maximum time limit, in seconds, that may be given to --timeout. */
+# define ST_MAX_TIMEOUT_SEC 86400
+
+/** The default number of failed evaluators printed by a test, after which further
+ * failures are counted (and summarized in its outro) but not printed. May be overridden
+ * with --max-failures. 0 disables the limit. */
+# define ST_DEFAULT_MAX_FAILURES 200
+
+/** The number of failing indices listed when ST_FOR_ALL or ST_FOR_NONE fails. */
+# define ST_MAX_FOR_ALL_INDICES 8
+
+/** The maximum number of stack frames dumped when a test times out. */
+# define ST_MAX_BACKTRACE_FRAMES 64
+
+/** How long the watchdog waits for a hung test's thread to record its backtrace, in
+ * milliseconds. */
+# define ST_BACKTRACE_WAIT_MSEC 1000
+
+/** The longest interval at which the parent checks whether an isolated test's child
+ * process has exited, in milliseconds. */
+# define ST_ISOLATE_POLL_MSEC 10U
+
+/** The maximum number of distinct tags (including suite names) used by tests. */
+# define ST_MAX_TAGS 256
+
+/** The maximum size, in characters, of a tag or suite name. */
+# define ST_MAX_TAG_STR_LEN 32
+
+/** The maximum number of operations (tags and operators) in a --tags expression. */
+# define ST_MAX_TAG_EXPR_OPS 64
+
+/** The maximum size, in characters, of a case of a parameterized test named by
+ * --only (e.g. '42' in 'parse/42'), or of a case's index formatted for output. */
+# define ST_MAX_CASE_STR_LEN 64
+
+/** The maximum size, in characters, of the path of a file in a corpus directory
+ * (see ST_CASES_DIR), and of its name. */
+# define ST_MAX_CASE_PATH_LEN 1024
+
+/** The directory containing the corpus of each fuzz target (see ST_FUZZ_TARGET), in
+ * a subdirectory with the target's name. Relative to the working directory. */
+# define ST_FUZZ_CORPUS_DIR "corpus"
+
+/** The minimum size, in bytes, of each thread's scratch arena (see
+ * st_scratch_alloc), which grows to the peak demand of any test. */
+# define ST_SCRATCH_MIN_SIZE (64 * 1024)
+
+/** The directory containing the snapshots (golden files) compared by
+ * ST_SNAPSHOT_EQUAL. Relative to the working directory. */
+# define ST_SNAPSHOT_DIR "snapshots"
+
+/** The maximum size, in characters, of the path of a snapshot. */
+# define ST_MAX_SNAPSHOT_PATH_LEN 1024
+
+/** The number of bytes in each row of the hex/text window printed around the first
+ * difference found by ST_SNAPSHOT_EQUAL and ST_FILE_EQUAL. */
+# define ST_DIFF_ROW_BYTES 16
+
+/** The number of rows in the window (the first difference is in the second). */
+# define ST_DIFF_ROWS 3
+
+/** The maximum size, in characters, of a value printed by an evaluator (e.g. a
+ * mismatched element of ST_SPAN_EQUAL). Longer values are truncated. */
+# define ST_MAX_VALUE_STR_LEN 64
+
+/** The number of cases checked by a property (see ST_PROPERTY) that doesn't
+ * specify how many. */
+# define ST_PROP_DEFAULT_CASES 100
+
+/** The maximum number of choices (bounded integers, from which all generated
+ * values are derived) drawn by a single case of a property. Further draws yield 0. */
+# define ST_PROP_MAX_CHOICES 4096
+
+/** The size, in bytes, of the storage for strings, buffers, and arrays generated by
+ * a single case of a property. Generation beyond it yields shorter values. */
+# define ST_PROP_ARENA_SIZE (256 * 1024)
+
+/** The maximum number of times a property's failing case is replayed while
+ * shrinking it to a minimal counterexample. */
+# define ST_PROP_MAX_SHRINKS 10000
+
+/** The maximum number of elements (or characters) of a generated value printed
+ * with a counterexample. */
+# define ST_PROP_MAX_PRINTED 32
+
+/** The name of the journal of completed tests written during each run (see --resume
+ * and --rerun-failed), unless --journal or --no-journal is given. '%s' is replaced with
+ * the app name. */
+# define ST_JOURNAL_FILE ".%s.journal"
+
+/** The maximum size, in characters, of the journal's path. */
+# define ST_MAX_JOURNAL_PATH_LEN 256
+
+/** The journal is synced to disk after every n records (and when the run ends).
+ * Records are always flushed to the OS, so only a machine crash loses up to n. */
+# define ST_JOURNAL_SYNC_BATCH 8
+
+/** The first line of a journal; changes if the record format changes. */
+# define ST_JOURNAL_MAGIC "seatest-journal 1"
+
+/** The last line of the journal of a run that completed. */
+# define ST_JOURNAL_END "end"
+
 /** The TLD to use as the target when testing for an Internet connection. */
 # define ST_INET_TARGET_HOST "example.com"
 
@@ -94,11 +262,143 @@
 #  define ST_LOC_MSEC_ZERO    "<1"
 # endif
 # define ST_LOC_SEC_ABV       "s"
+# define ST_LOC_USEC_ABV      "us"
+# define ST_LOC_NSEC_ABV      "ns"
+# define ST_LOC_SECTION       "section"
+# define ST_LOC_SLOWEST_SECT  "slowest sections"
+# define ST_LOC_BENCHMARK     "benchmark"
+# define ST_LOC_ITERATIONS    "iterations"
+# define ST_LOC_PER_ITER      "iter"
+# define ST_LOC_CPU           "cpu"
+# define ST_LOC_MHZ           "MHz"
+# define ST_LOC_GOVERNOR      "governor"
+# define ST_LOC_NOISY         "NOISY"
+# define ST_LOC_NOISY_BENCH   "noisy benchmark"
+# define ST_LOC_SUPPRESSED    "%zu more %s suppressed (see %s)"
+# define ST_LOC_FAILURE       "failure"
+# define ST_LOC_NOISY_UNSTBL  "timing did not stabilize during warmup"
+# define ST_LOC_NOISY_FREQ    "CPU frequency changed"
+# define ST_LOC_NOISY_THRTL   "CPU was throttled"
+# define ST_LOC_NOISY_MIGRTD  "thread migrated to another CPU"
+# define ST_LOC_RUNS          "runs"
+# define ST_LOC_WARNED        "warned"
+# define ST_LOC_MIN           "min"
+# define ST_LOC_MEDIAN        "median"
+# define ST_LOC_MAX           "max"
+# define ST_LOC_STDDEV        "stddev"
+# define ST_LOC_UNSTABLE      "UNSTABLE"
+# define ST_LOC_UNSTABLE_T    "Unstable"
+# define ST_LOC_RETRYING      "retrying"
+# define ST_LOC_ATTEMPT       "attempt"
+# define ST_LOC_PASSED_ON     "passed on"
+# define ST_LOC_FLAKY_T       "Flaky"
+# define ST_LOC_QUARANTINED   "QUARANTINED"
+# define ST_LOC_QUARANTINED_T "Quarantined failed"
+# define ST_LOC_UNK_FILE_TEST "'%s' names unknown test '%s'"
+# define ST_LOC_TESTS_BY_SUITE "Available tests, by suite"
+# define ST_LOC_TESTS_BY_TAG  "Available tests, by tag"
+# define ST_LOC_UNGROUPED     "(none)"
+# define ST_LOC_UNK_TAG       "no test has the tag '%.*s'"
+# define ST_LOC_INVAL_TAGS    "invalid --tags expression '%s' (at '%s')"
+# define ST_LOC_TAG_TOO_LONG  "tags and suite names may only be %d characters" \
+                              " in length"
+# define ST_LOC_TOO_MANY_TAGS "tests may only use %d distinct tags and suites"
+# define ST_LOC_FIXTURES      "fixtures"
+# define ST_LOC_FIXT_CREATED  "constructed fixture '%s' in %s"
+# define ST_LOC_FIXT_DESTROYED "destroyed fixture '%s' in %s"
+# define ST_LOC_FIXT_FAILED   "failed to construct fixture '%s'"
+# define ST_LOC_CASE          "case"
+# define ST_LOC_CASE_FAILED   "case '%s/%s' failed"
+# define ST_LOC_CASES_ERR     "unable to read the cases of '%s' from '%s'"
+# define ST_LOC_NO_CASE       "'%s' has no case '%s'"
+# define ST_LOC_CASE_CONFLICT "only one case of '%s' may be selected ('%s' and '%s')"
+# define ST_LOC_CRASHED       "crashed (signal %d: %s)"
+# define ST_LOC_GIVEN         "given"
+# define ST_LOC_PROP_PASSED   "%zu %s passed (seed %"PRIu64")"
+# define ST_LOC_PROP_FAILED   "falsified by case %zu of %zu; shrunk in %zu %s to the" \
+                              " counterexample above"
+# define ST_LOC_STEP          "step"
+# define ST_LOC_PROP_REPRO    "reproduce with: %s %"PRIu64" %s %s"
+# define ST_LOC_PROP_FLAKY    "the counterexample did not fail when replayed" \
+                              " (is the property deterministic?)"
+# define ST_LOC_PROP_NOMEM    "unable to allocate storage for property '%s'"
+# define ST_LOC_SNAPSHOT      "snapshot"
+# define ST_LOC_ACTUAL        "actual"
+# define ST_LOC_EXPECTED      "expected"
+# define ST_LOC_ALL_FILLED    "all %zu %s are 0x%02x"
+# define ST_LOC_EMPTY_PATTERN "the pattern is empty"
+# define ST_LOC_CHAR_NOT_IN_SET "character %zu (%s) is not in the set"
+# define ST_LOC_INVALID_UTF8  "invalid UTF-8 sequence at offset %zu (%s)"
+# define ST_LOC_NEEDLE        "needle"
+# define ST_LOC_HAYSTACK      "haystack"
+# define ST_LOC_BUFS_EQUAL    "both are the same %zu %s"
+# define ST_LOC_NEEDLE_MISSING "the needle (%zu %s) is not in the haystack (%zu %s)"
+# define ST_LOC_NEEDLE_FOUND  "the needle (%zu %s) is at offset %zu (0x%zx)"
+# define ST_LOC_NEEDLE_LONGER "the needle (%zu %s) is longer than the haystack (%zu %s)"
+# define ST_LOC_NULL_BUF      "the %s is NULL, but its length is %zu"
+# define ST_LOC_RE_NO_MATCH   "\"%.*s\"%s does not match /%s/"
+# define ST_LOC_RE_MATCHED    "/%s/ matches \"%.*s\"%s at offset %zu"
+# define ST_LOC_NOT_NEAR      "%.*g and %.*g differ by %g (%s)"
+# define ST_LOC_NOT_NEAR_SUM  "%zu of %zu %s differ; the worst is element %s: %.*g vs %.*g" \
+                              " (difference %g, %s)"
+# define ST_LOC_ELEMENT       "element"
+# define ST_LOC_ULP           "ULP"
+# define ST_LOC_NOT_COMPARABLE "not comparable"
+# define ST_LOC_FOR_ALL       "'%s' is %s for %zu of %zu (%s = %s%s)"
+# define ST_LOC_TRUE          "true"
+# define ST_LOC_OPERAND       "%s is %s"
+# define ST_LOC_OPERANDS      ST_LOC_OPERAND ", and " ST_LOC_OPERAND
+# define ST_LOC_FALSE         "false"
+# define ST_LOC_FIRST_DIFF    "first difference at offset %zu (0x%zx); -%s: %zu bytes," \
+                              " +%s: %zu bytes"
+# define ST_LOC_SNAP_MISSING  "snapshot '%s' does not exist; create it with %s"
+# define ST_LOC_SNAP_UPDATED  "updated snapshot '%s' (%zu bytes)"
+# define ST_LOC_SNAP_PATH     "the path of snapshot '%s' is too long"
+# define ST_LOC_BYTE          "byte"
+# define ST_LOC_DIGEST_INVAL  "'%s' is not a digest (16 hex digits for XXH3, or 8 for" \
+                              " CRC32C)"
+# define ST_LOC_DIGEST_ACTUAL "digest of %"PRIu64" %s: xxh3 %016"PRIx64", crc32c %08"PRIx32
+# define ST_LOC_DUPLICATES    "elements %zu and %zu are equal"
+# define ST_LOC_OUT_OF_ORDER  "elements %zu and %zu are out of order"
+# define ST_LOC_COUNTS_DIFFER "the arrays have %zu and %zu elements"
+# define ST_LOC_NO_COUNTERPART "element %zu of the %s array has no counterpart in the %s"
+# define ST_LOC_FIRST         "first"
+# define ST_LOC_SECOND        "second"
+# define ST_LOC_SCRATCH_NOMEM "unable to allocate %zu bytes of scratch memory"
+# define ST_LOC_ELEM_DIFFERS  "element %zu differs: %s != %s"
+# define ST_LOC_ELEM_FOUND    "element %zu is equal to %s"
+# define ST_LOC_ELEM_MISSING  "none of the %zu elements is equal to %s"
+# define ST_LOC_SETUP_FAILED  "setup failed; the test was not run"
+# define ST_LOC_DUP_NAME      "is invalid (another test has the same name)"
+# define ST_LOC_NO_MATCH      "no tests match the specified filters"
+# define ST_LOC_INVAL_REGEX   "invalid regular expression '%s': %s"
+# define ST_LOC_NO_REGEX      "regular expressions are not supported on this" \
+                              " platform ('%s')"
+# define ST_LOC_TIMED_OUT     "'%s' did not finish within %"PRIu32 ST_LOC_SEC_ABV";" \
+                              " backtrace of the test thread:"
+# define ST_LOC_TIMED_OUT_T   "Timed out"
+# define ST_LOC_TIMEOUT_EXIT  "'%s' did not finish within %"PRIu32 ST_LOC_SEC_ABV"; exiting" \
+                              " with code %d"
+# define ST_LOC_NO_BACKTRACE  "(backtraces are not available on this platform)"
+# define ST_LOC_NO_FRAMES     "(the test thread did not record one)"
+# define ST_LOC_NO_WATCHDOG   "failed to start the watchdog thread; tests will" \
+                              " not time out"
+# define ST_LOC_RESUMED       "resumed"
+# define ST_LOC_RESUMING      "resuming: %zu %s completed by the previous run" \
+                              " will not be run again"
+# define ST_LOC_RUN_COMPLETE  "the previous run completed; running all tests"
+# define ST_LOC_NO_FAILED     "the previous run had no failed tests; nothing to do"
+# define ST_LOC_NO_JOURNAL    "no usable journal from a previous run ('%s')"
+# define ST_LOC_JOURNAL_ERR   "failed to write journal '%s'; %s and %s will" \
+                              " not be available"
+# define ST_LOC_PIN_FAILED    "failed to pin thread to CPU %u; benchmark results" \
+                              " may be noisy"
 # define ST_LOC_USAGE         "Usage"
 # define ST_LOC_AVAIL_TESTS   "Available tests"
 # define ST_LOC_UNK_OPT       "unknown option"
 # define ST_LOC_VAL_EXPECT    "value expected for"
 # define ST_LOC_INVAL_ARG     "invalid argument to"
+# define ST_LOC_FLAG_CONFLICT "%s cannot be combined with %s"
 # define ST_LOC_PRESS_KEY     "Press any key to continue..."
 # define ST_LOC_EXPRESSION    "expression"
 # define ST_LOC_IS_FALSE      "is false"
@@ -107,6 +407,8 @@
 # define ST_LOC_SKIPPED_UNMET "skipped due to unmet %s"
 # define ST_LOC_INVAL_ANAME   "the app_name parameter to ST_MAIN_IMPL is" \
                               " invalid (may not be null or an empty string)"
+# define ST_LOC_NO_TESTS      "there are no tests to run (declare a list of tests," \
+                              " or use ST_TEST)"
 # define ST_LOC_NO_SPACES     "is invalid (names may not contain spaces)"
 # define ST_LOC_TOO_LONG      "is invalid (names may only be %d characters" \
                               " in length; counted %zu)"
@@ -123,37 +425,115 @@
 # define ST_LOC_PASS          "PASS"
 # define ST_LOC_WARN          "WARN"
 # define ST_LOC_FAIL          "FAIL"
+# define ST_LOC_FLAKY         "FLAKY"
+# define ST_LOC_TIMEOUT       "TIMEOUT"
 # define ST_LOC_INDENT        "  "
 
 # define ST_LOC_WAIT_FLAG     "--wait"
 # define ST_LOC_WAIT_FLAG_S   "-w"
 # define ST_LOC_ONLY_FLAG     "--only"
 # define ST_LOC_ONLY_FLAG_S   "-o"
+# define ST_LOC_FLTR_FLAG     "--filter"
+# define ST_LOC_FLTR_FLAG_S   "-g"
 # define ST_LOC_LIST_FLAG     "--list"
 # define ST_LOC_LIST_FLAG_S   "-l"
+# define ST_LOC_LIST_SUITES   "suites"
+# define ST_LOC_LIST_TAGS     "tags"
+# define ST_LOC_TAGS_FLAG     "--tags"
+# define ST_LOC_TAGS_FLAG_S   "-T"
 # define ST_LOC_FAIL_FLAG     "--fail-early"
 # define ST_LOC_FAIL_FLAG_S   "-f"
 # define ST_LOC_VERS_FLAG     "--version"
 # define ST_LOC_VERS_FLAG_S   "-v"
 # define ST_LOC_HELP_FLAG     "--help"
 # define ST_LOC_HELP_FLAG_S   "-h"
+# define ST_LOC_PIN_FLAG      "--pin-cpu"
+# define ST_LOC_PIN_FLAG_S    "-p"
+# define ST_LOC_WARM_FLAG     "--warmup"
+# define ST_LOC_WARM_FLAG_S   "-W"
+# define ST_LOC_RPT_FLAG      "--repeat"
+# define ST_LOC_RPT_FLAG_S    "-r"
+# define ST_LOC_RUF_FLAG      "--repeat-until-fail"
+# define ST_LOC_RUF_FLAG_S    "-u"
+# define ST_LOC_RTRY_FLAG     "--retries"
+# define ST_LOC_RTRY_FLAG_S   "-R"
+# define ST_LOC_QUAR_FLAG     "--quarantine"
+# define ST_LOC_QUAR_FLAG_S   "-q"
+# define ST_LOC_TMO_FLAG      "--timeout"
+# define ST_LOC_TMO_FLAG_S    "-t"
+# define ST_LOC_RRF_FLAG      "--rerun-failed"
+# define ST_LOC_RRF_FLAG_S    "-F"
+# define ST_LOC_RSM_FLAG      "--resume"
+# define ST_LOC_RSM_FLAG_S    "-c"
+# define ST_LOC_JRNL_FLAG     "--journal"
+# define ST_LOC_JRNL_FLAG_S   "-j"
+# define ST_LOC_NOJ_FLAG      "--no-journal"
+# define ST_LOC_NOJ_FLAG_S    "-J"
+# define ST_LOC_SEED_FLAG     "--seed"
+# define ST_LOC_SEED_FLAG_S   "-S"
+# define ST_LOC_UPD_FLAG      "--update-snapshots"
+# define ST_LOC_UPD_FLAG_S    "-U"
+# define ST_LOC_MAXF_FLAG     "--max-failures"
+# define ST_LOC_MAXF_FLAG_S   "-m"
 
-# define ST_LOC_ONLY_USAGE    ULINE("name") " [, " ULINE("name") ", ...]"
+# define ST_LOC_ONLY_USAGE    ULINE("name") "|@" ULINE("file") " [, ...]"
+# define ST_LOC_LIST_USAGE    "[" ST_LOC_LIST_SUITES "|" ST_LOC_LIST_TAGS "]"
+# define ST_LOC_TAGS_USAGE    ULINE("expression")
+# define ST_LOC_FLTR_USAGE    "[!]" ULINE("glob") "|[!]/" ULINE("regex") "/ [, ...]"
+# define ST_LOC_PIN_USAGE     ULINE("cpu")
+# define ST_LOC_WARM_USAGE    ULINE("batches")
+# define ST_LOC_RPT_USAGE     ULINE("count")
+# define ST_LOC_FILE_USAGE    ULINE("file")
+# define ST_LOC_SEC_USAGE     ULINE("seconds")
+# define ST_LOC_SEED_USAGE    ULINE("seed")
 
 # define ST_LOC_WAIT_DESC     "Wait for a key press before exiting"
 # define ST_LOC_ONLY_DESC     "Run only the test(s) specified"
-# define ST_LOC_LIST_DESC     "Print a list of all available tests"
+# define ST_LOC_FLTR_DESC     "Run only the tests whose names match (or, with '!', don't match)"
+# define ST_LOC_LIST_DESC     "Print a list of all available tests (optionally grouped)"
+# define ST_LOC_TAGS_DESC     "Run only the tests whose tags match, e.g. 'fast & !network'"
 # define ST_LOC_FAIL_DESC     "Exit immediately upon failure of any test"
 # define ST_LOC_VERS_DESC     "Display version information"
 # define ST_LOC_HELP_DESC     "Display this message"
+# define ST_LOC_PIN_DESC      "Pin the test thread to the specified CPU (for benchmarks)"
+# define ST_LOC_RPT_DESC      "Run each test the specified number of times, gathering statistics"
+# define ST_LOC_RUF_DESC      "Stop repeating a test once it fails"
+# define ST_LOC_RTRY_DESC     "Retry a failed test up to the specified number of times"
+# define ST_LOC_QUAR_DESC     "Tests listed in the file don't affect the exit code"
+# define ST_LOC_TMO_DESC      "Time limit for each test that doesn't declare one (0 disables)"
+# define ST_LOC_RRF_DESC      "Run only the tests that failed in the previous run"
+# define ST_LOC_RSM_DESC      "Continue an interrupted run, skipping completed tests"
+# define ST_LOC_JRNL_DESC     "Path of the journal written by each run (default: ." \
+                              "<app name>.journal)"
+# define ST_LOC_NOJ_DESC      "Don't write a journal of the run"
+# define ST_LOC_SEED_DESC     "Seed for generating the cases of properties (default: random)"
+# define ST_LOC_UPD_DESC      "Rewrite the snapshots that are missing or differ (see ST_SNAPSHOT_EQUAL)"
+# define ST_LOC_WARM_DESC     "Maximum number of benchmark warmup batches (0 disables warmup)"
+# define ST_LOC_MAXF_DESC     "Maximum number of failures printed by each test (0 disables)"
 
 /** Command line configuration (flag, usage, description). If entries are changed,
  * st_parse_cmd_line and st_print_usage_info must be modified as well. */
 # define ST_CL_CONFIG() \
     {ST_LOC_WAIT_FLAG_S, ST_LOC_WAIT_FLAG, "",                ST_LOC_WAIT_DESC}, \
     {ST_LOC_ONLY_FLAG_S, ST_LOC_ONLY_FLAG, ST_LOC_ONLY_USAGE, ST_LOC_ONLY_DESC}, \
-    {ST_LOC_LIST_FLAG_S, ST_LOC_LIST_FLAG, "",                ST_LOC_LIST_DESC}, \
+    {ST_LOC_FLTR_FLAG_S, ST_LOC_FLTR_FLAG, ST_LOC_FLTR_USAGE, ST_LOC_FLTR_DESC}, \
+    {ST_LOC_TAGS_FLAG_S, ST_LOC_TAGS_FLAG, ST_LOC_TAGS_USAGE, ST_LOC_TAGS_DESC}, \
+    {ST_LOC_LIST_FLAG_S, ST_LOC_LIST_FLAG, ST_LOC_LIST_USAGE, ST_LOC_LIST_DESC}, \
     {ST_LOC_FAIL_FLAG_S, ST_LOC_FAIL_FLAG, "",                ST_LOC_FAIL_DESC}, \
+    {ST_LOC_PIN_FLAG_S,  ST_LOC_PIN_FLAG,  ST_LOC_PIN_USAGE,  ST_LOC_PIN_DESC}, \
+    {ST_LOC_WARM_FLAG_S, ST_LOC_WARM_FLAG, ST_LOC_WARM_USAGE, ST_LOC_WARM_DESC}, \
+    {ST_LOC_RPT_FLAG_S,  ST_LOC_RPT_FLAG,  ST_LOC_RPT_USAGE,  ST_LOC_RPT_DESC}, \
+    {ST_LOC_RUF_FLAG_S,  ST_LOC_RUF_FLAG,  "",                ST_LOC_RUF_DESC}, \
+    {ST_LOC_RTRY_FLAG_S, ST_LOC_RTRY_FLAG, ST_LOC_RPT_USAGE,  ST_LOC_RTRY_DESC}, \
+    {ST_LOC_QUAR_FLAG_S, ST_LOC_QUAR_FLAG, ST_LOC_FILE_USAGE, ST_LOC_QUAR_DESC}, \
+    {ST_LOC_TMO_FLAG_S,  ST_LOC_TMO_FLAG,  ST_LOC_SEC_USAGE,  ST_LOC_TMO_DESC}, \
+    {ST_LOC_MAXF_FLAG_S, ST_LOC_MAXF_FLAG, ST_LOC_RPT_USAGE,  ST_LOC_MAXF_DESC}, \
+    {ST_LOC_RRF_FLAG_S,  ST_LOC_RRF_FLAG,  "",                ST_LOC_RRF_DESC}, \
+    {ST_LOC_RSM_FLAG_S,  ST_LOC_RSM_FLAG,  "",                ST_LOC_RSM_DESC}, \
+    {ST_LOC_JRNL_FLAG_S, ST_LOC_JRNL_FLAG, ST_LOC_FILE_USAGE, ST_LOC_JRNL_DESC}, \
+    {ST_LOC_NOJ_FLAG_S,  ST_LOC_NOJ_FLAG,  "",                ST_LOC_NOJ_DESC}, \
+    {ST_LOC_SEED_FLAG_S, ST_LOC_SEED_FLAG, ST_LOC_SEED_USAGE, ST_LOC_SEED_DESC}, \
+    {ST_LOC_UPD_FLAG_S,  ST_LOC_UPD_FLAG,  "",                ST_LOC_UPD_DESC}, \
     {ST_LOC_VERS_FLAG_S, ST_LOC_VERS_FLAG, "",                ST_LOC_VERS_DESC}, \
     {ST_LOC_HELP_FLAG_S, ST_LOC_HELP_FLAG, "",                ST_LOC_HELP_DESC}
 
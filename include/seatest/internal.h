@@ -33,11 +33,31 @@
  * Types
  */
 
-/** Global state container. */
+/** Watchdog that interrupts a test which exceeds its time limit. */
 typedef struct {
-    const char* app_name;
-    bool fail_early;
-} st_state;
+# if !defined(__WIN__)
+    pthread_t thread;        /**< The watchdog thread. */
+    pthread_t target;        /**< The thread running the tests. */
+    pthread_mutex_t lock;    /**< Guards the fields below. */
+    pthread_cond_t cond;     /**< Signaled when the watchdog is (dis)armed or stopped. */
+    struct sigaction prev_action;  /**< The action for ST_TIMEOUT_SIGNAL before ours. */
+    volatile sig_atomic_t captured; /**< Set by the signal handler once it has run. */
+#  if defined(__HAVE_BACKTRACE__)
+    void* frames[ST_MAX_BACKTRACE_FRAMES]; /**< The hung thread's frames, once `captured`. */
+    volatile sig_atomic_t num_frames;      /**< The number of `frames`. */
+#  endif
+# else /* __WIN__ */
+    HANDLE thread;           /**< The watchdog thread. */
+    CRITICAL_SECTION lock;   /**< Guards the fields below. */
+    CONDITION_VARIABLE cond; /**< Signaled when the watchdog is (dis)armed or stopped. */
+# endif
+    const char* name;       /**< The name of the test being timed, or NULL if disarmed. */
+    uint32_t timeout;        /**< The time limit of the test being timed, in seconds. */
+    uint64_t deadline;       /**< When the test being timed times out (see st_clock_nsec). */
+    bool fired;              /**< true if the test being timed has timed out. */
+    bool running;            /**< true if the watchdog thread was started. */
+    bool quit;               /**< true if the watchdog thread should exit. */
+} st_watchdog;
 
 /** Data associated with a test. */
 typedef struct {
@@ -50,6 +70,194 @@ typedef struct {
     bool fatal;     /**< true if the test encountered error(s). */
 } st_testres;
 
+/** A timed section of a test (see ST_SECTION). Lives on the stack of the test
+ * function for as long as the section's scope is active. */
+typedef struct st_section {
+    const char* name;          /**< The section's human-readable name. */
+    struct st_section* parent; /**< The enclosing section, if nested. */
+    uint64_t started;          /**< Value of st_clock_nsec() upon entry. */
+    int errors;                /**< The number of fatal evaluator failures within. */
+    int warnings;              /**< The number of non-fatal evaluator failures within. */
+} st_section;
+
+/** The outcome of a section that has been exited; retained for the test outro. */
+typedef struct {
+    const char* name;   /**< The section's human-readable name. */
+    const char* parent; /**< The enclosing section's name, or NULL. */
+    uint64_t nsec;      /**< The time spent within the section, in nanoseconds. */
+    int errors;         /**< The number of fatal evaluator failures within. */
+    int warnings;       /**< The number of non-fatal evaluator failures within. */
+} st_section_rec;
+
+/** A case of a parameterized test (see ST_TEST_P). */
+typedef struct {
+    size_t index;      /**< The case's zero-based index. */
+    const char* label; /**< The case's label, or NULL to use its index. */
+    const void* data;  /**< The case's data (not necessarily NUL-terminated). */
+    size_t size;       /**< The size of `data`, in bytes. */
+} st_case;
+
+/** A fast, seedable pseudorandom number generator (xoshiro256**). */
+typedef struct {
+    uint64_t s[4];
+} st_rng;
+
+/** The state of the property being checked (see ST_PROPERTY). Every generated value
+ * is derived from "choices" (bounded integers) drawn by the generators. The choices of
+ * a failing case are shrunk and replayed to find a minimal counterexample. */
+typedef struct {
+    st_rng rng;            /**< The source of choices, unless replaying. */
+    uint64_t* choices;     /**< The choices drawn (or to replay) by the current case. */
+    size_t num_choices;    /**< Entries in `choices` that are valid. */
+    size_t pos;            /**< The index of the next choice to draw. */
+    uint64_t* best;        /**< The choices of the simplest failing case so far. */
+    size_t num_best;       /**< Entries in `best` that are valid. */
+    unsigned char* arena;  /**< Storage for generated strings, buffers, and arrays. */
+    size_t arena_used;     /**< Bytes of `arena` used by the current case. */
+    bool replay;           /**< true if choices are replayed rather than random. */
+    bool verbose;          /**< true if generated values are printed. */
+} st_prop;
+
+/** Memory allocated by st_scratch_alloc beyond the end of a scratch arena. */
+typedef struct st_scratch_chunk {
+    struct st_scratch_chunk* next;
+    max_align_t data[];
+} st_scratch_chunk;
+
+/** Scratch memory for evaluators (and tests), valid until the test ends. Demand
+ * beyond `size` is met by separate allocations, after which the arena grows to the
+ * peak demand, so that it is reused by later tests without allocating. */
+typedef struct {
+    unsigned char* base;        /**< The arena. */
+    size_t size;                /**< The size of `base`, in bytes. */
+    size_t used;                /**< Bytes of `base` used by the current test. */
+    size_t peak;                /**< Peak demand during the current test. */
+    st_scratch_chunk* overflow; /**< Allocations that did not fit in `base`. */
+} st_scratch;
+
+/** A slot in an st_elem_table. */
+typedef struct {
+    size_t index; /**< Index into the array of the element, plus one; zero if empty. */
+    size_t count; /**< Occurrences of the element, or other per-element state. */
+} st_elem_slot;
+
+/** A hash table of the (distinct) elements of an array, compared bitwise (or, if of
+ * kind ST_VALUE_REAL, by value). */
+typedef struct {
+    const unsigned char* elems; /**< The array. */
+    size_t elem_size;           /**< The size of each element, in bytes. */
+    int kind;                   /**< One of the ST_VALUE_ values. */
+    st_elem_slot* slots;        /**< The slots (a power of two of them). */
+    size_t mask;                /**< The number of slots, minus one. */
+} st_elem_table;
+
+/** Per-thread state container. */
+typedef struct {
+    st_section* section;                         /**< The innermost active section. */
+    st_section_rec sections[ST_SECTION_TOP_N];   /**< The slowest exited sections. */
+    size_t num_sections;                         /**< Entries used in `sections`. */
+    char section_label[ST_MAX_SECTION_LABEL_LEN]; /**< Scratch for failure labels. */
+    int noisy_benchmarks;                        /**< Benchmarks flagged as noisy. */
+    const st_case* current_case;                 /**< The case being run, if any. */
+    st_prop prop;                                /**< The property being checked. */
+    bool in_property;                            /**< true while checking a property. */
+    bool muted;                                  /**< true if output is suppressed. */
+    size_t failures;                             /**< Failures printed by the test. */
+    size_t suppressed;                           /**< Failures not printed by the test. */
+    st_scratch scratch;                          /**< Scratch memory for the test. */
+# if !defined(__WIN__)
+    sigjmp_buf* volatile timeout_jmp;            /**< Where to resume after a timeout. */
+# endif
+} st_thread_state;
+
+/** A snapshot of a CPU's frequency scaling state. */
+typedef struct {
+    int cpu;                 /**< The CPU that was sampled, or -1 if unknown. */
+    uint64_t khz;            /**< The current frequency in kHz, or 0 if unknown. */
+    uint64_t throttle_count; /**< The number of thermal throttling events so far. */
+    bool have_throttle;      /**< true if `throttle_count` is valid. */
+    char governor[ST_MAX_GOVERNOR_STR_LEN]; /**< The frequency governor, if known. */
+} st_cpu_freq;
+
+/** Reasons for which the result of a benchmark may be flagged as noisy. */
+enum {
+    ST_NOISY_UNSTABLE = 1 << 0, /**< Timing did not stabilize during warmup. */
+    ST_NOISY_FREQ     = 1 << 1, /**< The CPU's frequency changed. */
+    ST_NOISY_THROTTLE = 1 << 2, /**< The CPU was thermally throttled. */
+    ST_NOISY_MIGRATED = 1 << 3, /**< The thread migrated to another CPU. */
+};
+
+/** A benchmark (see ST_BENCHMARK). Lives on the stack of the test function. */
+typedef struct {
+    const char* name;       /**< The benchmark's human-readable name. */
+    uint64_t iterations;    /**< The number of measured iterations. */
+    uint64_t remaining;     /**< Iterations remaining in the current batch. */
+    uint64_t batch;         /**< The size of the current batch. */
+    uint64_t started;       /**< Value of st_clock_nsec() when the batch began. */
+    uint64_t window[ST_BENCH_WARMUP_WINDOW]; /**< Most recent warmup batch times. */
+    uint32_t warmups;       /**< The number of warmup batches executed. */
+    int noisy;              /**< Bitmask of ST_NOISY_* reasons. */
+    bool measuring;         /**< true once the measured batch has begun. */
+    st_cpu_freq before;     /**< CPU state prior to the measured batch. */
+} st_benchmark;
+
+/** XXH3 parameters (see https://github.com/Cyan4973/xxHash). */
+# define _ST_XXH_PRIME32_1 UINT64_C(0x9E3779B1)
+# define _ST_XXH_PRIME32_2 UINT64_C(0x85EBCA77)
+# define _ST_XXH_PRIME32_3 UINT64_C(0xC2B2AE3D)
+# define _ST_XXH_PRIME64_1 UINT64_C(0x9E3779B185EBCA87)
+# define _ST_XXH_PRIME64_2 UINT64_C(0xC2B2AE3D27D4EB4F)
+# define _ST_XXH_PRIME64_3 UINT64_C(0x165667B19E3779F9)
+# define _ST_XXH_PRIME64_4 UINT64_C(0x85EBCA77C2B2AE63)
+# define _ST_XXH_PRIME64_5 UINT64_C(0x27D4EB2F165667C5)
+# define _ST_XXH_STRIPE_LEN 64
+# define _ST_XXH_SECRET_SIZE 192
+# define _ST_XXH_SECRET_SIZE_MIN 136
+# define _ST_XXH_SECRET_CONSUME_RATE 8
+# define _ST_XXH_SECRET_MERGEACCS_START 11
+# define _ST_XXH_SECRET_LASTACC_START 7
+# define _ST_XXH_MID_SIZE_MAX 240
+
+/** CRC32C (Castagnoli) parameters: the reflected polynomial, and the lengths of the
+ * blocks whose CRCs are computed in parallel by the hardware implementation. */
+# define _ST_CRC32C_POLY UINT32_C(0x82F63B78)
+# define _ST_CRC32C_LONG 8192
+# define _ST_CRC32C_SHORT 256
+
+/** The size, in bytes, of the input buffered by a digest between updates. Must be a
+ * multiple of the XXH3 stripe (64 bytes) larger than 240 bytes. */
+# define _ST_DIGEST_BUFFER_SIZE 256
+
+/** A streaming fingerprint (XXH3-64 and CRC32C) of a test's output (see
+ * ST_DIGEST_BEGIN). Lives on the stack of the test function. */
+typedef struct {
+    uint64_t acc[8];        /**< XXH3 accumulators. */
+    uint8_t buffer[_ST_DIGEST_BUFFER_SIZE]; /**< Input not yet accumulated. */
+    size_t buffered;        /**< The number of bytes in `buffer`. */
+    size_t stripes;         /**< Stripes accumulated in the current XXH3 block. */
+    uint64_t total;         /**< The number of bytes digested. */
+    uint32_t crc;           /**< The CRC32C register (not yet inverted). */
+} st_digest;
+
+/** Kinds of st_value, and of the elements of spans (see _ST_VALUE_KIND). */
+enum {
+    ST_VALUE_BYTES = 0, /**< Anything else; compared bitwise and printed in hex. */
+    ST_VALUE_SIGNED,    /**< A signed integer. */
+    ST_VALUE_UNSIGNED,  /**< An unsigned integer (or bool). */
+    ST_VALUE_REAL,      /**< A floating-point number. */
+    ST_VALUE_POINTER    /**< A pointer (to an object). */
+};
+
+/** An operand of an evaluator, captured along with its kind (see _ST_VALUE). Not a
+ * union, as the ABI of passing one containing a long double differs between compiler
+ * versions. */
+typedef struct {
+    int kind;      /**< One of the ST_VALUE_ values. */
+    int64_t i;     /**< ST_VALUE_SIGNED. */
+    uint64_t u;    /**< ST_VALUE_UNSIGNED, and ST_VALUE_POINTER (the address). */
+    long double f; /**< ST_VALUE_REAL. */
+} st_value;
+
 /** Function typedef for test routines. */
 typedef st_testres (*st_test_fn)(void);
 
@@ -64,6 +272,114 @@ enum {
     COND_CPUS = 1 << 3, /**< At least n logical CPUs available. */
 }; // TODO: Think of more conditions
 
+/** Statistics gathered when a test is run repeatedly (see --repeat). */
+typedef struct {
+    uint32_t runs;   /**< The number of times the test was run. */
+    uint32_t passed; /**< The number of runs without errors or warnings. */
+    uint32_t warned; /**< The number of runs with warnings, but no errors. */
+    uint32_t failed; /**< The number of runs with errors. */
+    double min;      /**< The shortest run, in milliseconds. */
+    double median;   /**< The median run, in milliseconds. */
+    double max;      /**< The longest run, in milliseconds. */
+    double stddev;   /**< The standard deviation of the runs, in milliseconds. */
+    bool unstable;   /**< true if the outcome or timing varied between runs. */
+} st_repeat_stats;
+
+/** A per-test setup or teardown routine. Setup routines return false on failure,
+ * in which case the test fails without running. */
+typedef bool (*st_hook_fn)(void);
+
+/** A suite-level fixture (see ST_DEFINE_FIXTURE). */
+typedef struct {
+    const char* name;            /**< The fixture's name. */
+    void* (*create)(void);       /**< Constructs the shared data (NULL on failure). */
+    void (*destroy)(void* data); /**< Destroys the shared data. */
+    st_mutex lock;               /**< Guards the fields below. */
+    void* data;                  /**< The shared data, while constructed. */
+    size_t refs;                 /**< Selected tests using the fixture yet to finish. */
+    bool created;                /**< true while the shared data exists. */
+    bool failed;                 /**< true if construction failed. */
+    uint64_t create_nsec;        /**< Time spent constructing the shared data. */
+} st_fixture;
+
+/** A set of tags (including suites), as bits in the table of all tags in use. */
+typedef struct {
+    uint64_t words[(ST_MAX_TAGS + 63) / 64];
+} st_tagset;
+
+/** The table of all tags (including suites) used by tests. */
+typedef struct {
+    char names[ST_MAX_TAGS][ST_MAX_TAG_STR_LEN + 1]; /**< Tag names; index is the bit. */
+    bool is_suite[ST_MAX_TAGS];                      /**< true if used as a suite name. */
+    bool is_tag[ST_MAX_TAGS];                        /**< true if used as a tag. */
+    size_t count;                                    /**< Entries used in `names`. */
+} st_tag_table;
+
+/** Operations of a compiled --tags expression. */
+enum {
+    ST_TAGOP_TAG = 0, /**< Push whether the test has the tag `tag`. */
+    ST_TAGOP_FALSE,   /**< Push false (a tag no test has). */
+    ST_TAGOP_NOT,     /**< Negate the top of the stack. */
+    ST_TAGOP_AND,     /**< Pop two; push their conjunction. */
+    ST_TAGOP_OR       /**< Pop two; push their disjunction. */
+};
+
+/** An operation of a compiled --tags expression. */
+typedef struct {
+    uint16_t op;  /**< One of the ST_TAGOP_ values. */
+    uint16_t tag; /**< If ST_TAGOP_TAG, the tag's bit. */
+} st_tag_op;
+
+/** A --tags expression, compiled to reverse Polish notation. */
+typedef struct {
+    st_tag_op ops[ST_MAX_TAG_EXPR_OPS]; /**< The operations, in order. */
+    size_t num_ops;                     /**< Entries used in `ops`. */
+} st_tag_expr;
+
+/** Produces the case at `index` of a generated source (`out->index` is already set);
+ * returns false if there is no such case, which ends the test. */
+typedef bool (*st_case_gen_fn)(size_t index, st_case* out);
+
+/** Kinds of st_case_source. */
+enum {
+    ST_CASES_TABLE = 1, /**< Elements of a static array. */
+    ST_CASES_GENERATOR, /**< Produced on demand by a function. */
+    ST_CASES_FILE,      /**< Records of a data file, separated by a delimiter. */
+    ST_CASES_DIR        /**< The files in a directory (e.g. a fuzzing corpus). */
+};
+
+/** Where the cases of a parameterized test come from (see ST_CASES_TABLE,
+ * ST_CASES_GENERATOR, and ST_CASES_FILE). */
+typedef struct {
+    int kind;                 /**< One of the ST_CASES_ values. */
+    const void* table;        /**< ST_CASES_TABLE: the first element. */
+    size_t elem_size;         /**< ST_CASES_TABLE: the size of an element. */
+    size_t count;             /**< ST_CASES_TABLE: the number of elements. */
+    st_case_gen_fn generate;  /**< ST_CASES_GENERATOR: the generator. */
+    const char* path;         /**< ST_CASES_FILE/DIR: the data file or directory. */
+    char delim;               /**< ST_CASES_FILE: the record delimiter. */
+} st_case_source;
+
+/** The state of an iteration over the cases of a st_case_source. Records of data
+ * files are read from a read-only mapping of the file as they are needed. */
+typedef struct {
+    const st_case_source* source; /**< The source of cases. */
+    size_t next;                  /**< The index of the next case. */
+    const char* map;              /**< ST_CASES_FILE: the mapped file, or NULL. */
+    size_t map_size;              /**< ST_CASES_FILE: the size of the mapping. */
+    size_t offset;                /**< ST_CASES_FILE: the offset of the next record. */
+# if !defined(__WIN__)
+    DIR* dir;                     /**< ST_CASES_DIR: the open directory. */
+# else
+    HANDLE dir;                   /**< ST_CASES_DIR: the directory search. */
+    WIN32_FIND_DATAA find_data;   /**< ST_CASES_DIR: the next entry, if `found`. */
+    bool found;                   /**< ST_CASES_DIR: true if `find_data` is valid. */
+# endif
+    char label[ST_MAX_CASE_PATH_LEN]; /**< ST_CASES_DIR: the current file's name. */
+    char path[ST_MAX_CASE_PATH_LEN];  /**< ST_CASES_DIR: the current file's path. */
+    bool error;                   /**< true if a case could not be read. */
+} st_case_iter;
+
 /** An entry in the list of available tests. */
 typedef struct {
     const char* const name;
@@ -72,8 +388,118 @@ typedef struct {
     double msec;
     int conds;
     bool run;
+    st_section_rec sections[ST_SECTION_TOP_N]; /**< Slowest sections, descending. */
+    size_t num_sections;                       /**< Entries used in `sections`. */
+    int noisy_benchmarks;                      /**< Benchmarks flagged as noisy. */
+    size_t suppressed;                         /**< Failures not printed (see --max-failures). */
+    st_repeat_stats stats;                     /**< If run repeatedly, statistics. */
+    uint32_t attempts;                         /**< Runs needed to pass (see --retries). */
+    bool flaky;                                /**< true if the test passed on retry. */
+    bool quarantined;                          /**< true if listed in --quarantine. */
+    bool resumed;                              /**< true if the result is from the journal. */
+    uint32_t timeout;                          /**< Time limit in seconds (0: the default). */
+    bool timed_out;                            /**< true if the test exceeded its time limit. */
+    const char* suite;                         /**< The suite the test belongs to, or NULL. */
+    const char* tags;                          /**< Tags separated by spaces or commas. */
+    st_tagset tagset;                          /**< The test's tags and suite (see --tags). */
+    st_hook_fn setup;                          /**< Runs before each run of the test. */
+    st_hook_fn teardown;                       /**< Runs after each run of the test. */
+    st_fixture* const* fixtures;               /**< Fixtures used (NULL-terminated). */
+    double fixture_msec;                       /**< Time spent constructing fixtures. */
+    const st_case_source* cases;               /**< If parameterized, its cases. */
+    bool isolate;                              /**< true to run in a child process. */
+    char only_case[ST_MAX_CASE_STR_LEN];       /**< If set, the only case to run. */
+    size_t num_cases;                          /**< Cases run by the last run. */
+    size_t failed_cases;                       /**< Cases that failed in the last run. */
 } st_test;
 
+/** A test registered by ST_TEST, found at startup in a dedicated linker section. */
+typedef struct {
+    const char* name;            /**< The test's name. */
+    st_test_fn fn;               /**< The test function. */
+    int conds;                   /**< Conditions required to run the test. */
+    uint32_t timeout;            /**< Time limit in seconds (0: the default). */
+    const char* suite;           /**< The suite the test belongs to, or NULL. */
+    const char* tags;            /**< Tags separated by spaces or commas, or NULL. */
+    st_hook_fn setup;            /**< Runs before each run of the test, or NULL. */
+    st_hook_fn teardown;         /**< Runs after each run of the test, or NULL. */
+    st_fixture* const* fixtures; /**< Fixtures used (NULL-terminated), or NULL. */
+    const st_case_source* cases; /**< If parameterized, its cases; otherwise NULL. */
+    bool isolate;                /**< true to run the test in a child process. */
+} st_test_reg;
+
+/** The journal of completed tests (see --resume and --rerun-failed). */
+typedef struct {
+    FILE* file;       /**< The open journal, or NULL if journaling is unavailable. */
+    uint32_t pending; /**< Records written since the journal was last synced. */
+} st_journal;
+
+/** Index of tests by name (see st_find_test). */
+typedef struct {
+    const st_test* tests; /**< The indexed tests. */
+    size_t* slots;        /**< Indices into `tests` (plus one; zero if empty). */
+    size_t mask;          /**< The number of slots, minus one. */
+} st_test_index;
+
+/** A pattern given to --filter. */
+typedef struct {
+    const char* pattern; /**< The pattern, without any leading '!'. */
+    bool negate;         /**< true if matching tests are excluded. */
+    bool regex;          /**< true if the pattern is a /regular expression/. */
+# if !defined(__WIN__)
+    void* re;            /**< If `regex`, the compiled expression (a regex_t). */
+# endif
+} st_filter;
+
+/** The pattern cached by an ST_STR_MATCHES or ST_STR_NOT_MATCHES call site. Only the
+ * first pattern evaluated at a site is cached; once set, it is not modified until
+ * st_main returns, so it is matched without holding `lock`. */
+typedef struct st_regex_site {
+    st_mutex lock;              /**< Guards `pattern` (and `re`) while unset. */
+    char* pattern;              /**< A copy of the cached pattern, or NULL. */
+# if !defined(__WIN__)
+    void* re;                   /**< The compiled `pattern` (a regex_t). */
+# endif
+    struct st_regex_site* next; /**< The next site with a cached pattern. */
+} st_regex_site;
+
+# define _ST_REGEX_SITE_INIT {.lock = ST_MUTEX_INITIALIZER}
+
+/** A comparison evaluator call site (ST_EQUAL, ST_LESS_THAN, etc.), described for
+ * st_cmp_failed so that the call made on failure takes only pointers. */
+typedef struct {
+    const char* name;     /**< The name of the evaluator. */
+    const char* text;     /**< The text of the comparison. */
+    const char* lhs_expr; /**< The text of the left operand. */
+    const char* rhs_expr; /**< The text of the right operand. */
+    size_t lhs_size;      /**< The size of the left operand. */
+    size_t rhs_size;      /**< The size of the right operand. */
+    int lhs_kind;         /**< The ST_VALUE_ kind of the left operand. */
+    int rhs_kind;         /**< The ST_VALUE_ kind of the right operand. */
+    uint32_t line;        /**< The line number of the call site. */
+} st_cmp_site;
+
+/** The failures of an ST_FOR_ALL or ST_FOR_NONE. */
+typedef struct {
+    size_t count;                         /**< The number of failing indices. */
+    size_t first[ST_MAX_FOR_ALL_INDICES]; /**< The first (up to) ST_MAX_FOR_ALL_INDICES. */
+} st_for_all;
+
+/** Global state container. */
+typedef struct {
+    const char* app_name;
+    bool fail_early;
+    uint32_t bench_warmup;      /**< Maximum benchmark warmup batches (see --warmup). */
+    uint32_t timeout;           /**< Default time limit for tests, in seconds (see --timeout). */
+    uint32_t max_failures;      /**< Failures printed per test (see --max-failures). */
+    st_watchdog watchdog;       /**< Enforces time limits for tests. */
+    st_test_index index;        /**< Index of tests by name. */
+    st_tag_table tags;          /**< All tags (and suites) used by tests. */
+    uint64_t seed;              /**< Seed for properties' cases (see --seed). */
+    bool update_snapshots;      /**< true if --update-snapshots was passed. */
+    st_regex_site* regex_sites; /**< Call sites with a cached pattern. */
+} st_state;
+
 /** A command line argument. */
 typedef struct {
     const char* const s_flag; /**< e.g. -w. */
@@ -84,9 +510,21 @@ typedef struct {
 
 /** Command line configuration. */
 typedef struct {
-    bool wait;     /**< true if --wait was passed, false otherwise. */
-    bool only;     /**< true if --only was passed, false otherwise. */
-    size_t to_run; /**< If --only was passed, how many tests to run. */
+    bool wait;           /**< true if --wait was passed, false otherwise. */
+    bool only;           /**< true if --only was passed, false otherwise. */
+    size_t to_run;       /**< If --only was passed, how many tests to run. */
+    bool pin;            /**< true if --pin-cpu was passed, false otherwise. */
+    uint32_t cpu;        /**< If --pin-cpu was passed, the CPU to pin the test thread to. */
+    uint32_t repeat;     /**< The number of times to run each test (see --repeat). */
+    bool until_fail;     /**< true if --repeat-until-fail was passed, false otherwise. */
+    uint32_t retries;    /**< The number of times to retry a failed test (see --retries). */
+    bool rerun_failed;   /**< true if --rerun-failed was passed, false otherwise. */
+    bool resume;         /**< true if --resume was passed, false otherwise. */
+    const char* journal; /**< The path given to --journal, or NULL. */
+    bool no_journal;     /**< true if --no-journal was passed, false otherwise. */
+    st_filter* filters;  /**< The patterns given to --filter. */
+    size_t num_filters;  /**< The number of entries in `filters`. */
+    const char* tags;    /**< The expression given to --tags, or NULL. */
 } st_cl_config;
 
 /** Millisecond timer. */
@@ -203,10 +641,16 @@ typedef struct {
  * Only works for words whose plural form is just an 's'. */
 # define _ST_PLURAL(word, count) ((!(count) || (count) > 1) ? word "s" : word)
 
-/** The base macro for all stdout macros. */
-# define __ST_MESSAGE(...) (void)printf(__VA_ARGS__)
+/** The base macro for all stdout macros. Output is suppressed while a property's
+ * cases are checked and shrunk. */
+# define __ST_MESSAGE(...) (void)(st_output_muted() ? 0 : printf(__VA_ARGS__))
 
 # define _ST_MESSAGE(msg, ...) __ST_MESSAGE(WHITE(msg) "\n", __VA_ARGS__)
+
+/** Prints a detail of an evaluator's failure, unless the test has printed as many
+ * failures as it may (in which case the failure itself is not printed either). */
+# define _ST_DETAIL(msg, ...) \
+    (void)(st_failures_suppressed() ? 0 : (_ST_MESSAGE(msg, __VA_ARGS__), 0))
 # define _ST_SUCCESS(msg, ...) __ST_MESSAGE(FG_COLOR(0, 40, msg) "\n", __VA_ARGS__)
 # define _ST_SKIPPED(msg, ...) __ST_MESSAGE(FG_COLOR(1, 178, EMPH(msg)) "\n", __VA_ARGS__)
 # define _ST_WARNING(msg, ...) __ST_MESSAGE(FG_COLOR(0, 208, msg) "\n", __VA_ARGS__)
@@ -225,7 +669,9 @@ typedef struct {
 # define _ST_DEBUG_PREFIX ST_LOC_SEATEST " " ST_LOC_DEBUG ":"
 
 # define _ST_SKIP_PASS_FAIL(test) \
-     (test->res.skip ? FG_COLOR(1, 178, ST_LOC_SKIP) : test->res.pass \
+     (test->res.skip ? FG_COLOR(1, 178, ST_LOC_SKIP) : test->flaky \
+                     ? FG_COLOR(1, 141, ST_LOC_FLAKY) : test->timed_out \
+                     ? FG_COLOR(1, 196, ST_LOC_TIMEOUT) : test->res.pass \
                      ? FG_COLOR(1,  40, ST_LOC_PASS) : test->res.fatal \
                      ? FG_COLOR(1, 196, ST_LOC_FAIL) : FG_COLOR(1, 208, ST_LOC_WARN))
 
@@ -250,15 +696,90 @@ typedef struct {
 /** Self-explanatory. */
 # define _ST_NOTNULL(p) (p) != 0
 
+/** The (ASCII, locale-independent) classes of ST_STR_ALPHA and ST_STR_NUMERIC. */
+# define _ST_ALPHA_CHARS "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+# define _ST_DIGIT_CHARS "0123456789"
+
 # define _ST_DECLARE_CL_ARGS() \
     static const st_cl_arg st_cl_args[] = { \
         ST_CL_CONFIG() \
     }
 
+/** Tests registered by ST_TEST are placed (as pointers to st_test_reg) in a linker
+ * section named 'st_test_regs', whose bounds are resolved in the translation unit
+ * that contains ST_MAIN_IMPL, so that each module only sees its own tests. */
+# if defined(__ELF__) && (defined(__GNUC__) || defined(__clang__))
+#  define ST_HAVE_TEST_REGISTRATION
+#  define _ST_TEST_SECTION __attribute__((used, section("st_test_regs")))
+extern const st_test_reg* const __start_st_test_regs[]
+    __attribute__((weak, visibility("hidden")));
+extern const st_test_reg* const __stop_st_test_regs[]
+    __attribute__((weak, visibility("hidden")));
+#  define _ST_REGISTERED_TESTS_BEGIN __start_st_test_regs
+#  define _ST_REGISTERED_TESTS_END   __stop_st_test_regs
+# elif defined(__MACOS__)
+#  define ST_HAVE_TEST_REGISTRATION
+#  define _ST_TEST_SECTION __attribute__((used, section("__DATA,st_test_regs")))
+extern const st_test_reg* const _st_tests_start[] __asm("section$start$__DATA$st_test_regs");
+extern const st_test_reg* const _st_tests_stop[] __asm("section$end$__DATA$st_test_regs");
+#  define _ST_REGISTERED_TESTS_BEGIN _st_tests_start
+#  define _ST_REGISTERED_TESTS_END   _st_tests_stop
+# elif defined(__WIN__) && defined(_MSC_VER)
+/* the linker sorts grouped sections ($a, $m, $z) by name; entries in $m lie
+ * between the two markers, possibly separated by zero padding. */
+#  define ST_HAVE_TEST_REGISTRATION
+#  pragma section("st_test_regs$a", read)
+#  pragma section("st_test_regs$m", read)
+#  pragma section("st_test_regs$z", read)
+#  define _ST_TEST_SECTION __declspec(allocate("st_test_regs$m"))
+__declspec(allocate("st_test_regs$a")) __declspec(selectany)
+    const st_test_reg* const _st_tests_start = NULL;
+__declspec(allocate("st_test_regs$z")) __declspec(selectany)
+    const st_test_reg* const _st_tests_stop = NULL;
+#  define _ST_REGISTERED_TESTS_BEGIN (&_st_tests_start + 1)
+#  define _ST_REGISTERED_TESTS_END   (&_st_tests_stop)
+# else
+#  define _ST_REGISTERED_TESTS_BEGIN NULL
+#  define _ST_REGISTERED_TESTS_END   NULL
+# endif
+
+# if defined(ST_HAVE_TEST_REGISTRATION)
+#  define _ST_REGISTER_TEST(test_name, ...) \
+    static const st_test_reg _st_reg_##test_name = { \
+        .name = #test_name, .fn = st_test_##test_name, __VA_ARGS__ \
+    }; \
+    static const st_test_reg* const _st_regp_##test_name _ST_TEST_SECTION = \
+        &_st_reg_##test_name;
+# else
+#  define _ST_REGISTER_TEST(test_name, ...) \
+    _Static_assert(false, "ST_TEST is not supported on this platform; use" \
+        " ST_DECLARE_TEST_LIST_ENTRY instead");
+# endif
+
+# if defined(ST_FUZZING)
+/* built with -fsanitize=fuzzer: the target is the fuzzer's entry point. */
+#  define _ST_FUZZ_ENTRY(name, corpus_dir) \
+    int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size); \
+    int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) \
+    { \
+        if (st_fuzz_##name(data, size).fatal) { \
+            abort(); \
+        } \
+        return 0; \
+    }
+# else
+#  define _ST_FUZZ_ENTRY(name, corpus_dir) \
+    ST_TEST_WITH(name, .cases = ST_CASES_DIR(corpus_dir), .isolate = true) \
+    { \
+        __retval = st_fuzz_##name((const uint8_t*)ST_CASE()->data, ST_CASE()->size); \
+    } \
+    ST_END_TEST_IMPL()
+# endif
+
 # define _ST_VALIDATE_RETURN() \
     do { \
         if (__retval.warnings > 0 || !__retval.pass) { \
-            assert(__retval.warnings > 0); \
+            assert(__retval.warnings > 0 || __retval.errors > 0); \
             assert(!__retval.pass); \
         } \
         if (__retval.errors > 0 || __retval.fatal) { \
@@ -268,28 +789,101 @@ typedef struct {
         return __retval; \
     } while (false)
 
+# define _ST_COUNT_FAILURE(is_fatal) \
+    do { \
+        __retval.pass = false; \
+        __retval.last_fail = true; \
+        if ((is_fatal)) { \
+            __retval.fatal = true; \
+            __retval.errors++; \
+        } else { \
+            __retval.warnings++; \
+        } \
+    } while (false)
+
 # define _ST_EVALUATE_EXPR_RAW(expr, name, color, is_fatal) \
     do { \
-        if (!(expr)) { \
-            __retval.pass = false; \
-            __retval.last_fail = true; \
-            if ((is_fatal)) { \
-                __retval.fatal = true; \
-                __retval.errors++; \
-            } else { \
-                __retval.warnings++; \
-            } \
-            (void)printf(ST_LOC_INDENT FG_COLOR(0, color, name " ("ST_LOC_LINE \
-                " %"PRIu32"):") DGRAY(" "ST_LOC_EXPRESSION) WHITE(" '" #expr "'") \
-                DGRAY(" "ST_LOC_IS_FALSE"\n"), __LINE__); \
+        if (_ST_LIKELY(expr)) { \
+            __retval.last_fail = false; \
         } else { \
+            _ST_COUNT_FAILURE(is_fatal); \
+            st_eval_failed(name, #expr, __LINE__, color, (is_fatal)); \
+        } \
+    } while (false)
+
+/** Evaluates `lhs` and `rhs` once each into temporaries of their own types, compares
+ * them with `op`, and on failure prints their values. Where the compiler cannot name
+ * the types, compares the operands in place instead.
+ *
+ * A literal operand held in a temporary is no longer a constant, so comparing the
+ * temporaries could warn where comparing the operands would not (e.g. strlen(s) == 5
+ * under -Wsign-compare). Those warnings are suppressed, and the operands are instead
+ * compared in place in a branch that is never taken, so that the comparison is
+ * diagnosed exactly as written (compilers do not diagnose it within sizeof).
+ *
+ * A null pointer constant compared with a pointer (e.g. ST_EQUAL(ptr, 0)) is held in a
+ * temporary of the pointer's type, rather than an int (see _ST_CMP_TYPEOF). */
+# if defined(_ST_TYPEOF)
+#  define _ST_EVALUATE_CMP(lhs, op, rhs, name) \
+    do { \
+        if (false) { \
+            (void)((lhs) op (rhs)); \
+        } \
+        const _ST_CMP_TYPEOF(lhs, rhs) __st_lhs = (lhs); \
+        const _ST_CMP_TYPEOF(rhs, lhs) __st_rhs = (rhs); \
+        _ST_NO_SIGN_COMPARE_BEGIN \
+        const bool __st_cmp = __st_lhs op __st_rhs; \
+        _ST_NO_SIGN_COMPARE_END \
+        if (_ST_LIKELY(__st_cmp)) { \
             __retval.last_fail = false; \
+        } else { \
+            static const st_cmp_site __st_site = { \
+                name, "(" #lhs ") " #op " (" #rhs ")", #lhs, #rhs, sizeof(__st_lhs), \
+                sizeof(__st_rhs), _ST_OPERAND_KIND(__st_lhs), _ST_OPERAND_KIND(__st_rhs), \
+                __LINE__ \
+            }; \
+            /* copies, so that only the failure path takes an address. */ \
+            const _ST_CMP_TYPEOF(lhs, rhs) __st_lhs_copy = __st_lhs; \
+            const _ST_CMP_TYPEOF(rhs, lhs) __st_rhs_copy = __st_rhs; \
+            _ST_COUNT_FAILURE(true); \
+            st_cmp_failed(&__st_site, &__st_lhs_copy, &__st_rhs_copy); \
         } \
     } while (false)
 
+/** The type of the temporary holding `x`, which is compared with `other` (neither is
+ * evaluated): that of `x`, unless `x` is arithmetic and `other` is a pointer, in which
+ * case `x` must be a null pointer constant, and is given the pointer's type. */
+#  define _ST_CMP_TYPEOF(x, other) \
+    _ST_TYPEOF(_Generic((char(*)[1 + (ST_VALUE_BYTES != _ST_VALUE_KIND(x) && \
+        ST_VALUE_BYTES == _ST_VALUE_KIND(other))])0, \
+        char(*)[2]: 0 ? (other) : (x), \
+        default: (x)))
+# else
+#  define _ST_EVALUATE_CMP(lhs, op, rhs, name) \
+    _ST_EVALUATE_EXPR((lhs) op (rhs), name)
+# endif
+
 # define _ST_EVALUATE_EXPR(expr, name) \
     _ST_EVALUATE_EXPR_RAW(expr, name, 196, true)
 
+/** As _ST_EVALUATE_EXPR, but on failure prints `text` as the expression, rather than
+ * `expr` (e.g. the call to a helper that does the evaluating). */
+# define _ST_EVALUATE_EXPR_AS(expr, name, text) \
+    do { \
+        if (_ST_LIKELY(expr)) { \
+            __retval.last_fail = false; \
+        } else { \
+            _ST_COUNT_FAILURE(true); \
+            st_eval_failed(name, text, __LINE__, 196, true); \
+        } \
+    } while (false)
+
+/** The kind (see _ST_VALUE_KIND) by which the elements of `arr1` and `arr2`, which
+ * are not evaluated, are compared: by value if both are reals, otherwise bitwise. */
+# define _ST_ELEMS_KIND(arr1, arr2) \
+    (ST_VALUE_REAL == _ST_VALUE_KIND((arr1)[0]) && \
+        ST_VALUE_REAL == _ST_VALUE_KIND((arr2)[0]) ? ST_VALUE_REAL : ST_VALUE_BYTES)
+
 # define _ST_PROCESS_TEST_CONDITION(condition, check_cond) \
     do { \
         if (!condition && (tests[n].conds & check_cond) == check_cond) { \
@@ -400,6 +994,81 @@ char* _st_conds_to_string(int conds, char str[ST_MAX_MULTIPLE_COND_STR_LEN])
     return &str[0];
 }
 
+/** The ST_VALUE_ kind of the type of `x`, which is not evaluated. Enumerations are
+ * compatible with (and classified as) an integer type. */
+# define _ST_VALUE_KIND(x) \
+    _Generic((x), \
+        _Bool: ST_VALUE_UNSIGNED, \
+        char: (CHAR_MIN < 0 ? ST_VALUE_SIGNED : ST_VALUE_UNSIGNED), \
+        signed char: ST_VALUE_SIGNED, \
+        unsigned char: ST_VALUE_UNSIGNED, \
+        short: ST_VALUE_SIGNED, \
+        unsigned short: ST_VALUE_UNSIGNED, \
+        int: ST_VALUE_SIGNED, \
+        unsigned int: ST_VALUE_UNSIGNED, \
+        long: ST_VALUE_SIGNED, \
+        unsigned long: ST_VALUE_UNSIGNED, \
+        long long: ST_VALUE_SIGNED, \
+        unsigned long long: ST_VALUE_UNSIGNED, \
+        float: ST_VALUE_REAL, \
+        double: ST_VALUE_REAL, \
+        long double: ST_VALUE_REAL, \
+        default: ST_VALUE_BYTES)
+
+/** The kind of `x`, a scalar, which is not evaluated: as _ST_VALUE_KIND, but
+ * ST_VALUE_POINTER for pointers. */
+# define _ST_OPERAND_KIND(x) \
+    (ST_VALUE_BYTES == _ST_VALUE_KIND(x) ? ST_VALUE_POINTER : _ST_VALUE_KIND(x))
+
+/** Whether `x`, which is not evaluated, is a float (rather than a double, or any
+ * other type). */
+# define _ST_IS_FLOAT(x) _Generic((x), float: true, default: false)
+
+/** Captures `x`, an arithmetic value or an object pointer, as an st_value. `x` is
+ * evaluated once. */
+# define _ST_VALUE(x) \
+    _Generic((x), \
+        _Bool: _st_value_unsigned, \
+        char: _st_value_signed, \
+        signed char: _st_value_signed, \
+        unsigned char: _st_value_unsigned, \
+        short: _st_value_signed, \
+        unsigned short: _st_value_unsigned, \
+        int: _st_value_signed, \
+        unsigned int: _st_value_unsigned, \
+        long: _st_value_signed, \
+        unsigned long: _st_value_unsigned, \
+        long long: _st_value_signed, \
+        unsigned long long: _st_value_unsigned, \
+        float: _st_value_real, \
+        double: _st_value_real, \
+        long double: _st_value_real, \
+        default: _st_value_pointer)(x)
+
+static inline
+st_value _st_value_signed(int64_t value)
+{
+    return (st_value){.kind = ST_VALUE_SIGNED, .i = value};
+}
+
+static inline
+st_value _st_value_unsigned(uint64_t value)
+{
+    return (st_value){.kind = ST_VALUE_UNSIGNED, .u = value};
+}
+
+static inline
+st_value _st_value_real(long double value)
+{
+    return (st_value){.kind = ST_VALUE_REAL, .f = value};
+}
+
+static inline
+st_value _st_value_pointer(const volatile void* value)
+{
+    return (st_value){.kind = ST_VALUE_POINTER, .u = (uint64_t)(uintptr_t)value};
+}
+
 /** Counts the number of high bits in a condition bitmask. */
 static inline
 int _st_conds_count(int conds) {
@@ -27,10 +27,18 @@
 # define _SEATEST_MACROS_H_INCLUDED
 
 /** The only code needed in main()/the entry point. `app_name` is a name to associate
- * with the test rig, such as a product or company name. */
+ * with the test rig, such as a product or company name. Runs the tests in the list
+ * (see ST_BEGIN_DECLARE_TEST_LIST), followed by any registered with ST_TEST. */
 # define ST_MAIN_IMPL(app_name) \
-    st_main(argc, argv, app_name, st_cl_args, _ST_COUNTOF(st_cl_args), \
-        st_tests, _ST_COUNTOF(st_tests))
+    st_main_ex(argc, argv, app_name, st_cl_args, _ST_COUNTOF(st_cl_args), \
+        st_tests, _ST_COUNTOF(st_tests), _ST_REGISTERED_TESTS_BEGIN, \
+        _ST_REGISTERED_TESTS_END)
+
+/** Like ST_MAIN_IMPL, for test rigs whose tests are all registered with ST_TEST
+ * (and so don't declare a list of tests). */
+# define ST_MAIN_IMPL_AUTO(app_name) \
+    st_main_ex(argc, argv, app_name, st_cl_args, _ST_COUNTOF(st_cl_args), \
+        NULL, 0, _ST_REGISTERED_TESTS_BEGIN, _ST_REGISTERED_TESTS_END)
 
 /** Declares static variables required by seatest. Place above the entry point routine. */
 # define ST_DECLARE_STATIC_VARS() \
@@ -49,18 +57,198 @@
         st_testres __retval = {0}; \
         __retval.pass = true;
 
+/** Declares, registers, and begins the definition of an individual test function,
+ * which may be in any translation unit: no entry in the list of tests is required.
+ * The test's name is `name`. End the definition with ST_END_TEST_IMPL(). */
+# define ST_TEST(name) \
+    ST_TEST_EX(name, 0, 0)
+
+/** Like ST_TEST, with conditions required to run the test (e.g. COND_INET), and a
+ * time limit in seconds (0 uses the default; see --timeout). */
+# define ST_TEST_EX(name, conditions, timeout_sec) \
+    ST_TEST_FULL(name, conditions, timeout_sec, NULL, NULL)
+
+/** Like ST_TEST, with the name of the suite the test belongs to, and a list of tags
+ * separated by spaces or commas, e.g. ST_TEST_TAGS(parse_big, "parser", "slow io").
+ * Either may be NULL. See --tags. */
+# define ST_TEST_TAGS(name, suite_name, tag_list) \
+    ST_TEST_FULL(name, 0, 0, suite_name, tag_list)
+
+/** Like ST_TEST, with conditions, a time limit, a suite, and tags. */
+# define ST_TEST_FULL(name, conditions, timeout_sec, suite_name, tag_list) \
+    ST_TEST_WITH(name, .conds = (conditions), .timeout = (timeout_sec), \
+        .suite = (suite_name), .tags = (tag_list))
+
+/** Like ST_TEST, with any fields of st_test_reg given as designated initializers,
+ * e.g. ST_TEST_WITH(parse_big, .setup = open_db, .fixtures = ST_FIXTURES(...)). */
+# define ST_TEST_WITH(name, ...) \
+    ST_DECLARE_TEST(name) \
+    _ST_REGISTER_TEST(name, __VA_ARGS__) \
+    ST_BEGIN_TEST_IMPL(name)
+
 /** Ends the definition (implementation) of an individual test function. */
 # define ST_END_TEST_IMPL() \
         _ST_VALIDATE_RETURN(); \
     }
 
+/** Declares, registers, and begins the definition of a parameterized test, which is
+ * run once for each case produced by `source` (ST_CASES_TABLE, ST_CASES_GENERATOR, or
+ * ST_CASES_FILE). Within the test, ST_CASE() is the case being run. Cases are
+ * produced one at a time, as they are run, and are reported as 'name/index' (or
+ * 'name/label'). */
+# define ST_TEST_P(name, source) \
+    ST_TEST_WITH(name, .cases = (source))
+
+/** Cases taken from the elements of a static array; ST_CASE_DATA(type) points to
+ * the element. */
+# define ST_CASES_TABLE(array) \
+    (&(const st_case_source){.kind = ST_CASES_TABLE, .table = (array), \
+        .elem_size = sizeof((array)[0]), .count = _ST_COUNTOF(array)})
+
+/** Cases produced on demand by a function (st_case_gen_fn), which may also give
+ * each case a label. */
+# define ST_CASES_GENERATOR(gen_fn) \
+    (&(const st_case_source){.kind = ST_CASES_GENERATOR, .generate = (gen_fn)})
+
+/** Cases read from the records of a data file, separated by `delimiter` (e.g.
+ * '\n'; a '\r' preceding a '\n' delimiter is not part of the record). The file is
+ * mapped into memory rather than read; ST_CASE()->data and ->size are the record. */
+# define ST_CASES_FILE(file_path, delimiter) \
+    (&(const st_case_source){.kind = ST_CASES_FILE, .path = (file_path), \
+        .delim = (delimiter)})
+
+/** Cases read from each file in a directory (hidden files excepted), labeled with
+ * the file's name. Each file is mapped into memory while its case runs. */
+# define ST_CASES_DIR(dir_path) \
+    (&(const st_case_source){.kind = ST_CASES_DIR, .path = (dir_path)})
+
+/** Defines a fuzz target compatible with libFuzzer: a function of the input `data`
+ * (const uint8_t*) of `size` bytes, ended with ST_END_TEST_IMPL(). Under seatest,
+ * each file in the target's corpus (ST_FUZZ_CORPUS_DIR/name) is a case, run in a
+ * child process so that crashes are reported rather than ending the run. Built with
+ * -fsanitize=fuzzer and ST_FUZZING defined, the target is LLVMFuzzerTestOneInput
+ * instead (so only one may be defined per executable), and failing evaluators abort. */
+# define ST_FUZZ_TARGET(name, data_var, size_var) \
+    ST_FUZZ_TARGET_EX(name, ST_FUZZ_CORPUS_DIR "/" #name, data_var, size_var)
+
+/** Like ST_FUZZ_TARGET, with the path of the corpus directory. */
+# define ST_FUZZ_TARGET_EX(name, corpus_dir, data_var, size_var) \
+    static st_testres st_fuzz_##name(const uint8_t* data_var, size_t size_var); \
+    _ST_FUZZ_ENTRY(name, corpus_dir) \
+    static st_testres st_fuzz_##name(const uint8_t* data_var, size_t size_var) \
+    { \
+        st_testres __retval = {0}; \
+        __retval.pass = true;
+
+/** Within a parameterized test, the case being run (a const st_case*). */
+# define ST_CASE() st_current_case()
+
+/** Within a parameterized test, the data of the case being run, as a pointer to
+ * `type`. */
+# define ST_CASE_DATA(type) ((const type*)st_current_case()->data)
+
+/** Declares, registers, and begins the definition of a property: a test whose body
+ * is run for ST_PROP_DEFAULT_CASES cases of input generated within it (by ST_GEN_INT,
+ * ST_GEN_STRING, etc.). The first failing case is shrunk to a minimal
+ * counterexample, which is printed along with the seed that reproduces it (see
+ * --seed). The body must be deterministic given its generated input. End the
+ * definition with ST_END_TEST_IMPL(). */
+# define ST_PROPERTY(name) \
+    ST_PROPERTY_EX(name, ST_PROP_DEFAULT_CASES)
+
+/** Like ST_PROPERTY, with the number of cases to check. */
+# define ST_PROPERTY_EX(name, num_cases) \
+    static st_testres st_prop_##name(void); \
+    ST_TEST(name) \
+    { \
+        __retval = st_check_property(#name, &st_prop_##name, (num_cases)); \
+    } \
+    ST_END_TEST_IMPL() \
+    static st_testres st_prop_##name(void) \
+    { \
+        st_testres __retval = {0}; \
+        __retval.pass = true;
+
+/** Within a property, generates an integer in [`lo`, `hi`]. */
+# define ST_GEN_INT(lo, hi) st_gen_int((lo), (hi))
+
+/** Within a property, generates an unsigned integer in [`lo`, `hi`]. */
+# define ST_GEN_UINT(lo, hi) st_gen_uint((lo), (hi))
+
+/** Within a property, generates a (finite) double in [`lo`, `hi`]. */
+# define ST_GEN_DOUBLE(lo, hi) st_gen_double((lo), (hi))
+
+/** Within a property, generates a bool. */
+# define ST_GEN_BOOL() st_gen_bool()
+
+/** Within a property, generates a string of up to `max_len` characters from
+ * `alphabet` (a string; NULL for printable ASCII). */
+# define ST_GEN_STRING(max_len, alphabet) st_gen_string((max_len), (alphabet))
+
+/** Within a property, generates a buffer of up to `max_len` bytes; its length is
+ * stored in `len` (a size_t). */
+# define ST_GEN_BYTES(len, max_len) st_gen_bytes(&(len), (max_len))
+
+/** Within a property, generates an array of up to `max_len` int64_t in [`lo`, `hi`];
+ * the number of elements is stored in `len` (a size_t). */
+# define ST_GEN_INT_ARRAY(len, max_len, lo, hi) \
+    st_gen_int_array(&(len), (max_len), (lo), (hi))
+
+/** Defines a suite-level fixture: shared data constructed by `create_fn` (which
+ * returns a pointer to it, or NULL on failure) just before the first selected test
+ * that uses the fixture runs, and destroyed by `destroy_fn` as soon as the last
+ * of those tests finishes. Tests list the fixtures they use with ST_FIXTURES. */
+# define ST_DEFINE_FIXTURE(fixture_name, create_fn, destroy_fn) \
+    st_fixture st_fixture_##fixture_name = { \
+        .name = #fixture_name, .create = (create_fn), .destroy = (destroy_fn), \
+        .lock = ST_MUTEX_INITIALIZER \
+    };
+
+/** Declares a fixture defined (with ST_DEFINE_FIXTURE) in another file. */
+# define ST_DECLARE_FIXTURE(name) \
+    extern st_fixture st_fixture_##name;
+
+/** Refers to a fixture, e.g. in ST_FIXTURES(ST_FIXTURE(dataset), ST_FIXTURE(db)). */
+# define ST_FIXTURE(name) (&st_fixture_##name)
+
+/** The list of fixtures used by a test (the value of its .fixtures field). */
+# define ST_FIXTURES(...) ((st_fixture* const[]){__VA_ARGS__, NULL})
+
+/** Within a test, returns the shared (read-only) data of a fixture the test uses, as
+ * a pointer to `type`. */
+# define ST_FIXTURE_DATA(name, type) \
+    ((const type*)st_fixture_data(ST_FIXTURE(name)))
+
 /** Begins the declaration of the global list of available tests. */
 # define ST_BEGIN_DECLARE_TEST_LIST(...) \
     static st_test st_tests[] = {
 
 /** Adds an entry to the global list of tests. */
-# define ST_DECLARE_TEST_LIST_ENTRY_COND(name, fn_name, conditions) \
-    {#name, st_test_##fn_name, {0}, 0.0, conditions, false},
+# define ST_DECLARE_TEST_LIST_ENTRY_COND(test_name, fn_name, conditions) \
+    ST_DECLARE_TEST_LIST_ENTRY_EX(test_name, fn_name, conditions, 0)
+
+/** Adds an entry to the global list of tests, with conditions and a time limit in
+ * seconds (0 uses the default; see --timeout). */
+# define ST_DECLARE_TEST_LIST_ENTRY_EX(test_name, fn_name, conditions, timeout_sec) \
+    ST_DECLARE_TEST_LIST_ENTRY_FULL(test_name, fn_name, conditions, timeout_sec, NULL, NULL)
+
+/** Adds an entry to the global list of tests, with the name of the suite the test
+ * belongs to, and a list of tags separated by spaces or commas (e.g. "fast io").
+ * Either may be NULL. See --tags. */
+# define ST_DECLARE_TEST_LIST_ENTRY_TAGS(test_name, fn_name, suite_name, tag_list) \
+    ST_DECLARE_TEST_LIST_ENTRY_FULL(test_name, fn_name, 0, 0, suite_name, tag_list)
+
+/** Adds an entry to the global list of tests, with conditions, a time limit, a
+ * suite, and tags. */
+# define ST_DECLARE_TEST_LIST_ENTRY_FULL(test_name, fn_name, conditions, timeout_sec, \
+    suite_name, tag_list) \
+    ST_DECLARE_TEST_LIST_ENTRY_WITH(test_name, fn_name, .conds = (conditions), \
+        .timeout = (timeout_sec), .suite = (suite_name), .tags = (tag_list))
+
+/** Adds an entry to the global list of tests, with any fields of st_test given as
+ * designated initializers, e.g. .setup = open_db, .fixtures = ST_FIXTURES(...). */
+# define ST_DECLARE_TEST_LIST_ENTRY_WITH(test_name, fn_name, ...) \
+    {.name = #test_name, .fn = st_test_##fn_name, __VA_ARGS__},
 
 /** Adds an entry to the global list of tests. */
 # define ST_DECLARE_TEST_LIST_ENTRY(name, fn_name) \
@@ -131,6 +319,24 @@
         } \
     } while (false)
 
+/** Begins a timed section of a test, e.g. `ST_SECTION("setup") { ... }`. Sections
+ * may be nested; evaluator failures are attributed to the innermost section, and
+ * the slowest sections are displayed in the test's outro. Do not `break` or `goto`
+ * out of a section (returning from the test, e.g. ST_TEST_EXIT_IF_FAILED, is fine). */
+# define ST_SECTION(name) \
+    for (st_section __st_sect = {(name), NULL, 0, 0, 0}, \
+        *__st_sectp = st_section_enter(&__st_sect); __st_sectp != NULL; \
+        __st_sectp = st_section_leave(__st_sectp))
+
+/** Benchmarks the statement or block that follows, e.g. `ST_BENCHMARK("memcpy", 1000)
+ * { ... }`. The body is first run in warmup batches until timing stabilizes (see
+ * --warmup), then run `iterations` times between two clock reads. The result is
+ * flagged as noisy if the CPU's frequency changed, it was throttled, or the thread
+ * migrated during the measured run (see --pin-cpu). Do not `break` out of the body. */
+# define ST_BENCHMARK(name, iterations) \
+    for (st_benchmark __st_bench = st_benchmark_init((name), (iterations)); \
+        __st_bench.remaining-- > 0 || st_benchmark_next(&__st_bench); )
+
 # define ST_OS_ERROR_MSG(code, context) \
     do { \
         char message[ST_MAX_ERROR_STR_LEN] = {0}; \
@@ -152,27 +358,27 @@
 
 /** Evaluates whether `lhs` is equal to `rhs`. */
 # define ST_EQUAL(lhs, rhs) \
-    _ST_EVALUATE_EXPR((lhs) == (rhs), "ST_EQUAL")
+    _ST_EVALUATE_CMP(lhs, ==, rhs, "ST_EQUAL")
 
 /** Evaluates whether `lhs` is not equal to `rhs`. */
 # define ST_NOT_EQUAL(lhs, rhs) \
-    _ST_EVALUATE_EXPR((lhs) != (rhs), "ST_NOT_EQUAL")
+    _ST_EVALUATE_CMP(lhs, !=, rhs, "ST_NOT_EQUAL")
 
 /** Evaluates whether `lhs` is less than `rhs`. */
 # define ST_LESS_THAN(lhs, rhs) \
-    _ST_EVALUATE_EXPR((lhs) < (rhs), "ST_LESS_THAN")
+    _ST_EVALUATE_CMP(lhs, <, rhs, "ST_LESS_THAN")
 
 /** Evaluates whether `lhs` is less than or equal to `rhs`. */
 # define ST_LESS_THAN_OR_EQUAL(lhs, rhs) \
-    _ST_EVALUATE_EXPR((lhs) <= (rhs), "ST_LESS_THAN_OR_EQUAL")
+    _ST_EVALUATE_CMP(lhs, <=, rhs, "ST_LESS_THAN_OR_EQUAL")
 
 /** Evaluates whether `lhs` is greater than `rhs`. */
 # define ST_GREATER_THAN(lhs, rhs) \
-    _ST_EVALUATE_EXPR((lhs) > (rhs), "ST_GREATER_THAN")
+    _ST_EVALUATE_CMP(lhs, >, rhs, "ST_GREATER_THAN")
 
 /** Evaluates whether `lhs` is greater than or equal to `rhs`. */
 # define ST_GREATER_THAN_OR_EQUAL(lhs, rhs) \
-    _ST_EVALUATE_EXPR((lhs) >= (rhs), "ST_GREATER_THAN_OR_EQUAL")
+    _ST_EVALUATE_CMP(lhs, >=, rhs, "ST_GREATER_THAN_OR_EQUAL")
 
 /** Evaluates whether `ptr` is null. */
 # define ST_NULL(ptr) \
@@ -182,6 +388,47 @@
 # define ST_NOT_NULL(ptr) \
     _ST_EVALUATE_EXPR((ptr) != NULL, "ST_NOT_NULL")
 
+/** Evaluates whether `predicate` is true for each `i` (a size_t declared by the macro)
+ * from 0 to `n` - 1. Unlike an evaluator in a loop, fails (and prints) only once: the
+ * number of values of `i` for which `predicate` is false, and the first of them. */
+# define ST_FOR_ALL(i, n, predicate) \
+    do { \
+        st_for_all __st_all = {0}; \
+        const size_t __st_n = (n); \
+        for (size_t i = 0; i < __st_n; i++) { \
+            if (_ST_LIKELY(predicate)) { \
+                continue; \
+            } \
+            st_for_all_fail(&__st_all, i); \
+        } \
+        if (_ST_LIKELY(0 == __st_all.count)) { \
+            __retval.last_fail = false; \
+        } else { \
+            _ST_COUNT_FAILURE(true); \
+            st_for_all_failed(&__st_all, __st_n, #i, #predicate, true, __LINE__); \
+        } \
+    } while (false)
+
+/** Evaluates whether `predicate` is false for each `i` from 0 to `n` - 1. The negation
+ * of ST_FOR_ALL, printing the values of `i` for which `predicate` is true. */
+# define ST_FOR_NONE(i, n, predicate) \
+    do { \
+        st_for_all __st_all = {0}; \
+        const size_t __st_n = (n); \
+        for (size_t i = 0; i < __st_n; i++) { \
+            if (_ST_LIKELY(!(predicate))) { \
+                continue; \
+            } \
+            st_for_all_fail(&__st_all, i); \
+        } \
+        if (_ST_LIKELY(0 == __st_all.count)) { \
+            __retval.last_fail = false; \
+        } else { \
+            _ST_COUNT_FAILURE(true); \
+            st_for_all_failed(&__st_all, __st_n, #i, #predicate, false, __LINE__); \
+        } \
+    } while (false)
+
 /**
  * Bitwise
  */
@@ -203,33 +450,25 @@
 # define ST_BITWISE_NOT_EQUAL(lhs, rhs, size) \
     _ST_EVALUATE_EXPR(0 != memcmp(&(lhs), &(rhs), (size)), "ST_BITWISE_NOT_EQUAL")
 
-/** Evaluates whether `obj` is comprised of all zero bytes. */
+/** Evaluates whether `obj` is comprised of all zero bytes (up to `size`). */
 # define ST_BITWISE_ZEROED(obj, size) \
-    do { \
-        bool all_bytes_zero = true; \
-        const unsigned char* ptr = (const void*)(&obj); \
-        for (uintptr_t n = 0; n < (uintptr_t)size; n++) { \
-            if (*(ptr + n) != 0) { \
-                all_bytes_zero = false; \
-                break; \
-            } \
-        } \
-        _ST_EVALUATE_EXPR(all_bytes_zero, "ST_BITWISE_ZEROED"); \
-    } while (false)
+    _ST_EVALUATE_EXPR(st_mem_filled(&(obj), (size), 0), "ST_BITWISE_ZEROED")
 
-/** Evaluates whether `obj` is not comprised of all zero bytes. */
+/** Evaluates whether `obj` is not comprised of all zero bytes (up to `size`), i.e.
+ * whether any byte is not zero. */
 # define ST_BITWISE_NOT_ZEROED(obj, size) \
-    do { \
-        bool all_bytes_not_zero = true; \
-        const unsigned char* ptr = (const void*)(&obj); \
-        for (uintptr_t n = 0; n < (uintptr_t)size; n++) { \
-            if (*(ptr + n) == 0) { \
-                all_bytes_not_zero = false; \
-                break; \
-            } \
-        } \
-        _ST_EVALUATE_EXPR(all_bytes_not_zero, "ST_BITWISE_NOT_ZEROED"); \
-    } while (false)
+    _ST_EVALUATE_EXPR(st_mem_not_filled(&(obj), (size), 0), "ST_BITWISE_NOT_ZEROED")
+
+/** Evaluates whether each of the `len` bytes at `ptr` is equal to `byte`. On failure,
+ * prints the offset of the first that isn't and a hex window around it. */
+# define ST_MEM_FILLED(ptr, len, byte) \
+    _ST_EVALUATE_EXPR(st_mem_filled((ptr), (len), (uint8_t)(byte)), "ST_MEM_FILLED")
+
+/** Evaluates whether the `len` bytes at `ptr` consist of the `plen` bytes at `pattern`,
+ * repeated (the last repetition may be partial). On failure, prints the offset of the
+ * first byte that differs and a hex window around it. */
+# define ST_MEM_PATTERN(ptr, len, pattern, plen) \
+    _ST_EVALUATE_EXPR(st_mem_pattern((ptr), (len), (pattern), (plen)), "ST_MEM_PATTERN")
 
 /**
  * String
@@ -500,20 +739,16 @@
         _ST_EVALUATE_EXPR(!isspace((str)[_st_eval_input_strlen((str)) - 1]), "ST_STR_NOT_ENDSWITH_WSPACE"); \
     } while (false)
 
-/** Evaluates whether `str` contains only characters in the alphabet. For further
- * information, consult the documentation for isalpha(). */
+/** Evaluates whether `str` contains only the letters 'A'-'Z' and 'a'-'z'. */
 # define ST_STR_ALPHA(str) \
     do { \
         if (!(str)) { \
             _ST_EVALUATE_EXPR(_ST_NOTNULL(str), "ST_STR_ALPHA"); \
             break; \
         } \
-        for (size_t n = 0; n < _st_eval_input_strlen((str)); n++) { \
-            if (!isalpha((str)[n])) { \
-                _ST_EVALUATE_EXPR(isalpha((str)[n]), "ST_STR_ALPHA"); \
-                break; \
-            } \
-        } \
+        const char* _st_chars = _ST_ALPHA_CHARS; \
+        _ST_EVALUATE_EXPR(st_str_only_chars((str), _st_eval_input_strlen((str)), _st_chars), \
+            "ST_STR_ALPHA"); \
     } while (false)
 
 /** Evaluates whether `str` only contains the characters '0'-'9'. */
@@ -523,30 +758,205 @@
             _ST_EVALUATE_EXPR(_ST_NOTNULL(str), "ST_STR_NUMERIC"); \
             break; \
         } \
-        for (size_t n = 0; n < _st_eval_input_strlen((str)); n++) { \
-            if (!isdigit((str)[n])) { \
-                _ST_EVALUATE_EXPR(isdigit((str)[n]), "ST_STR_NUMERIC"); \
-                break; \
-            } \
-        } \
+        const char* _st_chars = _ST_DIGIT_CHARS; \
+        _ST_EVALUATE_EXPR(st_str_only_chars((str), _st_eval_input_strlen((str)), _st_chars), \
+            "ST_STR_NUMERIC"); \
     } while (false)
 
-/** Evaluates whether `str` contains only alphanumeric characters. For further
- * information, consult the documentation for isalnum(). */
+/** Evaluates whether `str` contains only the letters 'A'-'Z' and 'a'-'z' and the
+ * digits '0'-'9'. */
 # define ST_STR_ALPHANUMERIC(str) \
     do { \
         if (!(str)) { \
             _ST_EVALUATE_EXPR(_ST_NOTNULL(str), "ST_STR_ALPHANUMERIC"); \
             break; \
         } \
-        for (size_t n = 0; n < _st_eval_input_strlen((str)); n++) { \
-            if (!isalnum((str)[n])) { \
-                _ST_EVALUATE_EXPR(isalnum((str)[n]), "ST_STR_ALPHANUMERIC"); \
-                break; \
-            } \
+        const char* _st_chars = _ST_ALPHA_CHARS _ST_DIGIT_CHARS; \
+        _ST_EVALUATE_EXPR(st_str_only_chars((str), _st_eval_input_strlen((str)), _st_chars), \
+            "ST_STR_ALPHANUMERIC"); \
+    } while (false)
+
+/** Evaluates whether each of the first `len` characters of `str` is one of those in
+ * `set` (as with strspn()). Unlike the other ST_STR_ evaluators, `str` need not be
+ * NUL-terminated, and is not limited to ST_MAX_EVAL_STR_LEN characters. */
+# define ST_STR_ONLY_CHARS(str, len, set) \
+    do { \
+        if (!(str)) { \
+            _ST_EVALUATE_EXPR(_ST_NOTNULL(str), "ST_STR_ONLY_CHARS"); \
+            break; \
+        } \
+        _ST_EVALUATE_EXPR(st_str_only_chars((str), (len), (set)), "ST_STR_ONLY_CHARS"); \
+    } while (false)
+
+/** Evaluates whether the `len` bytes at `str` are well-formed UTF-8. Overlong forms,
+ * surrogates and code points above U+10FFFF are invalid, as are sequences cut short
+ * by `len`. */
+# define ST_STR_UTF8_VALID(str, len) \
+    do { \
+        if (!(str)) { \
+            _ST_EVALUATE_EXPR(_ST_NOTNULL(str), "ST_STR_UTF8_VALID"); \
+            break; \
         } \
+        _ST_EVALUATE_EXPR(st_str_utf8_valid((str), (len)), "ST_STR_UTF8_VALID"); \
+    } while (false)
+
+/** Evaluates whether `str` contains a match for the POSIX extended regular
+ * expression `pattern` (anchor it with '^' and '$' to match all of `str`). Each call
+ * site compiles its pattern once and caches it until the runner exits. */
+# define ST_STR_MATCHES(str, pattern) \
+    do { \
+        static st_regex_site _st_site = _ST_REGEX_SITE_INIT; \
+        if (!(str) || !(pattern)) { \
+            _ST_EVALUATE_EXPR( \
+                _ST_NOTNULL(str) && _ST_NOTNULL(pattern), "ST_STR_MATCHES" \
+            ); \
+            break; \
+        } \
+        _ST_EVALUATE_EXPR(st_str_matches(&_st_site, (str), (pattern)), "ST_STR_MATCHES"); \
+    } while (false)
+
+/** Evaluates whether `str` contains no match for the POSIX extended regular
+ * expression `pattern`. On failure, prints the first match. */
+# define ST_STR_NOT_MATCHES(str, pattern) \
+    do { \
+        static st_regex_site _st_site = _ST_REGEX_SITE_INIT; \
+        if (!(str) || !(pattern)) { \
+            _ST_EVALUATE_EXPR( \
+                _ST_NOTNULL(str) && _ST_NOTNULL(pattern), "ST_STR_NOT_MATCHES" \
+            ); \
+            break; \
+        } \
+        _ST_EVALUATE_EXPR( \
+            st_str_not_matches(&_st_site, (str), (pattern)), "ST_STR_NOT_MATCHES" \
+        ); \
     } while (false)
 
+/**
+ * Buffer
+ */
+
+/** Evaluates whether the `len1` bytes at `buf1` equal the `len2` bytes at `buf2`.
+ * Neither buffer need be NUL-terminated, nor is limited to ST_MAX_EVAL_STR_LEN; either
+ * may be NULL if empty. On failure, prints the first difference. */
+# define ST_BUF_EQUAL(buf1, len1, buf2, len2) \
+    _ST_EVALUATE_EXPR(st_buf_equal((buf1), (len1), (buf2), (len2), false), "ST_BUF_EQUAL")
+
+/** Evaluates whether the `len1` bytes at `buf1` equal the `len2` bytes at `buf2`. The
+ * comparison is case-insensitive. */
+# define ST_BUF_EQUAL_I(buf1, len1, buf2, len2) \
+    _ST_EVALUATE_EXPR(st_buf_equal((buf1), (len1), (buf2), (len2), true), "ST_BUF_EQUAL_I")
+
+/** Evaluates whether the `len1` bytes at `buf1` differ from the `len2` bytes at
+ * `buf2`. */
+# define ST_BUF_NOT_EQUAL(buf1, len1, buf2, len2) \
+    _ST_EVALUATE_EXPR( \
+        st_buf_not_equal((buf1), (len1), (buf2), (len2), false), "ST_BUF_NOT_EQUAL" \
+    )
+
+/** Evaluates whether the `len1` bytes at `buf1` differ from the `len2` bytes at `buf2`.
+ * The comparison is case-insensitive. */
+# define ST_BUF_NOT_EQUAL_I(buf1, len1, buf2, len2) \
+    _ST_EVALUATE_EXPR( \
+        st_buf_not_equal((buf1), (len1), (buf2), (len2), true), "ST_BUF_NOT_EQUAL_I" \
+    )
+
+/** Evaluates whether the `haystack_len` bytes at `haystack` contain the `needle_len`
+ * bytes at `needle`. The search takes linear time. */
+# define ST_BUF_CONTAINS(needle, needle_len, haystack, haystack_len) \
+    _ST_EVALUATE_EXPR( \
+        st_buf_contains((needle), (needle_len), (haystack), (haystack_len), false), \
+        "ST_BUF_CONTAINS" \
+    )
+
+/** Evaluates whether the `haystack_len` bytes at `haystack` contain the `needle_len`
+ * bytes at `needle`. The comparison is case-insensitive. */
+# define ST_BUF_CONTAINS_I(needle, needle_len, haystack, haystack_len) \
+    _ST_EVALUATE_EXPR( \
+        st_buf_contains((needle), (needle_len), (haystack), (haystack_len), true), \
+        "ST_BUF_CONTAINS_I" \
+    )
+
+/** Evaluates whether the `haystack_len` bytes at `haystack` do not contain the
+ * `needle_len` bytes at `needle`. On failure, prints the offset of the first
+ * occurrence. */
+# define ST_BUF_NOT_CONTAINS(needle, needle_len, haystack, haystack_len) \
+    _ST_EVALUATE_EXPR( \
+        st_buf_not_contains((needle), (needle_len), (haystack), (haystack_len), false), \
+        "ST_BUF_NOT_CONTAINS" \
+    )
+
+/** Evaluates whether the `haystack_len` bytes at `haystack` do not contain the
+ * `needle_len` bytes at `needle`. The comparison is case-insensitive. */
+# define ST_BUF_NOT_CONTAINS_I(needle, needle_len, haystack, haystack_len) \
+    _ST_EVALUATE_EXPR( \
+        st_buf_not_contains((needle), (needle_len), (haystack), (haystack_len), true), \
+        "ST_BUF_NOT_CONTAINS_I" \
+    )
+
+/** Evaluates whether the `haystack_len` bytes at `haystack` begin with the `needle_len`
+ * bytes at `needle`. */
+# define ST_BUF_BEGINSWITH(needle, needle_len, haystack, haystack_len) \
+    _ST_EVALUATE_EXPR( \
+        st_buf_begins_with((needle), (needle_len), (haystack), (haystack_len), false), \
+        "ST_BUF_BEGINSWITH" \
+    )
+
+/** Evaluates whether the `haystack_len` bytes at `haystack` begin with the `needle_len`
+ * bytes at `needle`. The comparison is case-insensitive. */
+# define ST_BUF_BEGINSWITH_I(needle, needle_len, haystack, haystack_len) \
+    _ST_EVALUATE_EXPR( \
+        st_buf_begins_with((needle), (needle_len), (haystack), (haystack_len), true), \
+        "ST_BUF_BEGINSWITH_I" \
+    )
+
+/** Evaluates whether the `haystack_len` bytes at `haystack` do not begin with the
+ * `needle_len` bytes at `needle`. */
+# define ST_BUF_NOT_BEGINSWITH(needle, needle_len, haystack, haystack_len) \
+    _ST_EVALUATE_EXPR( \
+        st_buf_not_begins_with((needle), (needle_len), (haystack), (haystack_len), false), \
+        "ST_BUF_NOT_BEGINSWITH" \
+    )
+
+/** Evaluates whether the `haystack_len` bytes at `haystack` do not begin with the
+ * `needle_len` bytes at `needle`. The comparison is case-insensitive. */
+# define ST_BUF_NOT_BEGINSWITH_I(needle, needle_len, haystack, haystack_len) \
+    _ST_EVALUATE_EXPR( \
+        st_buf_not_begins_with((needle), (needle_len), (haystack), (haystack_len), true), \
+        "ST_BUF_NOT_BEGINSWITH_I" \
+    )
+
+/** Evaluates whether the `haystack_len` bytes at `haystack` end with the `needle_len`
+ * bytes at `needle`. */
+# define ST_BUF_ENDSWITH(needle, needle_len, haystack, haystack_len) \
+    _ST_EVALUATE_EXPR( \
+        st_buf_ends_with((needle), (needle_len), (haystack), (haystack_len), false), \
+        "ST_BUF_ENDSWITH" \
+    )
+
+/** Evaluates whether the `haystack_len` bytes at `haystack` end with the `needle_len`
+ * bytes at `needle`. The comparison is case-insensitive. */
+# define ST_BUF_ENDSWITH_I(needle, needle_len, haystack, haystack_len) \
+    _ST_EVALUATE_EXPR( \
+        st_buf_ends_with((needle), (needle_len), (haystack), (haystack_len), true), \
+        "ST_BUF_ENDSWITH_I" \
+    )
+
+/** Evaluates whether the `haystack_len` bytes at `haystack` do not end with the
+ * `needle_len` bytes at `needle`. */
+# define ST_BUF_NOT_ENDSWITH(needle, needle_len, haystack, haystack_len) \
+    _ST_EVALUATE_EXPR( \
+        st_buf_not_ends_with((needle), (needle_len), (haystack), (haystack_len), false), \
+        "ST_BUF_NOT_ENDSWITH" \
+    )
+
+/** Evaluates whether the `haystack_len` bytes at `haystack` do not end with the
+ * `needle_len` bytes at `needle`. The comparison is case-insensitive. */
+# define ST_BUF_NOT_ENDSWITH_I(needle, needle_len, haystack, haystack_len) \
+    _ST_EVALUATE_EXPR( \
+        st_buf_not_ends_with((needle), (needle_len), (haystack), (haystack_len), true), \
+        "ST_BUF_NOT_ENDSWITH_I" \
+    )
+
 /**
  * Numeric
  */
@@ -661,22 +1071,195 @@
         } \
     } while (false)
 
-/** Evaluates whether all of the elements in `arr` are unique in value. */
+/** Evaluates whether all of the elements in `arr` are unique in value. Elements are
+ * compared bitwise (floating-point elements as by ==), in linear time. */
 # define ST_ARRAY_UNIQUE(arr) \
+    _ST_EVALUATE_EXPR_AS(st_array_unique((arr), _ST_COUNTOF(arr), sizeof((arr)[0]), \
+        _ST_VALUE_KIND((arr)[0])), "ST_ARRAY_UNIQUE", "(" #arr ")[j] != (" #arr ")[n]")
+
+/** Evaluates whether the elements in `arr` are in ascending order, such that no
+ * element is less than the one preceding it. */
+# define ST_ARRAY_SORTED(arr) \
     do { \
-        for (size_t n = 0; n < _ST_COUNTOF(arr); n++) { \
-            bool match = false; \
-            for (size_t j = 0; j < _ST_COUNTOF(arr); j++) { \
-                if (j != n && (arr)[j] == (arr)[n]) { \
-                    _ST_EVALUATE_EXPR((arr)[j] != (arr)[n], "ST_ARRAY_UNIQUE"); \
-                    match = true; \
-                    break; \
-                } \
-            } \
-            if (match) { \
+        for (size_t n = 1; n < _ST_COUNTOF(arr); n++) { \
+            if ((arr)[n] < (arr)[n - 1]) { \
+                _ST_MESSAGE(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_OUT_OF_ORDER, n - 1, n); \
+                _ST_EVALUATE_EXPR((arr)[n - 1] <= (arr)[n], "ST_ARRAY_SORTED"); \
                 break; \
             } \
         } \
     } while (false)
 
+/** Evaluates whether `arr2` is a rearrangement of `arr1`: both contain elements of
+ * the same size, and each value occurs the same number of times in each. Elements are
+ * compared bitwise (floating-point elements as by ==), in linear time. */
+# define ST_ARRAY_PERMUTATION_OF(arr1, arr2) \
+    do { \
+        size_t elem_size1 = sizeof((arr1)[0]); \
+        size_t elem_size2 = sizeof((arr2)[0]); \
+        if (elem_size1 != elem_size2) { \
+            _ST_EVALUATE_EXPR(elem_size1 == elem_size2, "ST_ARRAY_PERMUTATION_OF"); \
+            break; \
+        } \
+        _ST_EVALUATE_EXPR_AS(st_array_permutation_of((arr1), _ST_COUNTOF(arr1), (arr2), \
+            _ST_COUNTOF(arr2), elem_size1, _ST_ELEMS_KIND(arr1, arr2)), \
+            "ST_ARRAY_PERMUTATION_OF", "multiset(" #arr1 ") == multiset(" #arr2 ")"); \
+    } while (false)
+
+/** Evaluates whether `arr1` and `arr2` contain elements of the same size, and the
+ * same set of distinct values, regardless of order or repetition. Elements are
+ * compared bitwise (floating-point elements as by ==), in linear time. */
+# define ST_ARRAY_SET_EQUAL(arr1, arr2) \
+    do { \
+        size_t elem_size1 = sizeof((arr1)[0]); \
+        size_t elem_size2 = sizeof((arr2)[0]); \
+        if (elem_size1 != elem_size2) { \
+            _ST_EVALUATE_EXPR(elem_size1 == elem_size2, "ST_ARRAY_SET_EQUAL"); \
+            break; \
+        } \
+        _ST_EVALUATE_EXPR_AS(st_array_set_equal((arr1), _ST_COUNTOF(arr1), (arr2), \
+            _ST_COUNTOF(arr2), elem_size1, _ST_ELEMS_KIND(arr1, arr2)), \
+            "ST_ARRAY_SET_EQUAL", "set(" #arr1 ") == set(" #arr2 ")"); \
+    } while (false)
+
+/**
+ * Span
+ */
+
+/** Evaluates whether the `count1` elements at `ptr1` and the `count2` elements at
+ * `ptr2` are of the same size and number, and equal in value. On failure, prints the
+ * index and values of the first elements that differ. */
+# define ST_SPAN_EQUAL(ptr1, count1, ptr2, count2) \
+    do { \
+        size_t elem_size1 = sizeof((ptr1)[0]); \
+        size_t elem_size2 = sizeof((ptr2)[0]); \
+        if (elem_size1 != elem_size2) { \
+            _ST_EVALUATE_EXPR(elem_size1 == elem_size2, "ST_SPAN_EQUAL"); \
+            break; \
+        } \
+        int kind1 = _ST_VALUE_KIND((ptr1)[0]); \
+        int kind2 = _ST_VALUE_KIND((ptr2)[0]); \
+        _ST_EVALUATE_EXPR(st_span_equal((ptr1), (count1), kind1, (ptr2), (count2), kind2, \
+            elem_size1), "ST_SPAN_EQUAL"); \
+    } while (false)
+
+/** Evaluates whether any of the `count` elements at `ptr` is equal in value to
+ * `val`, which is evaluated once. */
+# define ST_SPAN_CONTAINS(ptr, count, val) \
+    do { \
+        int kind       = _ST_VALUE_KIND((ptr)[0]); \
+        st_value value = _ST_VALUE(val); \
+        _ST_EVALUATE_EXPR(st_span_contains((ptr), (count), sizeof((ptr)[0]), kind, value), \
+            "ST_SPAN_CONTAINS"); \
+    } while (false)
+
+/** Evaluates whether none of the `count` elements at `ptr` is equal in value to
+ * `val`, which is evaluated once. On failure, prints the index of the first that is. */
+# define ST_SPAN_NOT_CONTAINS(ptr, count, val) \
+    do { \
+        int kind       = _ST_VALUE_KIND((ptr)[0]); \
+        st_value value = _ST_VALUE(val); \
+        _ST_EVALUATE_EXPR(st_span_not_contains((ptr), (count), sizeof((ptr)[0]), kind, \
+            value), "ST_SPAN_NOT_CONTAINS"); \
+    } while (false)
+
+/**
+ * Floating point
+ */
+
+/** Evaluates whether `a` and `b` are equal, both NaN, or no further apart than
+ * `abs_tol`. Each is evaluated once; if both are floats, they are compared in single
+ * precision. On failure, prints both values, their difference, and the ULPs between
+ * them. */
+# define ST_NEAR(a, b, abs_tol) \
+    do { \
+        const bool single = _ST_IS_FLOAT(a) && _ST_IS_FLOAT(b); \
+        _ST_EVALUATE_EXPR(st_near((a), (b), (abs_tol), 0, single), "ST_NEAR"); \
+    } while (false)
+
+/** Evaluates whether `a` and `b` are equal, both NaN, or at most `ulps` representable
+ * values (units in the last place) apart. As ST_NEAR, but the tolerance scales with
+ * the magnitude of the operands; infinities are only near themselves. */
+# define ST_NEAR_ULPS(a, b, ulps) \
+    do { \
+        const bool single = _ST_IS_FLOAT(a) && _ST_IS_FLOAT(b); \
+        _ST_EVALUATE_EXPR(st_near((a), (b), 0.0, (ulps), single), "ST_NEAR_ULPS"); \
+    } while (false)
+
+/** Evaluates whether the `count1` floating-point elements at `ptr1` and the `count2`
+ * at `ptr2` are of the same type and number, and each pair is near, as in ST_NEAR or
+ * ST_NEAR_ULPS (either tolerance suffices; pass 0 for the one not wanted). On failure,
+ * prints how many pairs are not, and the one furthest apart. */
+# define ST_SPAN_NEAR(ptr1, count1, ptr2, count2, abs_tol, ulps) \
+    do { \
+        size_t elem_size1 = sizeof((ptr1)[0]); \
+        size_t elem_size2 = sizeof((ptr2)[0]); \
+        bool both_real    = _ST_VALUE_KIND((ptr1)[0]) == ST_VALUE_REAL && \
+            _ST_VALUE_KIND((ptr2)[0]) == ST_VALUE_REAL; \
+        if (elem_size1 != elem_size2 || !both_real) { \
+            _ST_EVALUATE_EXPR(elem_size1 == elem_size2 && both_real, "ST_SPAN_NEAR"); \
+            break; \
+        } \
+        size_t near_count = (count1); \
+        if (near_count != (count2)) { \
+            _ST_EVALUATE_EXPR(near_count == (count2), "ST_SPAN_NEAR"); \
+            break; \
+        } \
+        _ST_EVALUATE_EXPR(st_matrix_near((ptr1), near_count, (ptr2), near_count, 1, \
+            near_count, elem_size1, (abs_tol), (ulps)), "ST_SPAN_NEAR"); \
+    } while (false)
+
+/** Evaluates whether each element of the `rows` x `cols` floating-point matrix at
+ * `ptr1`, whose rows are `stride1` elements apart, is near (as in ST_SPAN_NEAR) the
+ * corresponding element of the matrix at `ptr2`, whose rows are `stride2` apart. */
+# define ST_MATRIX_NEAR(ptr1, rows, cols, stride1, ptr2, stride2, abs_tol, ulps) \
+    do { \
+        size_t elem_size1 = sizeof((ptr1)[0]); \
+        size_t elem_size2 = sizeof((ptr2)[0]); \
+        bool both_real    = _ST_VALUE_KIND((ptr1)[0]) == ST_VALUE_REAL && \
+            _ST_VALUE_KIND((ptr2)[0]) == ST_VALUE_REAL; \
+        if (elem_size1 != elem_size2 || !both_real) { \
+            _ST_EVALUATE_EXPR(elem_size1 == elem_size2 && both_real, "ST_MATRIX_NEAR"); \
+            break; \
+        } \
+        _ST_EVALUATE_EXPR(st_matrix_near((ptr1), (stride1), (ptr2), (stride2), (rows), \
+            (cols), elem_size1, (abs_tol), (ulps)), "ST_MATRIX_NEAR"); \
+    } while (false)
+
+/**
+ * File
+ */
+
+/** Evaluates whether the `len` bytes at `buf` are identical to the snapshot (golden
+ * file) `name`, located in ST_SNAPSHOT_DIR. The snapshot is mapped rather than read,
+ * so it may be arbitrarily large. When run with --update-snapshots, a snapshot that
+ * is missing or differs is (re)written from `buf` instead. */
+# define ST_SNAPSHOT_EQUAL(name, buf, len) \
+    _ST_EVALUATE_EXPR(st_snapshot_equal((name), (buf), (len)), "ST_SNAPSHOT_EQUAL")
+
+/** Evaluates whether the files at `path_a` and `path_b` have identical contents.
+ * Both are mapped rather than read, so they may be arbitrarily large. */
+# define ST_FILE_EQUAL(path_a, path_b) \
+    _ST_EVALUATE_EXPR(st_file_equal((path_a), (path_b)), "ST_FILE_EQUAL")
+
+/**
+ * Digest
+ */
+
+/** Begins a digest of data produced by the test, which is fed to it chunk by chunk
+ * (see ST_DIGEST_UPDATE) rather than buffered, and checked by ST_DIGEST_EQUAL. One
+ * digest may be active per scope. */
+# define ST_DIGEST_BEGIN() \
+    st_digest __st_digest = st_digest_begin()
+
+/** Adds the `len` bytes at `buf` to the digest begun by ST_DIGEST_BEGIN. */
+# define ST_DIGEST_UPDATE(buf, len) \
+    st_digest_update(&__st_digest, (buf), (len))
+
+/** Evaluates whether the digest of the data added so far matches `expected_hex`: 16
+ * hex digits for its XXH3-64 hash (as printed by 'xxhsum -H3'), or 8 for its CRC32C.
+ * The actual digest is printed if not. */
+# define ST_DIGEST_EQUAL(expected_hex) \
+    _ST_EVALUATE_EXPR(st_digest_equal(&__st_digest, (expected_hex)), "ST_DIGEST_EQUAL")
+
 #endif /* !_SEATEST_MACROS_H_INCLUDED */
@@ -70,6 +70,18 @@
 #  include <termios.h>
 #  include <unistd.h>
 #  include <errno.h>
+#  include <pthread.h>
+#  include <signal.h>
+#  include <setjmp.h>
+#  include <fcntl.h>
+#  include <sys/stat.h>
+#  include <sys/mman.h>
+#  include <sys/wait.h>
+#  include <dirent.h>
+
+#  if defined(__linux__)
+#   include <sched.h>
+#  endif
 
 #  if !defined(__STDC_NO_ATOMICS__)
 #   include <stdatomic.h>
@@ -77,10 +89,14 @@
 #  endif
 
 #  define ST_E_INVALID EINVAL
+#  define ST_E_UNSUPPORTED ENOTSUP
 #  define ST_BAD_DESCRIPTOR -1
+#  define ST_TIMEOUT_SIGNAL SIGUSR2
 
 typedef int st_descriptor;
 typedef socklen_t st_optlen;
+typedef pthread_mutex_t st_mutex;
+#  define ST_MUTEX_INITIALIZER PTHREAD_MUTEX_INITIALIZER
 
 # else /* _WIN32 */
 #  define __WIN__
@@ -92,6 +108,7 @@ typedef socklen_t st_optlen;
 #  include <winsock2.h>
 #  include <ws2tcpip.h>
 #  include <direct.h>
+#  include <io.h>
 #  include <conio.h>
 
 #  if defined(_MSC_VER) && _MSC_VER >= 1933
@@ -103,19 +120,24 @@ typedef socklen_t st_optlen;
 #  define ST_MSEC_WIN32
 
 #  define ST_E_INVALID ERROR_INVALID_PARAMETER
+#  define ST_E_UNSUPPORTED ERROR_NOT_SUPPORTED
 #  define ST_BAD_DESCRIPTOR INVALID_SOCKET
 
 typedef SOCKET st_descriptor;
 typedef int st_optlen;
+typedef SRWLOCK st_mutex;
+#  define ST_MUTEX_INITIALIZER SRWLOCK_INIT
 
 # endif /* !_WIN32 */
 
 # include <math.h>
 # include <float.h>
+# include <limits.h>
 # include <time.h>
 # include <ctype.h>
 # include <stdio.h>
 # include <stdarg.h>
+# include <stddef.h>
 # include <stdbool.h>
 # include <stdint.h>
 # include <stdlib.h>
@@ -177,6 +199,70 @@ typedef int st_optlen;
 #  define ST_INTERVALCLOCK CLOCK_REALTIME
 # endif
 
+# if defined(__MACOS__) || defined(__GLIBC__)
+#  include <execinfo.h>
+#  define __HAVE_BACKTRACE__
+# endif
+
+# if defined(__WIN__) && defined(_MSC_VER)
+#  define ST_THREAD_LOCAL __declspec(thread)
+# else
+#  define ST_THREAD_LOCAL _Thread_local
+# endif
+
+/* x86 SIMD kernels are compiled for their instruction set with the target attribute,
+ * and selected at run time according to the features of the CPU. */
+# if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#  include <immintrin.h>
+#  define __HAVE_X86_DISPATCH__
+#  define _ST_TARGET(isa) __attribute__((target(isa)))
+#  define _st_cpu_has(isa) __builtin_cpu_supports(isa)
+# endif
+
+/* evaluators predict that they pass, and report failures through a function that is
+ * kept out of line, and out of the way of the code calling it. */
+# if defined(__GNUC__) || defined(__clang__)
+#  define _ST_LIKELY(x) __builtin_expect(!!(x), 1)
+#  define _ST_COLD      __attribute__((cold, noinline))
+# elif defined(_MSC_VER)
+#  define _ST_LIKELY(x) (!!(x))
+#  define _ST_COLD      __declspec(noinline)
+# else
+#  define _ST_LIKELY(x) (!!(x))
+#  define _ST_COLD
+# endif
+
+/* the type of the value of `x` (arrays and functions decayed, qualifiers dropped), where
+ * the compiler can name it. `x` is not evaluated. */
+# if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 202311L
+#  define _ST_TYPEOF(x) typeof(0 ? (x) : (x))
+# elif defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1939)
+#  define _ST_TYPEOF(x) __typeof__(0 ? (x) : (x))
+# endif
+
+/* suppress signed/unsigned comparison warnings between _BEGIN and _END. */
+# if defined(__GNUC__) || defined(__clang__)
+#  define _ST_NO_SIGN_COMPARE_BEGIN \
+    _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Wsign-compare\"")
+#  define _ST_NO_SIGN_COMPARE_END _Pragma("GCC diagnostic pop")
+# elif defined(_MSC_VER)
+#  define _ST_NO_SIGN_COMPARE_BEGIN __pragma(warning(push)) __pragma(warning(disable: 4018 4389))
+#  define _ST_NO_SIGN_COMPARE_END __pragma(warning(pop))
+# else
+#  define _ST_NO_SIGN_COMPARE_BEGIN
+#  define _ST_NO_SIGN_COMPARE_END
+# endif
+
+# if defined(__ARM_FEATURE_CRC32)
+#  include <arm_acle.h>
+#  define __HAVE_ARM_CRC32__
+# endif
+
+# if defined(__SIZEOF_INT128__)
+#  define __HAVE_INT128__
+__extension__ typedef unsigned __int128 st_uint128;
+# endif
+
 # if (defined(__clang__) || defined(__GNUC__)) && defined(__FILE_NAME__)
 #  define __file__ __FILE_NAME__
 # elif defined(__BASE_FILE__)
@@ -29,10 +29,13 @@ ST_DECLARE_STATIC_VARS()
 
 ST_DECLARE_TEST(test_tests)
 ST_DECLARE_TEST(requires_inet)
+ST_DECLARE_TEST(times_out)
 
 ST_BEGIN_DECLARE_TEST_LIST()
-    ST_DECLARE_TEST_LIST_ENTRY(testing-the-tests, test_tests)
-    ST_DECLARE_TEST_LIST_ENTRY_COND(requires-inet, requires_inet, COND_INET)
+    ST_DECLARE_TEST_LIST_ENTRY_TAGS(testing-the-tests, test_tests, "selftest", "slow")
+    ST_DECLARE_TEST_LIST_ENTRY_FULL(requires-inet, requires_inet, COND_INET, 0, "selftest",
+        "fast, network")
+    ST_DECLARE_TEST_LIST_ENTRY_EX(times-out, times_out, 0, 1)
 ST_END_DECLARE_TEST_LIST()
 
 int main(int argc, char** argv)
@@ -60,11 +63,27 @@ ST_BEGIN_TEST_IMPL(test_tests)
     ST_LESS_THAN_OR_EQUAL(2, 2);
     ST_GREATER_THAN(2, 1);
     ST_GREATER_THAN_OR_EQUAL(2, 2);
+    ST_EQUAL(strlen(msg), 11);
+    ST_GREATER_THAN(strlen(msg), 9);
+    ST_NOT_EQUAL(msg, 0);
+    ST_NOT_EQUAL(NULL, msg2);
+    ST_NOT_EQUAL(msg, msg2);
     ST_NULL(NULL);
     ST_NOT_NULL(msg);
 
+    static int squares[1000];
+    for (int n = 0; n < 1000; n++) {
+        squares[n] = n * n;
+    }
+    squares[990] = -1;
+
+    // should all succeed
+    ST_FOR_ALL(i, 990, squares[i] % 2 == (int)(i % 2));
+    ST_FOR_NONE(i, 990, squares[i] < 0);
+    ST_FOR_ALL(i, 0, false);
+
     // should all fail
-    ST_MESSAGE0("expecting the next 12 to fail");
+    ST_MESSAGE0("expecting the next 15 to fail");
     ST_EXPECT(msg == NULL);
     ST_TRUE(strlen(msg) < 10);
     ST_FALSE(strlen(msg) > 10);
@@ -74,8 +93,11 @@ ST_BEGIN_TEST_IMPL(test_tests)
     ST_LESS_THAN_OR_EQUAL(3, 2);
     ST_GREATER_THAN(1, 2);
     ST_GREATER_THAN_OR_EQUAL(2, 3);
+    ST_EQUAL(strlen(msg), sizeof(squares));
     ST_NULL(msg);
     ST_NOT_NULL(NULL);
+    ST_FOR_ALL(i, 1000, squares[i] >= 100);
+    ST_FOR_NONE(i, 1000, squares[i] < 0);
 
     // should all succeed
     ST_STR_CONTAINS("the", msg);
@@ -97,9 +119,38 @@ ST_BEGIN_TEST_IMPL(test_tests)
     ST_STR_ALPHA("loremipsum");
     ST_STR_NUMERIC("123456");
     ST_STR_ALPHANUMERIC("lorem123ipsum456");
+    ST_STR_ONLY_CHARS("0xdeadbeef", 10, "0123456789abcdefx");
+    ST_STR_ONLY_CHARS("abc\0def", 3, "abc");
+    ST_STR_UTF8_VALID("caf\xc3\xa9 \xe6\xb5\xb7 \xf0\x9f\x8c\x8a", 14);
+
+    // should all succeed
+    static const char body[] = "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\n\r\nhello";
+    const char* slice = body + 9; /* "200 OK", not NUL-terminated */
+    ST_BUF_EQUAL(slice, 6, "200 OK", 6);
+    ST_BUF_NOT_EQUAL(slice, 6, "200 ok", 6);
+    ST_BUF_EQUAL_I(slice, 6, "200 ok", 6);
+    ST_BUF_NOT_EQUAL_I(slice, 6, "200 OKAY", 8);
+    ST_BUF_CONTAINS("OK", 2, slice, 6);
+    ST_BUF_NOT_CONTAINS("HTTP", 4, slice, 6);
+    ST_BUF_CONTAINS_I("content-type", 12, body, sizeof(body) - 1);
+    ST_BUF_NOT_CONTAINS_I("404", 3, body, sizeof(body) - 1);
+    ST_BUF_BEGINSWITH("HTTP/", 5, body, sizeof(body) - 1);
+    ST_BUF_NOT_BEGINSWITH("OK", 2, slice, 6);
+    ST_BUF_BEGINSWITH_I("http/", 5, body, sizeof(body) - 1);
+    ST_BUF_NOT_BEGINSWITH_I("https", 5, body, sizeof(body) - 1);
+    ST_BUF_ENDSWITH("OK", 2, slice, 6);
+    ST_BUF_NOT_ENDSWITH("200", 3, slice, 6);
+    ST_BUF_ENDSWITH_I("\r\nHELLO", 7, body, sizeof(body) - 1);
+    ST_BUF_NOT_ENDSWITH_I("world", 5, body, sizeof(body) - 1);
+    ST_BUF_EQUAL(NULL, 0, "", 0);
+    ST_STR_MATCHES("2024-01-31 12:00:00 INFO started", "^[0-9]{4}-[0-9]{2}-[0-9]{2} ");
+    ST_STR_NOT_MATCHES("2024-01-31 12:00:00 INFO started", "(WARN|ERROR)");
+    for (int n = 0; n < 1000; n++) {
+        ST_STR_MATCHES(n % 2 ? "id_42" : "ID_7", "^[A-Za-z_][A-Za-z0-9_]*$");
+    }
 
     // should all fail
-    ST_MESSAGE0("expecting the next 38 to fail");
+    ST_MESSAGE0("expecting the next 54 to fail");
     const char* null_msg = NULL;
     ST_STR_CONTAINS("sea", msg);
     ST_STR_NOT_CONTAINS("hell", msg);
@@ -120,6 +171,21 @@ ST_BEGIN_TEST_IMPL(test_tests)
     ST_STR_ALPHA("not-alpha");
     ST_STR_NUMERIC("not-numeric");
     ST_STR_ALPHANUMERIC("not-alphanumeric");
+    ST_STR_ONLY_CHARS("0xdeadbeeg", 10, "0123456789abcdefx");
+    ST_STR_UTF8_VALID("\xc0\xaf", 2);
+    ST_STR_UTF8_VALID("\xed\xa0\x80", 3);
+    ST_STR_UTF8_VALID("caf\xc3", 4);
+    ST_BUF_EQUAL(slice, 6, "200 Ok", 6);
+    ST_BUF_EQUAL_I(slice, 6, "200 OKAY", 8);
+    ST_BUF_CONTAINS("404", 3, body, sizeof(body) - 1);
+    ST_BUF_NOT_CONTAINS_I("CONTENT", 7, body, sizeof(body) - 1);
+    ST_BUF_BEGINSWITH("HTTP/2", 6, body, sizeof(body) - 1);
+    ST_BUF_ENDSWITH("200 OK!", 7, slice, 6);
+    ST_BUF_NOT_ENDSWITH_I("HELLO", 5, body, sizeof(body) - 1);
+    ST_BUF_EQUAL(NULL, 6, slice, 6);
+    ST_STR_MATCHES("2024-01-31 12:00:00 INFO started", "^[0-9]{2}:");
+    ST_STR_NOT_MATCHES("2024-01-31 12:00:00 WARN disk full", "(WARN|ERROR)");
+    ST_STR_MATCHES(msg, "(unbalanced");
     ST_STR_CONTAINS(null_msg, msg);
     ST_STR_NOT_CONTAINS(null_msg, msg);
     ST_STR_CONTAINS_I(null_msg, msg);
@@ -139,6 +205,7 @@ ST_BEGIN_TEST_IMPL(test_tests)
     ST_STR_ALPHA(null_msg);
     ST_STR_NUMERIC(null_msg);
     ST_STR_ALPHANUMERIC(null_msg);
+    ST_STR_ONLY_CHARS(null_msg, 0, "abc");
 
     static const int low = 10;
     static const int high = 100;
@@ -166,6 +233,37 @@ ST_BEGIN_TEST_IMPL(test_tests)
     ST_NUM_IN_RANGE(9, low, high);
     ST_NUM_NOT_IN_RANGE(50, low, high);
 
+    double sum = 0.0;
+    for (int n = 0; n < 10; n++) {
+        sum += 0.1;
+    }
+    float weights[6]          = {0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f};
+    const float expected[6]   = {0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f};
+    const double identity[3][4] = {{1.0, 0.0, 0.0, -1.0}, {0.0, 1.0, 0.0, -1.0},
+        {0.0, 0.0, 1.0, -1.0}};
+    double product[3][3]      = {{1.0, 1e-17, 0.0}, {0.0, 1.0, -1e-17}, {0.0, 0.0, 1.0}};
+    weights[2] = weights[0] + weights[1];
+
+    // should all succeed (within 1e-12; one ULP apart; both NaN; the last column of
+    // identity is outside the compared 3x3)
+    ST_NEAR(sum, 1.0, 1e-12);
+    ST_NEAR_ULPS(sum, 1.0, 1);
+    ST_NEAR(NAN, NAN, 0.0);
+    ST_NEAR_ULPS(INFINITY, INFINITY, 0);
+    ST_SPAN_NEAR(weights, 6, expected, 6, 0.0, 2);
+    ST_MATRIX_NEAR(&product[0][0], 3, 3, 3, &identity[0][0], 4, 1e-15, 0);
+
+    // should all fail
+    ST_MESSAGE0("expecting the next 6 to fail");
+    ST_NEAR(sum, 1.0, 0.0);
+    ST_NEAR_ULPS(1.0f, 1.0001f, 4);
+    ST_NEAR(NAN, 1.0, 1e300);
+    ST_NEAR_ULPS(INFINITY, DBL_MAX, UINT64_MAX);
+    ST_SPAN_NEAR(weights, 6, expected, 5, 0.0, 2);
+    product[1][2] = 1e-3;
+    product[2][0] = -1e-9;
+    ST_MATRIX_NEAR(&product[0][0], 3, 3, 3, &identity[0][0], 4, 1e-15, 8);
+
     struct foo {
         int one;
         int two;
@@ -180,11 +278,24 @@ ST_BEGIN_TEST_IMPL(test_tests)
     // should succeed (any byte not zero)
     ST_BITWISE_NOT_ZEROED(not_zeroed, sizeof(struct foo));
 
-    // should fail (some bytes not zero)
-    ST_MESSAGE0("expecting the next 4 to fail");
+    // should fail (some bytes not zero; all bytes zero)
+    ST_MESSAGE0("expecting the next 2 to fail");
     ST_BITWISE_ZEROED(not_zeroed, sizeof(struct foo));
     ST_BITWISE_NOT_ZEROED(zeroed, sizeof(struct foo));
 
+    char filled[40];
+    memset(filled, '*', sizeof(filled));
+
+    // should succeed (every byte '*'; "**" repeated)
+    ST_MEM_FILLED(filled, sizeof(filled), '*');
+    ST_MEM_PATTERN(filled, sizeof(filled), "**", 2);
+
+    // should fail (one byte differs)
+    ST_MESSAGE0("expecting the next 2 to fail");
+    filled[21] = '-';
+    ST_MEM_FILLED(filled, sizeof(filled), '*');
+    ST_MEM_PATTERN(filled, sizeof(filled), "**", 2);
+
     struct foo lhs = {1234, 5678};
     struct foo rhs = {1234, 5678};
 
@@ -233,6 +344,41 @@ ST_BEGIN_TEST_IMPL(test_tests)
     ST_ARRAY_UNIQUE(arr1);
     arr1[3] = 4;
 
+    // should succeed (NaN equals nothing, not even NaN)
+    const double nans[] = {NAN, 1.0, NAN};
+    ST_ARRAY_UNIQUE(nans);
+
+    // should fail (0.0 == -0.0)
+    ST_MESSAGE0("expecting the next 1 to fail");
+    const double zeros[] = {0.0, 1.0, -0.0};
+    ST_ARRAY_UNIQUE(zeros);
+
+    int shuffled[] = {5, 3, 1, 4, 2};
+    int repeated[] = {5, 3, 3, 1, 4, 2, 2};
+
+    // should succeed (ascending; same values, in any order)
+    ST_ARRAY_SORTED(arr1);
+    ST_ARRAY_PERMUTATION_OF(arr1, shuffled);
+    ST_ARRAY_SET_EQUAL(arr1, repeated);
+
+    // should fail (out of order; differing multiplicity)
+    ST_MESSAGE0("expecting the next 2 to fail");
+    ST_ARRAY_SORTED(shuffled);
+    ST_ARRAY_PERMUTATION_OF(arr1, repeated);
+
+    long double reals1[4];
+    long double reals2[4];
+    for (int n = 0; n < 4; n++) {
+        reals1[n] = (long double)n / 3.0L;
+        reals2[3 - n] = (long double)n / 3.0L;
+    }
+    reals2[3] = -0.0L;
+    reals1[0] = 0.0L;
+
+    // should succeed (compared by value: padding aside, and 0.0 == -0.0)
+    ST_ARRAY_PERMUTATION_OF(reals1, reals2);
+    ST_ARRAY_SET_EQUAL(reals1, reals2);
+
     short arr3[] = {1, 2, 3, 4, 5};
 
     // should succeed (?)
@@ -270,6 +416,43 @@ ST_BEGIN_TEST_IMPL(test_tests)
     // should be false
     ST_FALSE(ST_TEST_LAST_EVAL_FALSE());
 
+    // snapshots, written as --update-snapshots would (into a subdirectory).
+    static const char golden[]  = "line one\nline two\n";
+    static const char changed[] = "line one\nline 2\n";
+    ST_TRUE(st_snapshot_update("sandbox/golden", golden, sizeof(golden) - 1));
+
+    // should succeed (identical)
+    ST_SNAPSHOT_EQUAL("sandbox/golden", golden, sizeof(golden) - 1);
+
+    // should fail (differs; missing; missing, though empty)
+    ST_MESSAGE0("expecting the next 3 to fail");
+    ST_SNAPSHOT_EQUAL("sandbox/golden", changed, sizeof(changed) - 1);
+    ST_SNAPSHOT_EQUAL("sandbox/missing", golden, sizeof(golden) - 1);
+    ST_SNAPSHOT_EQUAL("sandbox/empty", "", 0);
+
+    // with --update-snapshots, all are written instead. the directories are left
+    // behind if they hold other snapshots.
+    (void)remove(ST_SNAPSHOT_DIR "/sandbox/golden");
+    (void)remove(ST_SNAPSHOT_DIR "/sandbox/missing");
+    (void)remove(ST_SNAPSHOT_DIR "/sandbox/empty");
+    (void)remove(ST_SNAPSHOT_DIR "/sandbox");
+    (void)remove(ST_SNAPSHOT_DIR);
+
+    // timed sections; failures are attributed to the innermost section.
+    ST_SECTION("outer") {
+        ST_SECTION("inner") {
+            ST_MESSAGE0("expecting the next 1 to fail");
+            ST_EQUAL(1, 2);
+        }
+        st_sleep_msec(2);
+    }
+
+    // benchmarks; the result is flagged if it is likely to be noisy.
+    volatile uint64_t accum = 0;
+    ST_BENCHMARK("accumulate", 100000) {
+        accum += 1;
+    }
+
     // emits an error message with a formatted string from the OS.
     ST_MESSAGE0("testing OS error formatting");
     ST_OS_ERROR_MSG(22, "sysfunc123 failed!");
@@ -291,3 +474,263 @@ ST_BEGIN_TEST_IMPL(requires_inet)
     ST_MESSAGE0("lorem ipsum");
 }
 ST_END_TEST_IMPL()
+
+ST_BEGIN_TEST_IMPL(times_out)
+{
+    /* simulates a deadlock; the watchdog should interrupt this after 1 second. */
+    while (true) {
+        st_sleep_msec(100);
+    }
+}
+ST_END_TEST_IMPL()
+
+/* registered automatically; doesn't need an entry in the list of tests. */
+ST_TEST_TAGS(auto_registered, "registry", "fast")
+{
+    ST_TRUE(st_clock_nsec() > 0);
+}
+ST_END_TEST_IMPL()
+
+/* a dataset shared by the tests that use it: built once, before the first of them
+ * runs, and freed after the last. */
+static void* make_squares(void)
+{
+    uint32_t* squares = calloc(1024, sizeof(uint32_t));
+    for (uint32_t n = 0; squares && n < 1024; n++) {
+        squares[n] = n * n;
+    }
+    return squares;
+}
+
+ST_DEFINE_FIXTURE(squares, make_squares, free)
+
+static uint32_t scratch[16];
+
+static bool clear_scratch(void)
+{
+    memset(scratch, 0, sizeof(scratch));
+    return true;
+}
+
+ST_TEST_WITH(squares_ascend, .suite = "fixtures", .fixtures = ST_FIXTURES(ST_FIXTURE(squares)))
+{
+    const uint32_t* squares = ST_FIXTURE_DATA(squares, uint32_t);
+    ST_TRUE(NULL != squares);
+    bool ascending = true;
+    for (size_t n = 1; squares && n < 1024; n++) {
+        ascending &= squares[n] > squares[n - 1];
+    }
+    ST_TRUE(ascending);
+}
+ST_END_TEST_IMPL()
+
+ST_TEST_WITH(squares_sum, .suite = "fixtures", .setup = clear_scratch,
+    .fixtures = ST_FIXTURES(ST_FIXTURE(squares)))
+{
+    const uint32_t* squares = ST_FIXTURE_DATA(squares, uint32_t);
+    ST_TRUE(NULL != squares);
+    for (size_t n = 0; squares && n < 16; n++) {
+        scratch[n] = squares[n] + squares[n];
+    }
+    ST_EQUAL(scratch[15], UINT32_C(450));
+}
+ST_END_TEST_IMPL()
+
+/* parameterized: one case for each element of a table. */
+typedef struct {
+    const char* text;
+    long value;
+} parse_case;
+
+static const parse_case parse_cases[] = {
+    {"0", 0}, {"42", 42}, {"-7", -7}, {"0x1f", 31}, {"017", 15}
+};
+
+ST_TEST_P(parses_numbers, ST_CASES_TABLE(parse_cases))
+{
+    const parse_case* pc = ST_CASE_DATA(parse_case);
+    ST_EQUAL(strtol(pc->text, NULL, 0), pc->value);
+}
+ST_END_TEST_IMPL()
+
+/* parameterized: cases produced on demand, with labels. */
+static bool powers_of_two(size_t index, st_case* out)
+{
+    static ST_THREAD_LOCAL char label[16];
+    if (index >= 16) {
+        return false;
+    }
+    (void)snprintf(label, sizeof(label), "2^%zu", index);
+    out->label = label;
+    return true;
+}
+
+ST_TEST_P(shifts_are_powers, ST_CASES_GENERATOR(powers_of_two))
+{
+    uint32_t value = UINT32_C(1) << ST_CASE()->index;
+    ST_EQUAL(value & (value - 1), UINT32_C(0));
+}
+ST_END_TEST_IMPL()
+
+/* parameterized: one case for each line of a data file (this file). */
+ST_TEST_WITH(source_lines, .suite = "cases", .cases = ST_CASES_FILE(__FILE__, '\n'))
+{
+    const char* line = ST_CASE_DATA(char);
+    ST_TRUE(ST_CASE()->size <= 100);
+    ST_TRUE(NULL == memchr(line, '\t', ST_CASE()->size));
+}
+ST_END_TEST_IMPL()
+
+/* property: cases are generated, and a failing case is shrunk to a minimal one. */
+ST_PROPERTY_EX(abs_is_non_negative, 10000)
+{
+    int64_t value = ST_GEN_INT(-INT32_MAX, INT32_MAX);
+    ST_TRUE(llabs(value) >= 0);
+
+    size_t len         = 0;
+    const int64_t* arr = ST_GEN_INT_ARRAY(len, 64, -1000, 1000);
+    int64_t sum        = 0;
+    for (size_t n = 0; n < len; n++) {
+        sum += arr[n];
+    }
+    ST_TRUE(llabs(sum) <= (int64_t)len * 1000);
+
+    const char* str = ST_GEN_STRING(32, "abc");
+    ST_TRUE(strspn(str, "abc") == strlen(str));
+}
+ST_END_TEST_IMPL()
+
+/* fails on purpose: a property falsified only by a warning. the counterexample should
+ * shrink to a single element of 100. */
+ST_PROPERTY(small_sums)
+{
+    size_t len         = 0;
+    const int64_t* arr = ST_GEN_INT_ARRAY(len, 16, 0, 1000);
+    int64_t sum        = 0;
+    for (size_t n = 0; n < len; n++) {
+        sum += arr[n];
+    }
+    ST_EXPECT(sum < 100);
+}
+ST_END_TEST_IMPL()
+
+/* fuzz target: each file in the corpus is a case, run in a child process. */
+ST_FUZZ_TARGET_EX(count_lines, ST_SANDBOX_CORPUS_DIR, data, size)
+{
+    size_t lines = 0;
+    for (size_t n = 0; n < size; n++) {
+        lines += '\n' == data[n];
+    }
+    ST_TRUE(lines <= size);
+}
+ST_END_TEST_IMPL()
+
+/* fails on purpose: a parser of 'key=value' with a planted bug. of its corpus, 'pair'
+ * passes, 'empty_key' fails an evaluator, and 'no_separator' crashes the child
+ * process (which ends only that case). */
+ST_FUZZ_TARGET_EX(parse_pair, ST_SANDBOX_FAILING_CORPUS_DIR, data, size)
+{
+    const uint8_t* sep = memchr(data, '=', size);
+#if !defined(__WIN__)
+    if (!sep) {
+        abort();
+    }
+#endif
+    ST_NOT_NULL(sep);
+    ST_TRUE(sep && sep > data);
+}
+ST_END_TEST_IMPL()
+
+/* fails on purpose: more failures than --max-failures prints by default, the rest of
+ * which are counted in the test's summary instead. */
+ST_TEST_TAGS(floods_the_log, "selftest", "fast")
+{
+    ST_MESSAGE("expecting the next %d to fail, %d of them silently",
+        ST_DEFAULT_MAX_FAILURES + 5, 5);
+    for (int n = 0; n < ST_DEFAULT_MAX_FAILURES + 5; n++) {
+        ST_EXPECT(n < 0);
+    }
+}
+ST_END_TEST_IMPL()
+
+#if !defined(__WIN__)
+/* fails on purpose: a hang in a child process, which is killed after 1 second. */
+ST_TEST_WITH(hangs_in_child, .isolate = true, .timeout = 1)
+{
+    while (true) {
+        st_sleep_msec(100);
+    }
+}
+ST_END_TEST_IMPL()
+#endif
+
+/* files are mapped and compared word by word; see also ST_SNAPSHOT_EQUAL. */
+ST_TEST_TAGS(file_matches_itself, "files", "fast")
+{
+    ST_FILE_EQUAL(__FILE__, __FILE__);
+}
+ST_END_TEST_IMPL()
+
+/* digest: output is fingerprinted chunk by chunk, rather than kept. */
+ST_TEST_TAGS(digest_of_stream, "digest", "fast")
+{
+    ST_DIGEST_BEGIN();
+    uint8_t chunk[4096];
+    for (size_t n = 0; n < 256; n++) {
+        for (size_t j = 0; j < sizeof(chunk); j++) {
+            chunk[j] = (uint8_t)((n * sizeof(chunk) + j) * 131);
+        }
+        ST_DIGEST_UPDATE(chunk, sizeof(chunk));
+    }
+    ST_DIGEST_EQUAL("a2751347c1419be8");
+    ST_DIGEST_EQUAL("d4ad269f");
+}
+ST_END_TEST_IMPL()
+
+/* spans: heap buffers are compared and searched by vector kernels; the benchmarks
+ * time them against the element loops of ST_ARRAY_EQUAL and ST_ARRAY_CONTAINS. */
+ST_TEST_TAGS(span_throughput, "span", "bench")
+{
+    size_t count  = 64 * 1024;
+    uint32_t* lhs = malloc(count * sizeof(uint32_t));
+    uint32_t* rhs = malloc(count * sizeof(uint32_t));
+    ST_TRUE(NULL != lhs && NULL != rhs);
+    ST_TEST_EXIT_IF_FAILED();
+
+    for (size_t n = 0; n < count; n++) {
+        lhs[n] = rhs[n] = (uint32_t)n;
+    }
+
+    ST_SPAN_EQUAL(lhs, count, rhs, count);
+    ST_SPAN_CONTAINS(lhs, count, count - 1);
+
+    // should succeed (values are compared as such: no uint32_t is -1)
+    ST_SPAN_NOT_CONTAINS(lhs, count, -1);
+
+    volatile size_t index = 0;
+    ST_BENCHMARK("element loop (equal), 2x256 KiB", 1000) {
+        size_t n = 0;
+        while (n < count && lhs[n] == rhs[n]) {
+            n++;
+        }
+        index = n;
+    }
+    ST_BENCHMARK("ST_SPAN_EQUAL, 2x256 KiB", 1000) {
+        ST_SPAN_EQUAL(lhs, count, rhs, count);
+    }
+    ST_BENCHMARK("element loop (contains), 256 KiB", 1000) {
+        size_t n = 0;
+        while (n < count && lhs[n] != UINT32_MAX) {
+            n++;
+        }
+        index = n;
+    }
+    ST_BENCHMARK("ST_SPAN_NOT_CONTAINS, 256 KiB", 1000) {
+        ST_SPAN_NOT_CONTAINS(lhs, count, UINT32_MAX);
+    }
+    ST_EQUAL(index, count);
+
+    free(lhs);
+    free(rhs);
+}
+ST_END_TEST_IMPL()
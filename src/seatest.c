@@ -28,42 +28,405 @@
 #if defined(__WIN__)
 # pragma comment(lib, "Shlwapi.lib")
 # pragma comment(lib, "Ws2_32.lib")
+#else
+# include <regex.h>
 #endif
 
 static st_state _state = {0};
+static ST_THREAD_LOCAL st_thread_state _tstate = {0};
+
+/** Guards the list of call sites with a cached pattern (_state.regex_sites). */
+static st_mutex _st_regex_lock = ST_MUTEX_INITIALIZER;
+
+/** The default XXH3 secret. */
+static const uint8_t _st_xxh3_secret[_ST_XXH_SECRET_SIZE] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+/** CRC32C lookup tables: slicing-by-8 for the software implementation, and the
+ * operators that append _ST_CRC32C_LONG and _SHORT zero bytes (see st_digest_begin). */
+static uint32_t _st_crc32c_table[8][256];
+#if defined(__HAVE_X86_DISPATCH__) && defined(__x86_64__)
+static uint32_t _st_crc32c_long[4][256];
+static uint32_t _st_crc32c_short[4][256];
+#endif
+
+static st_testres _st_run_test(st_test* test);
+static st_testres _st_run_test_once(st_test* test);
+static st_testres _st_run_cases(st_test* test);
+static st_testres _st_run_isolated(st_test* test, uint32_t timeout);
+#if !defined(__WIN__)
+static void _st_on_isolated_timeout(int sig);
+static bool _st_wait_isolated(pid_t pid, int* status, uint64_t deadline);
+static void _st_kill_isolated(const st_test* test, pid_t pid, uint32_t timeout);
+#endif
+static bool _st_next_corpus_file(st_case_iter* iter, st_case* out);
+static size_t _st_find_mismatch(const void* lhs, size_t lhs_size, const void* rhs,
+    size_t rhs_size);
+static size_t _st_diff_window(size_t offset);
+static void _st_print_mismatch(size_t offset, size_t base, const char* lhs_name,
+    const void* lhs, size_t lhs_size, const char* rhs_name, const void* rhs,
+    size_t rhs_size);
+static void _st_print_expected(size_t offset, const uint8_t* expected, const void* data,
+    size_t size);
+static size_t _st_find_byte_not(const void* ptr, size_t len, uint8_t byte);
+#if defined(__HAVE_X86_DISPATCH__)
+_ST_TARGET("sse2")
+static size_t _st_find_byte_not_sse2(const uint8_t* bytes, size_t len, uint8_t byte);
+_ST_TARGET("avx2")
+static size_t _st_find_byte_not_avx2(const uint8_t* bytes, size_t len, uint8_t byte);
+_ST_TARGET("avx512bw")
+static size_t _st_find_byte_not_avx512(const uint8_t* bytes, size_t len, uint8_t byte);
+#endif
+static size_t _st_find_char_not_in(const void* ptr, size_t len, const uint64_t set[4]);
+#if defined(__HAVE_X86_DISPATCH__)
+_ST_TARGET("ssse3")
+static size_t _st_find_char_not_in_ssse3(const uint8_t* bytes, size_t len,
+    const uint8_t rows[16]);
+_ST_TARGET("avx2")
+static size_t _st_find_char_not_in_avx2(const uint8_t* bytes, size_t len,
+    const uint8_t rows[16]);
+_ST_TARGET("avx512bw")
+static size_t _st_find_char_not_in_avx512(const uint8_t* bytes, size_t len,
+    const uint8_t rows[16]);
+#endif
+static size_t _st_find_non_ascii(const uint8_t* bytes, size_t len);
+#if defined(__HAVE_X86_DISPATCH__)
+_ST_TARGET("sse2")
+static size_t _st_find_non_ascii_sse2(const uint8_t* bytes, size_t len);
+_ST_TARGET("avx2")
+static size_t _st_find_non_ascii_avx2(const uint8_t* bytes, size_t len);
+_ST_TARGET("avx512bw")
+static size_t _st_find_non_ascii_avx512(const uint8_t* bytes, size_t len);
+#endif
+static size_t _st_find_mismatch_i(const void* lhs, size_t lhs_size, const void* rhs,
+    size_t rhs_size);
+#if defined(__HAVE_X86_DISPATCH__)
+_ST_TARGET("sse2")
+static size_t _st_mismatch_i_sse2(const uint8_t* lhs, const uint8_t* rhs, size_t size);
+_ST_TARGET("avx2")
+static size_t _st_mismatch_i_avx2(const uint8_t* lhs, const uint8_t* rhs, size_t size);
+_ST_TARGET("avx512bw")
+static size_t _st_mismatch_i_avx512(const uint8_t* lhs, const uint8_t* rhs, size_t size);
+#endif
+static size_t _st_search(const uint8_t* haystack, size_t haystack_len,
+    const uint8_t* needle, size_t needle_len, bool ignore_case);
+static size_t _st_find_pair(const uint8_t* bytes, size_t count, size_t gap, uint8_t first,
+    uint8_t last, bool ignore_case);
+#if defined(__HAVE_X86_DISPATCH__)
+_ST_TARGET("sse2")
+static size_t _st_find_pair_sse2(const uint8_t* bytes, size_t count, size_t gap,
+    uint8_t first, uint8_t last, bool ignore_case);
+_ST_TARGET("avx2")
+static size_t _st_find_pair_avx2(const uint8_t* bytes, size_t count, size_t gap,
+    uint8_t first, uint8_t last, bool ignore_case);
+_ST_TARGET("avx512bw")
+static size_t _st_find_pair_avx512(const uint8_t* bytes, size_t count, size_t gap,
+    uint8_t first, uint8_t last, bool ignore_case);
+#endif
+static size_t _st_two_way(const uint8_t* haystack, size_t haystack_len,
+    const uint8_t* needle, size_t needle_len, bool ignore_case);
+static bool _st_check_bufs(const char* lhs_name, const void* lhs, size_t lhs_len,
+    const char* rhs_name, const void* rhs, size_t rhs_len);
+static bool _st_elem_near(double lhs, double rhs, double abs_tol, uint64_t max_ulps,
+    bool single, uint64_t* ulps);
+static uint64_t _st_ulp_distance(double lhs, double rhs, bool single);
+static double _st_read_real(const void* elem, size_t elem_size);
+static size_t _st_find_not_near(const void* lhs, const void* rhs, size_t count,
+    size_t elem_size, double abs_tol, uint64_t max_ulps);
+#if defined(__HAVE_X86_DISPATCH__)
+_ST_TARGET("avx2")
+static size_t _st_find_not_near_f64_avx2(const double* lhs, const double* rhs, size_t count,
+    double abs_tol, uint64_t max_ulps);
+_ST_TARGET("avx2")
+static size_t _st_find_not_near_f32_avx2(const float* lhs, const float* rhs, size_t count,
+    float abs_tol, uint64_t max_ulps);
+_ST_TARGET("avx512f")
+static size_t _st_find_not_near_f64_avx512(const double* lhs, const double* rhs,
+    size_t count, double abs_tol, uint64_t max_ulps);
+_ST_TARGET("avx512f")
+static size_t _st_find_not_near_f32_avx512(const float* lhs, const float* rhs,
+    size_t count, float abs_tol, uint64_t max_ulps);
+#endif
+static const char* _st_format_ulps(uint64_t ulps, char str[ST_MAX_VALUE_STR_LEN]);
+#if !defined(__WIN__)
+static bool _st_regex_exec(st_regex_site* site, const char* str, const char* pattern,
+    regmatch_t* match, bool* matched);
+static bool _st_regex_compile(regex_t* re, const char* pattern);
+#endif
+static void _st_regex_free_sites(void);
+static size_t _st_find_utf8_invalid(const uint8_t* bytes, size_t len);
+static size_t _st_utf8_seq_len(const uint8_t* seq, size_t avail);
+static const char* _st_format_char(uint8_t c, char str[8]);
+static bool _st_snapshot_path(const char* name, char path[ST_MAX_SNAPSHOT_PATH_LEN]);
+static bool _st_write_snapshot(const char* path, const void* data, size_t size);
+static bool _st_make_parent_dirs(const char* path);
+static bool _st_file_exists(const char* path);
+static void _st_scratch_release(st_scratch* scratch, const st_scratch* mark);
+static void _st_scratch_reset(st_scratch* scratch);
+static void _st_scratch_free(st_scratch* scratch);
+static bool _st_elem_table_init(st_elem_table* table, const void* elems, size_t count,
+    size_t elem_size, int kind);
+static st_elem_slot* _st_elem_table_find(const st_elem_table* table, const void* elem);
+static uint64_t _st_hash_elem(const void* elem, size_t size);
+static uint64_t _st_hash_real(const void* elem, size_t size);
+static st_value _st_read_value(const void* elem, size_t size, int kind);
+static bool _st_values_equal(const st_value* lhs, const st_value* rhs);
+static long double _st_value_to_real(const st_value* value);
+static bool _st_value_to_int(const st_value* value, int kind, size_t size, uint8_t* pattern);
+static const char* _st_format_value(const st_value* value, char buf[ST_MAX_VALUE_STR_LEN]);
+static const char* _st_format_elem(const void* elem, size_t size, int kind,
+    char buf[ST_MAX_VALUE_STR_LEN]);
+static size_t _st_span_find(const void* span, size_t count, size_t elem_size, int kind,
+    const st_value* value);
+static size_t _st_find_elem(const void* elems, size_t count, size_t elem_size,
+    const uint8_t* pattern);
+#if defined(__HAVE_X86_DISPATCH__)
+_ST_TARGET("sse2")
+static size_t _st_mismatch_sse2(const uint8_t* lhs, const uint8_t* rhs, size_t size);
+_ST_TARGET("avx2")
+static size_t _st_mismatch_avx2(const uint8_t* lhs, const uint8_t* rhs, size_t size);
+_ST_TARGET("avx512bw")
+static size_t _st_mismatch_avx512(const uint8_t* lhs, const uint8_t* rhs, size_t size);
+_ST_TARGET("sse2")
+static __m128i _st_cmpeq_sse2(__m128i lhs, __m128i rhs, size_t elem_size);
+_ST_TARGET("sse2")
+static size_t _st_find_elem_sse2(const uint8_t* elems, size_t size, size_t elem_size,
+    const uint8_t* pattern);
+_ST_TARGET("avx2")
+static __m256i _st_cmpeq_avx2(__m256i lhs, __m256i rhs, size_t elem_size);
+_ST_TARGET("avx2")
+static size_t _st_find_elem_avx2(const uint8_t* elems, size_t size, size_t elem_size,
+    const uint8_t* pattern);
+_ST_TARGET("avx512bw")
+static __mmask64 _st_cmpeq_avx512(__m512i lhs, __m512i rhs, size_t elem_size);
+_ST_TARGET("avx512bw")
+static size_t _st_find_elem_avx512(const uint8_t* elems, size_t size, size_t elem_size,
+    const uint8_t* pattern);
+#endif
+static uint64_t _st_read64le(const uint8_t* ptr);
+static uint32_t _st_read32le(const uint8_t* ptr);
+static uint64_t _st_bswap64(uint64_t value);
+static uint64_t _st_mul128_fold64(uint64_t lhs, uint64_t rhs);
+static uint64_t _st_xxh3_avalanche(uint64_t hash);
+static uint64_t _st_xxh64_avalanche(uint64_t hash);
+static uint64_t _st_xxh3_mix16(const uint8_t* input, const uint8_t* secret);
+static uint64_t _st_xxh3_short(const uint8_t* input, size_t len);
+static void _st_xxh3_consume(st_digest* digest, const uint8_t* input, size_t stripes);
+static void _st_xxh3_accumulate(uint64_t* acc, const uint8_t* input, const uint8_t* secret,
+    size_t stripes);
+static void _st_xxh3_scramble(uint64_t* acc, const uint8_t* secret);
+static void _st_crc32c_init(void);
+static uint32_t _st_crc32c_update(uint32_t crc, const uint8_t* data, size_t size);
+#if defined(__HAVE_X86_DISPATCH__)
+_ST_TARGET("avx2")
+static void _st_xxh3_accumulate_avx2(uint64_t* acc, const uint8_t* input,
+    const uint8_t* secret, size_t stripes);
+# if defined(__x86_64__)
+_ST_TARGET("sse4.2")
+static uint32_t _st_crc32c_sse42(uint32_t crc, const uint8_t* data, size_t size);
+static uint32_t _st_gf2_times(const uint32_t* mat, uint32_t vec);
+static void _st_crc32c_zeros(uint32_t zeros[4][256], size_t len);
+static uint32_t _st_crc32c_shift(uint32_t zeros[4][256], uint32_t crc);
+# endif
+#endif
+static st_test* _st_find_test_or_case(const char* name, st_test* tests, size_t num_tests,
+    const char** case_name);
+static bool _st_select_test(st_test* test, const char* case_name, size_t* to_run);
+static void _st_run_test_repeatedly(st_test* test, uint32_t repeat, bool until_fail,
+    double* samples, size_t max_samples);
+static void _st_print_repeat_stats(const st_test* test);
+static void _st_retry_test(st_test* test, uint32_t retries);
+static void _st_print_flagged_tests(const st_test* tests, size_t num_tests,
+    bool (*flagged)(const st_test*), const char* title);
+static int _st_main(int argc, char** argv, const char* app_name, const st_cl_arg* args,
+    size_t num_args, st_test* tests, size_t num_tests);
+static bool _st_for_each_line(const char* path, bool (*fn)(char*, void*), void* ctx);
+static bool _st_only_line(char* line, void* ctx);
+static bool _st_add_filter(st_cl_config* config, const char* pattern);
+static bool _st_filter_match(const st_filter* filter, const char* name);
+static const char* _st_next_tag(const char* str, size_t* len);
+static bool _st_test_has_tag(const st_test* test, const char* tag);
+static bool _st_intern_tag(st_tag_table* table, const st_test* test, const char* tag,
+    size_t len, bool suite, st_tagset* tagset);
+static void _st_print_test_group(const st_test* tests, size_t num_tests,
+    const char* group, bool (*member)(const st_test*, const char*));
+static bool _st_test_in_suite(const st_test* test, const char* suite);
+static void _st_count_fixture_refs(const st_cl_config* config, st_test* tests,
+    size_t num_tests);
+static void _st_destroy_fixtures(st_test* tests, size_t num_tests);
+static void _st_destroy_fixture(st_fixture* fixture);
+static bool _st_test_passed(const st_test* test);
+static bool _st_test_timed_out(const st_test* test);
+static st_testres _st_call_test_fn(st_test* test, uint32_t timeout);
+static bool _st_watchdog_start(const st_test* tests, size_t num_tests);
+static void _st_watchdog_stop(void);
+static void _st_watchdog_arm(const st_test* test, uint32_t timeout);
+static bool _st_watchdog_disarm(void);
+static void _st_watchdog_lock(void);
+static void _st_watchdog_unlock(void);
+static void _st_watchdog_signal(void);
+static void _st_watchdog_wait(uint64_t nsec);
+static void _st_watchdog_fire(void);
+static void _st_watchdog_print(const char* str, size_t len);
+static bool _st_apply_journal(const char* path, st_cl_config* config, st_test* tests,
+    size_t num_tests);
+static void _st_print_sections(const st_test* test);
+static bool _st_parse_cl_uint(int argc, char** argv, int* n, const char* flag,
+    uint64_t max, uint64_t* out);
+static const char* _st_format_nsec(double nsec, char buf[ST_MAX_DURATION_STR_LEN]);
+static void _st_benchmark_report(st_benchmark* bench, uint64_t elapsed);
+static bool _st_prop_init(st_prop* prop);
+static void _st_prop_free(st_prop* prop);
+static void _st_prop_reset(st_prop* prop, size_t num_choices, bool replay);
+static bool _st_prop_try(st_prop* prop, st_test_fn body, size_t num_choices);
+static bool _st_prop_simpler(const uint64_t* lhs, size_t num_lhs, const uint64_t* rhs,
+    size_t num_rhs);
+static size_t _st_prop_shrink(st_prop* prop, st_test_fn body);
+static uint64_t _st_prop_choose(st_rng* rng, uint64_t max);
+static uint64_t _st_rng_bounded(st_rng* rng, uint64_t max);
+static int64_t _st_gen_int(int64_t lo, int64_t hi);
+static uint64_t _st_prop_draw(uint64_t max, const uint64_t* forced);
+static void* _st_prop_reserve(size_t elem_size, size_t extra, size_t* max_len);
+static bool _st_prop_more(size_t len, size_t max_len, size_t target);
+static size_t _st_prop_target_len(size_t max_len);
 
 int st_main(int argc, char** argv, const char* app_name, const st_cl_arg* args,
     size_t num_args, st_test* tests, size_t num_tests)
 {
-    if (!st_validate_config(app_name, tests, num_tests)) {
+    if (!st_validate_config(app_name, tests, num_tests) ||
+        !st_index_tests(&_state.index, tests, num_tests)) {
         return EXIT_FAILURE;
     }
 
-    _state.app_name = app_name;
+    _state.app_name     = app_name;
+    _state.bench_warmup = ST_BENCH_WARMUP_MAX;
+    _state.timeout      = ST_DEFAULT_TIMEOUT_SEC;
+    _state.max_failures = ST_DEFAULT_MAX_FAILURES;
+    _state.seed         = st_clock_nsec() ^ ((uint64_t)time(NULL) << 32);
+
+    int retval = _st_main(argc, argv, app_name, args, num_args, tests, num_tests);
+    st_free_test_index(&_state.index);
+    _st_prop_free(&_tstate.prop);
+    _st_scratch_free(&_tstate.scratch);
+    _st_regex_free_sites();
+    return retval;
+}
 
+static int _st_main(int argc, char** argv, const char* app_name, const st_cl_arg* args,
+    size_t num_args, st_test* tests, size_t num_tests)
+{
     st_cl_config cl_cfg = {0};
     if (!st_parse_cmd_line(argc, argv, args, num_args, tests, num_tests, &cl_cfg) ||
-        !st_prepare_tests(tests, num_tests)) {
+        !st_apply_filters(&cl_cfg, tests, num_tests) ||
+        !st_select_tagged(&cl_cfg, tests, num_tests)) {
+        st_free_filters(&cl_cfg);
+        return EXIT_FAILURE;
+    }
+
+    char journal_path[ST_MAX_JOURNAL_PATH_LEN] = {0};
+    if (cl_cfg.journal) {
+        (void)snprintf(journal_path, sizeof(journal_path), "%s", cl_cfg.journal);
+    } else {
+        (void)snprintf(journal_path, sizeof(journal_path), ST_JOURNAL_FILE, app_name);
+    }
+
+    if ((cl_cfg.rerun_failed || cl_cfg.resume) &&
+        !_st_apply_journal(journal_path, &cl_cfg, tests, num_tests)) {
+        return EXIT_FAILURE;
+    }
+
+    if (cl_cfg.rerun_failed && 0 == cl_cfg.to_run) {
+        _ST_WARNING("%s "ST_LOC_NO_FAILED, _ST_WARN_PREFIX);
+        return EXIT_SUCCESS;
+    }
+
+    if (!st_prepare_tests(tests, num_tests)) {
         return EXIT_FAILURE;
     }
 
+    if (cl_cfg.pin && !st_pin_thread_to_cpu(cl_cfg.cpu)) {
+        _ST_WARNING("%s "ST_LOC_PIN_FAILED, _ST_WARN_PREFIX, cl_cfg.cpu);
+    }
+
+    if (cl_cfg.until_fail && cl_cfg.repeat == 0U) {
+        cl_cfg.repeat = ST_REPEAT_UNTIL_FAIL_MAX;
+    }
+
+    double* samples = NULL;
+    size_t max_samples = cl_cfg.repeat < ST_REPEAT_MAX_SAMPLES ? cl_cfg.repeat :
+        ST_REPEAT_MAX_SAMPLES;
+    if (cl_cfg.repeat > 1U) {
+        samples = calloc(max_samples, sizeof(double));
+        if (!samples) {
+            _ST_REPORT_ERROR(errno);
+            return EXIT_FAILURE;
+        }
+    }
+
     size_t to_run = cl_cfg.only ? cl_cfg.to_run : num_tests;
     size_t passed = 0;
+    size_t num = 0;
+
+    _st_count_fixture_refs(&cl_cfg, tests, num_tests);
+
+    st_journal journal = {0};
+    if (!cl_cfg.no_journal && !st_journal_open(&journal, journal_path, tests, num_tests)) {
+        _ST_WARNING("%s "ST_LOC_JOURNAL_ERR, _ST_WARN_PREFIX, journal_path,
+            ST_LOC_RSM_FLAG, ST_LOC_RRF_FLAG);
+    }
+
+    if (!_st_watchdog_start(tests, num_tests)) {
+        _ST_WARNING("%s "ST_LOC_NO_WATCHDOG, _ST_WARN_PREFIX);
+    }
 
     st_print_intro(to_run);
 
     st_timer timer;
     st_timer_begin(&timer);
 
-    for (size_t n = 0; n < to_run; n++) {
+    for (size_t n = 0; n < num_tests; n++) {
         if (cl_cfg.only && !tests[n].run) {
             continue;
         }
+
+        num++;
+        if (tests[n].resumed) {
+            /* completed by the previous run; only its result is merged. */
+            if (_st_test_passed(&tests[n])) {
+                passed++;
+            }
+            continue;
+        }
+
         double started_at = st_timer_elapsed(&timer);
-        st_print_test_intro(n + 1, to_run, tests[n].name);
+        st_print_test_intro(num, to_run, tests[n].name);
 
         if (!tests[n].res.skip) {
-            tests[n].res = tests[n].fn();
+            if (!st_acquire_fixtures(&tests[n])) {
+                tests[n].res.errors = 1;
+                tests[n].res.fatal  = true;
+            } else if (samples) {
+                _st_run_test_repeatedly(&tests[n], cl_cfg.repeat, cl_cfg.until_fail,
+                    samples, max_samples);
+            } else {
+                tests[n].res = _st_run_test(&tests[n]);
+                tests[n].attempts = 1U;
+                if (tests[n].res.fatal && cl_cfg.retries > 0U) {
+                    _st_retry_test(&tests[n], cl_cfg.retries);
+                }
+            }
         } else {
             char conds[ST_MAX_MULTIPLE_COND_STR_LEN] = {0};
             _ST_SKIPPED(ST_LOC_INDENT ST_LOC_SKIPPED_UNMET": %s",
@@ -71,18 +434,28 @@ int st_main(int argc, char** argv, const char* app_name, const st_cl_arg* args,
                 _st_conds_to_string(tests[n].res.skip_conds, conds));
         }
 
-        tests[n].msec = st_timer_elapsed(&timer) - started_at;
-        st_print_test_outro(n + 1, to_run, tests[n].name, &tests[n]);
+        /* fixture construction is reported separately. */
+        tests[n].msec = st_timer_elapsed(&timer) - started_at - tests[n].fixture_msec;
+        st_print_test_outro(num, to_run, tests[n].name, &tests[n]);
+        st_journal_record(&journal, &tests[n]);
+        st_release_fixtures(&tests[n]);
 
-        if (tests[n].res.pass || !tests[n].res.fatal || tests[n].res.skip) {
+        if (_st_test_passed(&tests[n])) {
             passed++;
         } else if (_state.fail_early) {
             _ST_WARNING("%s '%s' "ST_LOC_FAIL_EARLY, _ST_WARN_PREFIX, tests[n].name,
                 EXIT_FAILURE, ST_LOC_FAIL_FLAG);
+            st_journal_close(&journal, false);
+            _st_destroy_fixtures(tests, num_tests);
+            _st_watchdog_stop();
+            _st_safefree(&samples);
             return EXIT_FAILURE;
         }
     }
 
+    st_journal_close(&journal, true);
+    _st_watchdog_stop();
+    _st_safefree(&samples);
     st_print_test_summary(passed, to_run, tests, num_tests, st_timer_elapsed(&timer));
 
     if (cl_cfg.wait) {
@@ -92,6 +465,50 @@ int st_main(int argc, char** argv, const char* app_name, const st_cl_arg* args,
     return passed == to_run ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
+int st_main_ex(int argc, char** argv, const char* app_name, const st_cl_arg* args,
+    size_t num_args, st_test* tests, size_t num_tests, const st_test_reg* const* reg_begin,
+    const st_test_reg* const* reg_end)
+{
+    size_t num_reg = 0;
+    for (const st_test_reg* const* reg = reg_begin; reg && reg < reg_end; reg++) {
+        if (*reg) {
+            num_reg++;
+        }
+    }
+
+    if (0 == num_reg) {
+        return st_main(argc, argv, app_name, args, num_args, tests, num_tests);
+    }
+
+    /* the list of tests (if any) comes first, in declaration order, followed by
+     * registered tests in link order. */
+    st_test* all = calloc(num_tests + num_reg, sizeof(st_test));
+    if (!all) {
+        _ST_REPORT_ERROR(errno);
+        return EXIT_FAILURE;
+    }
+
+    if (num_tests > 0) {
+        (void)memcpy(all, tests, num_tests * sizeof(st_test));
+    }
+
+    size_t n = num_tests;
+    for (const st_test_reg* const* reg = reg_begin; reg < reg_end; reg++) {
+        if (*reg) {
+            st_test test = {.name = (*reg)->name, .fn = (*reg)->fn,
+                .conds = (*reg)->conds, .timeout = (*reg)->timeout,
+                .suite = (*reg)->suite, .tags = (*reg)->tags, .setup = (*reg)->setup,
+                .teardown = (*reg)->teardown, .fixtures = (*reg)->fixtures,
+                .cases = (*reg)->cases, .isolate = (*reg)->isolate};
+            (void)memcpy(&all[n++], &test, sizeof(st_test));
+        }
+    }
+
+    int retval = st_main(argc, argv, app_name, args, num_args, all, n);
+    _st_safefree(&all);
+    return retval;
+}
+
 bool st_validate_config(const char* app_name, const st_test* tests, size_t num_tests)
 {
     /* before doing any other work, ensure that the test configuration is sane. */
@@ -106,6 +523,12 @@ bool st_validate_config(const char* app_name, const st_test* tests, size_t num_t
         errors++;
     }
 
+    /* tests. */
+    if (!tests || 0 == num_tests) {
+        _ST_ERROR("%s "ST_LOC_NO_TESTS, _ST_ERROR_PREFIX);
+        errors++;
+    }
+
     for (size_t n = 0; n < num_tests; n++) {
         /* spaces in test names. */
         if (st_strchr(tests[n].name, ' ') != NULL) {
@@ -164,7 +587,7 @@ bool st_prepare_tests(st_test* tests, size_t num_tests)
     for (size_t n = 0; n < num_tests; n++) {
         _ST_DEBUG("test #%zu (name: '%s') has conds %08x", n + 1, tests[n].name,
             tests[n].conds);
-        if (tests[n].conds != 0) {
+        if (tests[n].conds != 0 && !tests[n].resumed) {
             bool skip = false;
             _ST_PROCESS_TEST_CONDITION(cond_disk, COND_DISK);
             _ST_PROCESS_TEST_CONDITION(cond_inet, COND_INET);
@@ -238,15 +661,66 @@ void st_print_test_outro(size_t num, size_t to_run, const char* name, const st_t
         WHITE(" [%s"ST_LOC_MSEC_ABV"]") WHITEB(":") " %s", num, to_run, name,
         (msec_str ? msec_str : ST_LOC_MSEC_ZERO), _ST_SKIP_PASS_FAIL(test));
 
+    if (test->flaky) {
+        (void)printf(DGRAY(" ("ST_LOC_PASSED_ON" "ST_LOC_ATTEMPT" %"PRIu32")"),
+            test->attempts);
+    } else if (test->attempts > 1U) {
+        (void)printf(DGRAY(" ("ST_LOC_FAILED_L" %"PRIu32" %s)"), test->attempts,
+            _ST_PLURAL(ST_LOC_ATTEMPT, test->attempts));
+    }
+
+    if (test->quarantined) {
+        (void)printf(" " DGRAY(ST_LOC_QUARANTINED));
+    }
+
+    if (test->cases) {
+        (void)printf(DGRAY(" (%zu %s, %zu "ST_LOC_FAILED_L")"), test->num_cases,
+            _ST_PLURAL(ST_LOC_CASE, test->num_cases), test->failed_cases);
+    }
+
+    if (test->fixture_msec > 0.0) {
+        char fixt[ST_MAX_DURATION_STR_LEN] = {0};
+        (void)printf(DGRAY(" (+%s "ST_LOC_FIXTURES")"),
+            _st_format_nsec(test->fixture_msec * 1e6, fixt));
+    }
+
     (void)printf(test->res.errors > 0 ?
         FG_COLOR(0, 196, "%s%s\n") : FG_COLOR(0, 208, "%s%s\n"),
         (warn_str ? warn_str : ""), (err_str ? err_str : ""));
 
+    _st_print_repeat_stats(test);
+    _st_print_sections(test);
+
+    if (test->noisy_benchmarks > 0) {
+        _ST_WARNING(ST_LOC_INDENT"%d %s", test->noisy_benchmarks,
+            _ST_PLURAL(ST_LOC_NOISY_BENCH, test->noisy_benchmarks));
+    }
+
+    if (test->suppressed > 0) {
+        _ST_WARNING(ST_LOC_INDENT ST_LOC_SUPPRESSED, test->suppressed,
+            _ST_PLURAL(ST_LOC_FAILURE, test->suppressed), ST_LOC_MAXF_FLAG);
+    }
+
     _st_safefree(&msec_str);
     _st_safefree(&warn_str);
     _st_safefree(&err_str);
 }
 
+static bool _st_test_is_flaky(const st_test* test)
+{
+    return test->flaky;
+}
+
+static bool _st_test_is_quarantined_failure(const st_test* test)
+{
+    return test->quarantined && test->res.fatal;
+}
+
+static bool _st_test_is_unstable(const st_test* test)
+{
+    return test->stats.unstable;
+}
+
 void st_print_test_summary(size_t passed, size_t to_run, const st_test* tests,
     size_t num_tests, double elapsed)
 {
@@ -266,12 +740,18 @@ void st_print_test_summary(size_t passed, size_t to_run, const st_test* tests,
     if (passed != to_run) {
         st_print_failed_test_intro(passed, to_run);
         for (size_t t = 0; t < num_tests; t++) {
-            if (!tests[t].res.pass && tests[t].res.fatal) {
+            if (!tests[t].res.pass && tests[t].res.fatal && !tests[t].quarantined) {
                 st_print_failed_test(tests[t].name);
             }
         }
         (void)printf("\n");
     }
+
+    _st_print_flagged_tests(tests, num_tests, &_st_test_timed_out, ST_LOC_TIMED_OUT_T);
+    _st_print_flagged_tests(tests, num_tests, &_st_test_is_flaky, ST_LOC_FLAKY_T);
+    _st_print_flagged_tests(tests, num_tests, &_st_test_is_quarantined_failure,
+        ST_LOC_QUARANTINED_T);
+    _st_print_flagged_tests(tests, num_tests, &_st_test_is_unstable, ST_LOC_UNSTABLE_T);
 }
 
 void st_print_failed_test_intro(size_t passed, size_t to_run)
@@ -286,492 +766,6698 @@ void st_print_failed_test(const char* const name)
 
 bool st_mark_test_to_run(const char* const name, st_test* tests, size_t num_tests)
 {
+    const char* case_name = NULL;
+    st_test* test = _st_find_test_or_case(name, tests, num_tests, &case_name);
+    size_t to_run = 0;
+    return test && _st_select_test(test, case_name, &to_run);
+}
+
+bool st_index_tests(st_test_index* index, const st_test* tests, size_t num_tests)
+{
+    /* open addressing with linear probing, at most half full. */
+    size_t capacity = 16;
+    while (capacity < num_tests * 2) {
+        capacity *= 2;
+    }
+
+    index->slots = calloc(capacity, sizeof(size_t));
+    if (!index->slots) {
+        _ST_REPORT_ERROR(errno);
+        return false;
+    }
+
+    index->tests = tests;
+    index->mask  = capacity - 1;
+
+    int errors = 0;
     for (size_t n = 0; n < num_tests; n++) {
-        size_t name_len = strnlen(tests[n].name, ST_MAX_TEST_NAME_STR_LEN);
-        if (0 == st_strncmp(name, tests[n].name, name_len)) {
-            tests[n].run = true;
-            return true;
+        size_t slot = (size_t)st_hash_str(tests[n].name) & index->mask;
+        while (index->slots[slot] != 0) {
+            if (0 == strcmp(tests[index->slots[slot] - 1].name, tests[n].name)) {
+                _ST_ERROR("%s "ST_LOC_TEST" #%zu ("ST_LOC_NAME": '%s') "ST_LOC_DUP_NAME,
+                    _ST_ERROR_PREFIX, n + 1, tests[n].name);
+                errors++;
+                break;
+            }
+            slot = (slot + 1) & index->mask;
+        }
+        if (0 == index->slots[slot]) {
+            index->slots[slot] = n + 1;
         }
     }
-    return false;
+
+    if (errors > 0) {
+        _ST_ERROR("%s "ST_LOC_RECTIFY, _ST_ERROR_PREFIX, _ST_PLURAL(ST_LOC_ERROR, errors));
+        st_free_test_index(index);
+        return false;
+    }
+
+    return true;
 }
 
-void st_print_test_list(const st_test* tests, size_t num_tests)
+void st_free_test_index(st_test_index* index)
 {
-    static const size_t tab_size = 4;
+    _st_safefree(&index->slots);
+    index->tests = NULL;
+    index->mask  = 0;
+}
+
+st_test* st_find_test(const char* name, st_test* tests, size_t num_tests)
+{
+    const st_test_index* index = &_state.index;
+    if (index->slots && index->tests == tests) {
+        size_t slot = (size_t)st_hash_str(name) & index->mask;
+        while (index->slots[slot] != 0) {
+            st_test* test = &tests[index->slots[slot] - 1];
+            if (0 == strcmp(test->name, name)) {
+                return test;
+            }
+            slot = (slot + 1) & index->mask;
+        }
+        return NULL;
+    }
 
-    size_t longest = 0;
     for (size_t n = 0; n < num_tests; n++) {
-        size_t len = strnlen(tests[n].name, ST_MAX_TEST_NAME_STR_LEN);
-        if (len > longest)
-            longest = len;
+        if (0 == strcmp(tests[n].name, name)) {
+            return &tests[n];
+        }
     }
+    return NULL;
+}
 
-    (void)printf("\n" WHITE(ST_LOC_AVAIL_TESTS":") "\n\n");
+uint64_t st_hash_str(const char* str)
+{
+    /* FNV-1a. */
+    uint64_t hash = UINT64_C(14695981039346656037);
+    for (const unsigned char* p = (const unsigned char*)str; *p; p++) {
+        hash ^= *p;
+        hash *= UINT64_C(1099511628211);
+    }
+    return hash;
+}
 
-    for (size_t n = 0; n < num_tests; n++) {
-        (void)printf("\t%s", tests[n].name);
+bool st_glob_match(const char* pattern, const char* str)
+{
+    /* '*' matches any run of characters, '?' any one, and [a-z] (or [!a-z]) any one
+     * in (or not in) the set. on a mismatch, backtrack to the last '*'. */
+    const char* star_p = NULL;
+    const char* star_s = NULL;
 
-        size_t len = strnlen(tests[n].name, ST_MAX_TEST_NAME_STR_LEN);
-        if (len < longest + tab_size) {
-            for (size_t j = len; j < longest + tab_size; j++)
-                (void)printf(" ");
+    while (*str) {
+        if (*pattern == '*') {
+            star_p = ++pattern;
+            star_s = str;
+            continue;
         }
 
-        if ((n % 2) != 0 || n == num_tests - 1)
-            (void)printf("\n");
+        bool match = false;
+        const char* next = pattern + 1;
+        if (*pattern == '?') {
+            match = true;
+        } else if (*pattern == '[') {
+            const char* p = pattern + 1;
+            bool negate = *p == '!';
+            if (negate) {
+                p++;
+            }
+            bool in_set = false;
+            while (*p && (*p != ']' || p == pattern + 1 + (negate ? 1 : 0))) {
+                if (p[1] == '-' && p[2] && p[2] != ']') {
+                    in_set |= *str >= p[0] && *str <= p[2];
+                    p += 3;
+                } else {
+                    in_set |= *str == *p++;
+                }
+            }
+            if (*p == ']') {
+                match = in_set != negate;
+                next  = p + 1;
+            } else {
+                match = *str == '['; /* unterminated; literal '['. */
+            }
+        } else {
+            match = *pattern == *str;
+        }
+
+        if (match && *pattern) {
+            pattern = next;
+            str++;
+        } else if (star_p) {
+            pattern = star_p;
+            str     = ++star_s;
+        } else {
+            return false;
+        }
     }
 
-    (void)printf("\n");
+    while (*pattern == '*') {
+        pattern++;
+    }
+    return *pattern == '\0';
 }
 
-void st_print_usage_info(const st_cl_arg* args, size_t num_args)
+bool st_apply_filters(st_cl_config* config, st_test* tests, size_t num_tests)
 {
-    size_t longest = 0;
-    for (size_t n = 0; n < num_args; n++) {
-        size_t len = strnlen(args[n].flag, ST_MAX_CLI_FLAG_STR_LEN) +
-            strnlen(args[n].s_flag, ST_MAX_CLI_S_FLAG_STR_LEN);
-        if (len > longest) {
-            longest = len;
-        }
+    if (0 == config->num_filters) {
+        return true;
     }
 
-    (void)fprintf(stderr, "\n" WHITE(ST_LOC_USAGE":") "\n\n");
-
-    for (size_t n = 0; n < num_args; n++) {
-        (void)fprintf(stderr, "\t%s, %s  ", args[n].s_flag, args[n].flag);
+    /* selected if named by --only (when given), matching any positive pattern (if
+     * there are any), and matching no negative pattern. */
+    bool have_positive = false;
+    for (size_t f = 0; f < config->num_filters; f++) {
+        have_positive |= !config->filters[f].negate;
+    }
 
-        size_t len = strnlen(args[n].flag, ST_MAX_CLI_FLAG_STR_LEN) +
-            strnlen(args[n].s_flag, ST_MAX_CLI_S_FLAG_STR_LEN);
-        if (len < longest) {
-            for (size_t j = len; j < longest; j++) {
-                (void)fprintf(stderr, " ");
+    config->to_run = 0;
+    for (size_t n = 0; n < num_tests; n++) {
+        bool positive = !have_positive;
+        bool negative = false;
+        for (size_t f = 0; f < config->num_filters; f++) {
+            if (_st_filter_match(&config->filters[f], tests[n].name)) {
+                if (config->filters[f].negate) {
+                    negative = true;
+                    break;
+                }
+                positive = true;
             }
         }
+        tests[n].run = (!config->only || tests[n].run) && positive && !negative;
+        if (tests[n].run) {
+            config->to_run++;
+        }
+    }
 
-        (void)fprintf(stderr, "%s%s%s\n", args[n].usage,
-            args[n].usage[0] != '\0' ? " " : "", args[n].desc);
+    config->only = true;
+    st_free_filters(config);
+
+    if (0 == config->to_run) {
+        _ST_ERROR("%s "ST_LOC_NO_MATCH, _ST_ERROR_PREFIX);
+        return false;
     }
 
-    (void)fprintf(stderr, "\n");
+    return true;
 }
 
-void st_print_version_info(void)
+void st_free_filters(st_cl_config* config)
 {
-    (void)printf("\n" ULINE("%s") " "ST_LOC_TEST_SUITE" " EMPH("("ST_LOC_BUILT_WITH)
-        " ", _state.app_name);
-    st_print_seatest_ansi(false);
-    (void)printf(EMPH("%s)")" \n\n", st_get_version_string());
+#if !defined(__WIN__)
+    for (size_t f = 0; f < config->num_filters; f++) {
+        if (config->filters[f].regex) {
+            regfree(config->filters[f].re);
+            _st_safefree(&config->filters[f].re);
+        }
+    }
+#endif
+    _st_safefree(&config->filters);
+    config->num_filters = 0;
 }
 
-void st_print_seatest_ansi(bool bold)
-{
-    static const struct {
-        unsigned char r;
-        unsigned char g;
-        unsigned char b;
-        char c;
-    } elements[] = {
-        { 65, 105, 238, 's'},
-        { 63, 125, 238, 'e'},
-        { 71, 145, 237, 'a'},
-        { 74, 165, 236, 't'},
-        { 77, 185, 235, 'e'},
-        { 80, 205, 234, 's'},
-        { 83, 225, 233, 't'},
-    };
+typedef struct {
+    const char* path;
+    st_test* tests;
+    size_t num_tests;
+} _st_quarantine_ctx;
 
-    for (size_t n = 0; n <_ST_COUNTOF(elements); n++) {
-        (void)printf("\x1b[%d;38;2;%03d;%03d;%03d;49;2m%c\x1b[0m", bold ? 1 : 0,
-            elements[n].r, elements[n].g, elements[n].b, elements[n].c);
+static bool _st_quarantine_line(char* line, void* ctx)
+{
+    _st_quarantine_ctx* qctx = (_st_quarantine_ctx*)ctx;
+    st_test* test = st_find_test(line, qctx->tests, qctx->num_tests);
+    if (test) {
+        test->quarantined = true;
+    } else {
+        _ST_WARNING("%s "ST_LOC_UNK_FILE_TEST, _ST_WARN_PREFIX, qctx->path, line);
     }
+    return true;
 }
 
-bool st_is_cl_arg(const st_cl_arg* arg, const char* flag)
+bool st_load_quarantine(const char* path, st_test* tests, size_t num_tests)
 {
-    return 0 == st_strncmp(flag, arg->flag, strnlen(arg->flag, ST_MAX_CLI_FLAG_STR_LEN)) ||
-           0 == st_strncmp(flag, arg->s_flag, strnlen(arg->s_flag, ST_MAX_CLI_S_FLAG_STR_LEN));
+    _st_quarantine_ctx ctx = {path, tests, num_tests};
+    return _st_for_each_line(path, &_st_quarantine_line, &ctx);
 }
 
-const st_cl_arg* st_find_cl_arg(const char* flag, const st_cl_arg* args, size_t num_args)
+typedef struct {
+    st_test* tests;
+    size_t num_tests;
+    bool valid;
+    bool complete;
+} _st_journal_ctx;
+
+static bool _st_journal_line(char* line, void* ctx)
 {
-    for (size_t n = 0; n < num_args; n++) {
-        if (st_is_cl_arg(&args[n], flag)) {
-            return &args[n];
-        }
+    _st_journal_ctx* jctx = (_st_journal_ctx*)ctx;
+    if (!jctx->valid) {
+        /* the first line identifies the file and the version of its format. */
+        jctx->valid = 0 == strcmp(line, ST_JOURNAL_MAGIC);
+        return jctx->valid;
     }
-    return NULL;
+
+    if (0 == strcmp(line, ST_JOURNAL_END)) {
+        jctx->complete = true;
+        return true;
+    }
+
+    char status     = '\0';
+    int errors      = 0;
+    int warnings    = 0;
+    int skip_conds  = 0;
+    double msec     = 0.0;
+    int name_offset = 0;
+    if (5 != sscanf(line, "%c %d %d %d %lf %n", &status, &errors, &warnings, &skip_conds,
+        &msec, &name_offset) || 0 == name_offset) {
+        return true; /* a partially written record; ignore it. */
+    }
+
+    st_test* test = st_find_test(line + name_offset, jctx->tests, jctx->num_tests);
+    if (test) {
+        test->res.skip_conds = skip_conds;
+        test->res.errors     = errors;
+        test->res.warnings   = warnings;
+        test->res.skip       = status == 'S';
+        test->res.pass       = status == 'P';
+        test->res.fatal      = status == 'F';
+        test->msec           = msec;
+        test->resumed        = true;
+    }
+
+    return true;
 }
 
-bool st_parse_cmd_line(int argc, char** argv, const st_cl_arg* args, size_t num_args,
-    st_test* tests, size_t num_tests, st_cl_config* config)
+bool st_journal_load(const char* path, st_test* tests, size_t num_tests, bool* complete)
 {
-    if (!argv || !args || !tests || !config)
+    _st_journal_ctx ctx = {tests, num_tests, false, false};
+    if (!_st_for_each_line(path, &_st_journal_line, &ctx) || !ctx.valid) {
         return false;
+    }
 
-    (void)memset(config, 0, sizeof(st_cl_config));
+    if (complete) {
+        *complete = ctx.complete;
+    }
 
-    for (int n = 1; n < argc; n++) {
-        const st_cl_arg* cur = st_find_cl_arg(argv[n], args, num_args);
-        if (!cur) {
-            _ST_ERROR(ST_LOC_UNK_OPT" '%s'", argv[n]);
-            st_print_usage_info(args, num_args);
-            return false;
-        }
-        if (st_is_cl_arg(cur, ST_LOC_WAIT_FLAG)) {
-            config->wait = true;
-        } else if (st_is_cl_arg(cur, ST_LOC_ONLY_FLAG)) {
-            while (++n < argc) {
-                if (!argv[n] || !*argv[n])
-                    continue;
-                if (*argv[n] == '-' || !st_mark_test_to_run(argv[n], tests, num_tests)) {
-                    _ST_ERROR(ST_LOC_INVAL_ARG" %s: '%s'", ST_LOC_ONLY_FLAG, argv[n]);
-                    st_print_usage_info(args, num_args);
-                    return false;
-                }
-                config->to_run++;
-            }
-            if (0 == config->to_run) {
-                _ST_ERROR(ST_LOC_VAL_EXPECT" '%s'", ST_LOC_ONLY_FLAG);
-                st_print_usage_info(args, num_args);
-                return false;
-            }
-        } else if (st_is_cl_arg(cur, ST_LOC_LIST_FLAG)) {
-            st_print_test_list(tests, num_tests);
-            return false;
-        } else if (st_is_cl_arg(cur, ST_LOC_FAIL_FLAG)) {
-            _ST_DEBUG("will exit immediately upon any falied test due to %s",
-                ST_LOC_FAIL_FLAG);
-            _state.fail_early = true;
-        } else if (st_is_cl_arg(cur, ST_LOC_VERS_FLAG)) {
-            st_print_version_info();
-            return false;
-        } else if (st_is_cl_arg(cur, ST_LOC_HELP_FLAG)) {
-            st_print_usage_info(args, num_args);
-            return false;
-        } else {
-            _ST_ERROR(ST_LOC_UNK_OPT" '%s'", cur->flag);
-            return false;
-        }
-    }
     return true;
 }
 
-bool st_getchar(char* input) {
-#if defined(__WIN__)
-    if (input)
-        *input = (char)_getch();
-     return true;
-#else /* !__WIN__ */
-    struct termios cur = {0};
-    if (0 != tcgetattr(STDIN_FILENO, &cur))
+bool st_journal_open(st_journal* journal, const char* path, const st_test* tests,
+    size_t num_tests)
+{
+    journal->file    = fopen(path, "w");
+    journal->pending = 0U;
+    if (!journal->file) {
         return false;
+    }
 
-    struct termios new = cur;
-    new.c_lflag &= ~(tcflag_t)(ICANON | ECHO);
-
-    if (0 != tcsetattr(STDIN_FILENO, TCSANOW, &new))
+    if (fprintf(journal->file, ST_JOURNAL_MAGIC "\n") < 0) {
+        st_journal_close(journal, false);
         return false;
+    }
 
-    int ch = getchar();
-
-    if (NULL != input)
-        *input = (char)ch;
+    /* carry over the results of tests that were completed by the previous run. */
+    for (size_t n = 0; n < num_tests; n++) {
+        if (tests[n].resumed) {
+            st_journal_record(journal, &tests[n]);
+        }
+    }
 
-    return 0 == tcsetattr(STDIN_FILENO, TCSANOW, &cur) ? true : false;
-#endif
+    return NULL != journal->file;
 }
 
-void st_wait_for_keypress(void)
+void st_journal_record(st_journal* journal, const st_test* test)
 {
-    (void)printf(WHITEB(ST_LOC_PRESS_KEY"\n"));
-    bool get = st_getchar(NULL);
-   _ST_UNUSED(get);
-}
+    if (!journal->file) {
+        return;
+    }
 
-void st_timer_begin(st_timer* timer)
-{
-    (void)st_msec_since(NULL, timer);
+    char status = test->res.skip ? 'S' : test->res.pass ? 'P' : test->res.fatal ? 'F' : 'W';
+    if (fprintf(journal->file, "%c %d %d %d %.3f %s\n", status, test->res.errors,
+        test->res.warnings, test->res.skip_conds, test->msec, test->name) < 0 ||
+        0 != fflush(journal->file)) {
+        _ST_REPORT_ERROR(errno);
+        st_journal_close(journal, false);
+        return;
+    }
+
+    if (++journal->pending >= ST_JOURNAL_SYNC_BATCH) {
+        (void)st_sync_file(journal->file);
+        journal->pending = 0U;
+    }
 }
 
-double st_timer_elapsed(const st_timer* timer)
+void st_journal_close(st_journal* journal, bool complete)
 {
-    st_timer now;
-    return st_msec_since(timer, &now);
+    if (!journal->file) {
+        return;
+    }
+
+    if (complete) {
+        (void)fprintf(journal->file, ST_JOURNAL_END "\n");
+    }
+
+    (void)fflush(journal->file);
+    (void)st_sync_file(journal->file);
+    (void)fclose(journal->file);
+    journal->file = NULL;
 }
 
-long st_timer_getres(void)
+typedef struct {
+    const char* path;
+    st_test* tests;
+    size_t num_tests;
+    st_cl_config* config;
+} _st_only_ctx;
+
+void st_print_test_list(const st_test* tests, size_t num_tests)
 {
-    long retval = 0L;
-#if !defined(__WIN__)
-    struct timespec res;
-    int get = clock_getres(ST_INTERVALCLOCK, &res);
-    if (0 == get)
-        retval = res.tv_nsec;
-#else /* __WIN__ */
-    LARGE_INTEGER perf_freq;
-    (void)QueryPerformanceFrequency(&perf_freq);
-    if (perf_freq.QuadPart <= 0)
-        retval = 0L;
-    else
-        retval = (long)(ceil(((double)perf_freq.QuadPart) / 1e9));
-#endif
-    return retval;
+    static const size_t tab_size = 4;
+
+    size_t longest = 0;
+    for (size_t n = 0; n < num_tests; n++) {
+        size_t len = strnlen(tests[n].name, ST_MAX_TEST_NAME_STR_LEN);
+        if (len > longest)
+            longest = len;
+    }
+
+    (void)printf("\n" WHITE(ST_LOC_AVAIL_TESTS":") "\n\n");
+
+    for (size_t n = 0; n < num_tests; n++) {
+        (void)printf("\t%s", tests[n].name);
+
+        size_t len = strnlen(tests[n].name, ST_MAX_TEST_NAME_STR_LEN);
+        if (len < longest + tab_size) {
+            for (size_t j = len; j < longest + tab_size; j++)
+                (void)printf(" ");
+        }
+
+        if ((n % 2) != 0 || n == num_tests - 1)
+            (void)printf("\n");
+    }
+
+    (void)printf("\n");
 }
 
-bool st_clock_gettime(int clock, time_t* tbuf, double* msecbuf)
+bool st_print_test_groups(st_test* tests, size_t num_tests, bool by_tag)
 {
-    if (tbuf) {
-#if defined(ST_MSEC_POSIX)
-        struct timespec ts = {0};
-        int ret = clock_gettime(clock, &ts);
-        if (0 == ret) {
-            *tbuf = ts.tv_sec;
-            if (msecbuf) {
-                *msecbuf = (double)(ts.tv_nsec) / 1e6;
-            }
-        } else {
-            if (msecbuf) {
-                *msecbuf = 0.0;
-            }
-            return false;
+    st_tag_table* table = &_state.tags;
+    if (!st_index_tags(table, tests, num_tests)) {
+        return false;
+    }
+
+    (void)printf("\n" WHITE("%s:") "\n", by_tag ? ST_LOC_TESTS_BY_TAG : ST_LOC_TESTS_BY_SUITE);
+
+    for (size_t t = 0; t < table->count; t++) {
+        if (by_tag ? table->is_tag[t] : table->is_suite[t]) {
+            _st_print_test_group(tests, num_tests, table->names[t],
+                by_tag ? &_st_test_has_tag : &_st_test_in_suite);
         }
-#elif defined(ST_MSEC_WIN32)
-       _ST_UNUSED(clock);
-        static const ULONGLONG uepoch = (ULONGLONG)116444736e9;
+    }
 
-        FILETIME ftutc = {0};
-        GetSystemTimePreciseAsFileTime(&ftutc);
+    /* tests without any tags (or suite). */
+    _st_print_test_group(tests, num_tests, NULL,
+        by_tag ? &_st_test_has_tag : &_st_test_in_suite);
 
-        ULARGE_INTEGER ftnow = {0};
-        ftnow.HighPart = ftutc.dwHighDateTime;
-        ftnow.LowPart  = ftutc.dwLowDateTime;
-        ftnow.QuadPart = (ULONGLONG)((ftnow.QuadPart - uepoch) / 10000000ULL);
+    (void)printf("\n");
+    return true;
+}
 
-        *tbuf = (time_t)ftnow.QuadPart;
+bool st_cases_begin(st_case_iter* iter, const st_case_source* source)
+{
+    (void)memset(iter, 0, sizeof(st_case_iter));
+    iter->source = source;
 
-        SYSTEMTIME st = {0};
-        if (FileTimeToSystemTime(&ftutc, &st)) {
-            if (msecbuf)
-                *msecbuf = (double)st.wMilliseconds;
-        } else {
-            if (msecbuf)
-                *msecbuf = 0.0;
+    if (ST_CASES_DIR == source->kind) {
+#if !defined(__WIN__)
+        iter->dir = opendir(source->path);
+        if (!iter->dir) {
+            _ST_REPORT_ERROR(errno);
             return false;
         }
-#else
-       _ST_UNUSED(clock);
-        time(tbuf);
-        if (msecbuf)
-            *msecbuf = 0.0;
+#else /* __WIN__ */
+        char pattern[ST_MAX_CASE_PATH_LEN] = {0};
+        (void)snprintf(pattern, sizeof(pattern), "%s\\*", source->path);
+        iter->dir = FindFirstFileA(pattern, &iter->find_data);
+        if (INVALID_HANDLE_VALUE == iter->dir) {
+            _ST_REPORT_ERROR((int)GetLastError());
+            iter->dir = NULL;
+            return false;
+        }
+        iter->found = true;
 #endif
         return true;
     }
-    return false;
+
+    /* records are located in a read-only mapping of the file as they are needed, so
+     * that neither the file nor its records need to be copied. */
+    if (ST_CASES_FILE == source->kind &&
+        !st_map_file(source->path, &iter->map, &iter->map_size)) {
+        return false;
+    }
+
+    return true;
 }
 
-double st_msec_since(const st_timer* when, st_timer* out)
+bool st_map_file(const char* path, const char** data, size_t* size)
 {
-    if (out == NULL)
-        return 0.0;
+    *data = NULL;
+    *size = 0;
 
 #if !defined(__WIN__)
-    out->sec = 0;
-    out->msec = 0.0;
-
-    bool gettime = st_clock_gettime(ST_INTERVALCLOCK, &out->sec, &out->msec);
-    if (when == NULL || !gettime || (out->sec < when->sec ||
-        (out->sec == when->sec && out->msec < when->msec)))
-        return 0.0;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        _ST_REPORT_ERROR(errno);
+        return false;
+    }
 
+    struct stat st;
+    if (0 != fstat(fd, &st)) {
+        _ST_REPORT_ERROR(errno);
+        (void)close(fd);
+        return false;
+    }
 
+    if (st.st_size > 0) {
+        void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (MAP_FAILED == map) {
+            _ST_REPORT_ERROR(errno);
+            (void)close(fd);
+            return false;
+        }
+        (void)posix_madvise(map, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+        *data = (const char*)map;
+        *size = (size_t)st.st_size;
+    }
 
-    return ((((double)out->sec) * 1e3) + out->msec) -
-           ((((double)when->sec) * 1e3) + when->msec);
+    (void)close(fd);
 #else /* __WIN__ */
-    LARGE_INTEGER perf_freq = {0};
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (INVALID_HANDLE_VALUE == file) {
+        _ST_REPORT_ERROR((int)GetLastError());
+        return false;
+    }
 
-    // TODO: store somewhere in static storage
-    (void)QueryPerformanceFrequency(&perf_freq);
-    (void)QueryPerformanceCounter(&out->counter);
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        _ST_REPORT_ERROR((int)GetLastError());
+        CloseHandle(file);
+        return false;
+    }
 
-    if (when == NULL || out->counter.QuadPart <= when->counter.QuadPart)
-        return 0.0;
+    if (file_size.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        const void* map = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+        if (!map) {
+            _ST_REPORT_ERROR((int)GetLastError());
+        }
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        if (!map) {
+            CloseHandle(file);
+            return false;
+        }
+        *data = (const char*)map;
+        *size = (size_t)file_size.QuadPart;
+    }
 
-    double msec_ratio = ((double)perf_freq.QuadPart) / 1e3;
-    return ((double)(out->counter.QuadPart - when->counter.QuadPart)) / msec_ratio;
+    CloseHandle(file);
 #endif
+    return true;
 }
 
-char* st_format_error_msg(int code, char message[ST_MAX_ERROR_STR_LEN])
+void st_unmap_file(const char* data, size_t size)
 {
-    message[0] = '\0';
-
-#if !defined(__WIN__)
-    int finderr = -1;
-# if defined(__HAVE_XSI_STRERROR_R__)
-    finderr = strerror_r(code, message, ST_MAX_ERROR_STR_LEN);
-#  if defined(__HAVE_XSI_STRERROR_R_ERRNO__)
-    if (finderr == -1) {
-        finderr = errno;
+    if (!data) {
+        return;
     }
-#  endif
-# elif defined(__HAVE_GNU_STRERROR_R__)
-    const char* tmp = strerror_r(code, message, ST_MAX_ERROR_STR_LEN);
-    if (tmp != message)
-        _st_strcpy(message, ST_MAX_ERROR_STR_LEN, tmp, strnlen(tmp, ST_MAX_ERROR_STR_LEN));
-# elif defined(__HAVE_STRERROR_S__)
-    finderr = (int)strerror_s(msg, ST_MAX_ERROR_STR_LEN, code);
-# else
-    const char* tmp = strerror(code);
-    _st_strcpy(message, ST_MAX_ERROR_STR_LEN, tmp, strnlen(tmp, ST_MAX_ERROR_STR_LEN);
-# endif
-# if defined(__HAVE_XSI_STRERROR_R__) || defined(__HAVE_STRERROR_S__)
-    assert(0 == finderr);
-    _ST_UNUSED(finderr);
-# else
-   _ST_UNUSED(finderr);
-# endif
+#if !defined(__WIN__)
+    (void)munmap((void*)data, size);
 #else /* __WIN__ */
-    DWORD flags = FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS |
-                  FORMAT_MESSAGE_MAX_WIDTH_MASK;
-    DWORD fmt = FormatMessageA(flags, NULL, (DWORD)code, 0UL, message, ST_MAX_ERROR_STR_LEN, NULL);
-    assert(0UL != fmt);
-    if (fmt > 0UL) {
-        if (message[fmt - 1] == '\n' || message[fmt - 1] == ' ') {
-            message[fmt - 1] = '\0';
-        }
-    }
+    _ST_UNUSED(size);
+    (void)UnmapViewOfFile(data);
 #endif
-
-    return &message[0];
+}
+
+void* st_scratch_alloc(size_t size)
+{
+    st_scratch* scratch = &_tstate.scratch;
+    size = (size + (sizeof(max_align_t) - 1)) & ~(sizeof(max_align_t) - 1);
+
+    if (scratch->used + size > scratch->peak) {
+        scratch->peak = scratch->used + size;
+    }
+    if (scratch->base && size <= scratch->size - scratch->used) {
+        void* mem = scratch->base + scratch->used;
+        scratch->used += size;
+        return mem;
+    }
+
+    st_scratch_chunk* chunk = malloc(sizeof(st_scratch_chunk) + size);
+    if (!chunk) {
+        _ST_ERROR(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_SCRATCH_NOMEM, size);
+        return NULL;
+    }
+    chunk->next       = scratch->overflow;
+    scratch->overflow = chunk;
+    return chunk->data;
+}
+
+bool st_array_unique(const void* arr, size_t count, size_t elem_size, int kind)
+{
+    st_scratch mark = _tstate.scratch;
+    st_elem_table table;
+    if (!_st_elem_table_init(&table, arr, count, elem_size, kind)) {
+        return false;
+    }
+
+    bool unique = true;
+    for (size_t n = 0; n < count; n++) {
+        if (ST_VALUE_REAL == kind) {
+            /* NaN is unequal even to itself, so it cannot be a duplicate. */
+            long double value = _st_read_value(table.elems + n * elem_size, elem_size,
+                kind).f;
+            if (value != value) {
+                continue;
+            }
+        }
+        st_elem_slot* slot = _st_elem_table_find(&table, table.elems + n * elem_size);
+        if (slot->index) {
+            _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_DUPLICATES, slot->index - 1, n);
+            unique = false;
+            break;
+        }
+        slot->index = n + 1;
+    }
+
+    _st_scratch_release(&_tstate.scratch, &mark);
+    return unique;
+}
+
+bool st_array_permutation_of(const void* lhs, size_t lhs_count, const void* rhs,
+    size_t rhs_count, size_t elem_size, int kind)
+{
+    if (lhs_count != rhs_count) {
+        _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_COUNTS_DIFFER, lhs_count, rhs_count);
+        return false;
+    }
+
+    st_scratch mark = _tstate.scratch;
+    st_elem_table table;
+    if (!_st_elem_table_init(&table, lhs, lhs_count, elem_size, kind)) {
+        return false;
+    }
+
+    /* count the occurrences of each value in `lhs`, then use them up with `rhs`. */
+    for (size_t n = 0; n < lhs_count; n++) {
+        st_elem_slot* slot = _st_elem_table_find(&table, table.elems + n * elem_size);
+        if (!slot->index) {
+            slot->index = n + 1;
+        }
+        slot->count++;
+    }
+
+    bool permutation = true;
+    const unsigned char* elems = rhs;
+    for (size_t n = 0; n < rhs_count; n++) {
+        st_elem_slot* slot = _st_elem_table_find(&table, elems + n * elem_size);
+        if (0 == slot->count) {
+            _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_NO_COUNTERPART, n, ST_LOC_SECOND,
+                ST_LOC_FIRST);
+            permutation = false;
+            break;
+        }
+        slot->count--;
+    }
+
+    _st_scratch_release(&_tstate.scratch, &mark);
+    return permutation;
+}
+
+bool st_array_set_equal(const void* lhs, size_t lhs_count, const void* rhs,
+    size_t rhs_count, size_t elem_size, int kind)
+{
+    st_scratch mark = _tstate.scratch;
+    st_elem_table table;
+    if (!_st_elem_table_init(&table, lhs, lhs_count, elem_size, kind)) {
+        return false;
+    }
+
+    for (size_t n = 0; n < lhs_count; n++) {
+        st_elem_slot* slot = _st_elem_table_find(&table, table.elems + n * elem_size);
+        if (!slot->index) {
+            slot->index = n + 1;
+        }
+    }
+
+    /* mark each value of `lhs` found in `rhs`, then look for any left unmarked. */
+    bool equal = true;
+    const unsigned char* elems = rhs;
+    for (size_t n = 0; n < rhs_count; n++) {
+        st_elem_slot* slot = _st_elem_table_find(&table, elems + n * elem_size);
+        if (!slot->index) {
+            _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_NO_COUNTERPART, n, ST_LOC_SECOND,
+                ST_LOC_FIRST);
+            equal = false;
+            break;
+        }
+        slot->count = 1;
+    }
+    if (equal) {
+        size_t unmarked = SIZE_MAX;
+        for (size_t n = 0; n <= table.mask; n++) {
+            if (table.slots[n].index && !table.slots[n].count &&
+                table.slots[n].index - 1 < unmarked) {
+                unmarked = table.slots[n].index - 1;
+            }
+        }
+        if (SIZE_MAX != unmarked) {
+            _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_NO_COUNTERPART, unmarked,
+                ST_LOC_FIRST, ST_LOC_SECOND);
+            equal = false;
+        }
+    }
+
+    _st_scratch_release(&_tstate.scratch, &mark);
+    return equal;
+}
+
+bool st_span_equal(const void* lhs, size_t lhs_count, int lhs_kind, const void* rhs,
+    size_t rhs_count, int rhs_kind, size_t elem_size)
+{
+    bool equal   = lhs_count == rhs_count;
+    size_t count = lhs_count < rhs_count ? lhs_count : rhs_count;
+    if (!equal) {
+        _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_COUNTS_DIFFER, lhs_count, rhs_count);
+    }
+
+    const unsigned char* l = lhs;
+    const unsigned char* r = rhs;
+    size_t index           = 0;
+    if (lhs_kind == rhs_kind && ST_VALUE_REAL != lhs_kind) {
+        /* integers (and other objects) of the same type are equal if their
+         * representations are. */
+        index = _st_find_mismatch(l, count * elem_size, r, count * elem_size) / elem_size;
+    } else {
+        for (; index < count; index++) {
+            st_value lval = _st_read_value(l + index * elem_size, elem_size, lhs_kind);
+            st_value rval = _st_read_value(r + index * elem_size, elem_size, rhs_kind);
+            if (ST_VALUE_BYTES == lval.kind || ST_VALUE_BYTES == rval.kind ?
+                0 != memcmp(l + index * elem_size, r + index * elem_size, elem_size) :
+                !_st_values_equal(&lval, &rval)) {
+                break;
+            }
+        }
+    }
+
+    if (index < count) {
+        char lhs_str[ST_MAX_VALUE_STR_LEN] = {0};
+        char rhs_str[ST_MAX_VALUE_STR_LEN] = {0};
+        _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_ELEM_DIFFERS, index,
+            _st_format_elem(l + index * elem_size, elem_size, lhs_kind, lhs_str),
+            _st_format_elem(r + index * elem_size, elem_size, rhs_kind, rhs_str));
+        equal = false;
+    }
+
+    return equal;
+}
+
+bool st_span_contains(const void* span, size_t count, size_t elem_size, int kind,
+    st_value value)
+{
+    if (_st_span_find(span, count, elem_size, kind, &value) < count) {
+        return true;
+    }
+
+    char value_str[ST_MAX_VALUE_STR_LEN] = {0};
+    _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_ELEM_MISSING, count,
+        _st_format_value(&value, value_str));
+    return false;
+}
+
+bool st_span_not_contains(const void* span, size_t count, size_t elem_size, int kind,
+    st_value value)
+{
+    size_t index = _st_span_find(span, count, elem_size, kind, &value);
+    if (index == count) {
+        return true;
+    }
+
+    char value_str[ST_MAX_VALUE_STR_LEN] = {0};
+    _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_ELEM_FOUND, index,
+        _st_format_value(&value, value_str));
+    return false;
+}
+
+bool st_near(double lhs, double rhs, double abs_tol, uint64_t max_ulps, bool single)
+{
+    uint64_t ulps = 0;
+    if (_st_elem_near(lhs, rhs, abs_tol, max_ulps, single, &ulps)) {
+        return true;
+    }
+
+    char ulps_str[ST_MAX_VALUE_STR_LEN] = {0};
+    int digits = single ? FLT_DECIMAL_DIG : DBL_DECIMAL_DIG;
+    _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_NOT_NEAR, digits, lhs, digits, rhs,
+        fabs(lhs - rhs), _st_format_ulps(ulps, ulps_str));
+    return false;
+}
+
+bool st_matrix_near(const void* lhs, size_t lhs_stride, const void* rhs, size_t rhs_stride,
+    size_t rows, size_t cols, size_t elem_size, double abs_tol, uint64_t max_ulps)
+{
+    size_t mismatches = 0;
+    size_t worst_row  = 0;
+    size_t worst_col  = 0;
+    uint64_t worst    = 0;
+    bool single       = sizeof(float) == elem_size;
+
+    for (size_t row = 0; row < rows; row++) {
+        const char* lhs_row = (const char*)lhs + row * lhs_stride * elem_size;
+        const char* rhs_row = (const char*)rhs + row * rhs_stride * elem_size;
+
+        /* the kernels pass over elements that are certainly near, stopping at any
+         * that might not be; those are judged (and ranked) here. */
+        for (size_t col = 0; col < cols; col++) {
+            col += _st_find_not_near(lhs_row + col * elem_size, rhs_row + col * elem_size,
+                cols - col, elem_size, abs_tol, max_ulps);
+            if (col >= cols) {
+                break;
+            }
+
+            uint64_t ulps = 0;
+            if (_st_elem_near(_st_read_real(lhs_row + col * elem_size, elem_size),
+                _st_read_real(rhs_row + col * elem_size, elem_size), abs_tol, max_ulps, single,
+                &ulps)) {
+                continue;
+            }
+            if (0 == mismatches++ || ulps > worst) {
+                worst     = ulps;
+                worst_row = row;
+                worst_col = col;
+            }
+        }
+    }
+    if (0 == mismatches) {
+        return true;
+    }
+
+    double worst_lhs = _st_read_real((const char*)lhs +
+        (worst_row * lhs_stride + worst_col) * elem_size, elem_size);
+    double worst_rhs = _st_read_real((const char*)rhs +
+        (worst_row * rhs_stride + worst_col) * elem_size, elem_size);
+    char index_str[ST_MAX_VALUE_STR_LEN] = {0};
+    if (1 == rows) {
+        (void)snprintf(index_str, sizeof(index_str), "%zu", worst_col);
+    } else {
+        (void)snprintf(index_str, sizeof(index_str), "[%zu][%zu]", worst_row, worst_col);
+    }
+
+    char ulps_str[ST_MAX_VALUE_STR_LEN] = {0};
+    int digits = single ? FLT_DECIMAL_DIG : DBL_DECIMAL_DIG;
+    size_t total = rows * cols;
+    _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_NOT_NEAR_SUM, mismatches, total,
+        _ST_PLURAL(ST_LOC_ELEMENT, total), index_str, digits, worst_lhs, digits,
+        worst_rhs, fabs(worst_lhs - worst_rhs), _st_format_ulps(worst, ulps_str));
+    return false;
+}
+
+bool st_snapshot_equal(const char* name, const void* data, size_t size)
+{
+    char path[ST_MAX_SNAPSHOT_PATH_LEN] = {0};
+    if (!_st_snapshot_path(name, path)) {
+        return false;
+    }
+
+    bool exists = _st_file_exists(path);
+    if (!exists && !_state.update_snapshots) {
+        _ST_ERROR(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_SNAP_MISSING, name, ST_LOC_UPD_FLAG);
+        return false;
+    }
+
+    const char* golden = NULL;
+    size_t golden_size = 0;
+    if (exists && !st_map_file(path, &golden, &golden_size)) {
+        return false;
+    }
+
+    size_t offset = _st_find_mismatch(golden, golden_size, data, size);
+    bool equal    = exists && offset == golden_size && offset == size;
+    if (!equal && !_state.update_snapshots) {
+        _st_print_mismatch(offset, 0, ST_LOC_SNAPSHOT, golden, golden_size, ST_LOC_ACTUAL,
+            data, size);
+    }
+
+    /* the golden file is unmapped before being rewritten (which Windows requires). */
+    st_unmap_file(golden, golden_size);
+
+    if (!equal && _state.update_snapshots) {
+        if (!_st_write_snapshot(path, data, size)) {
+            return false;
+        }
+        _ST_WARNING(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_SNAP_UPDATED, name, size);
+        return true;
+    }
+
+    return equal;
+}
+
+bool st_snapshot_update(const char* name, const void* data, size_t size)
+{
+    char path[ST_MAX_SNAPSHOT_PATH_LEN] = {0};
+    return _st_snapshot_path(name, path) && _st_write_snapshot(path, data, size);
+}
+
+bool st_file_equal(const char* path_a, const char* path_b)
+{
+    const char* data_a = NULL;
+    const char* data_b = NULL;
+    size_t size_a      = 0;
+    size_t size_b      = 0;
+    if (!st_map_file(path_a, &data_a, &size_a)) {
+        return false;
+    }
+    if (!st_map_file(path_b, &data_b, &size_b)) {
+        st_unmap_file(data_a, size_a);
+        return false;
+    }
+
+    size_t offset = _st_find_mismatch(data_a, size_a, data_b, size_b);
+    bool equal    = offset == size_a && offset == size_b;
+    if (!equal) {
+        _st_print_mismatch(offset, 0, path_a, data_a, size_a, path_b, data_b, size_b);
+    }
+
+    st_unmap_file(data_a, size_a);
+    st_unmap_file(data_b, size_b);
+    return equal;
+}
+
+bool st_mem_filled(const void* ptr, size_t len, uint8_t byte)
+{
+    size_t offset = _st_find_byte_not(ptr, len, byte);
+    if (offset == len) {
+        return true;
+    }
+
+    uint8_t expected[ST_DIFF_ROWS * ST_DIFF_ROW_BYTES];
+    (void)memset(expected, byte, sizeof(expected));
+    _st_print_expected(offset, expected, ptr, len);
+    return false;
+}
+
+bool st_mem_not_filled(const void* ptr, size_t len, uint8_t byte)
+{
+    if (_st_find_byte_not(ptr, len, byte) < len) {
+        return true;
+    }
+
+    _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_ALL_FILLED, len,
+        _ST_PLURAL(ST_LOC_BYTE, len), byte);
+    return false;
+}
+
+bool st_mem_pattern(const void* ptr, size_t len, const void* pattern, size_t pattern_len)
+{
+    if (0 == pattern_len) {
+        _ST_ERROR(ST_LOC_INDENT ST_LOC_INDENT "%s", ST_LOC_EMPTY_PATTERN);
+        return false;
+    }
+
+    const uint8_t* bytes = ptr;
+    size_t head          = len < pattern_len ? len : pattern_len;
+    size_t offset        = _st_find_mismatch(bytes, head, pattern, head);
+    if (offset == head && len > pattern_len) {
+        /* past the first period, each byte must equal the one a period before it. */
+        offset = pattern_len + _st_find_mismatch(bytes + pattern_len, len - pattern_len,
+            bytes, len - pattern_len);
+    }
+    if (offset == len) {
+        return true;
+    }
+
+    uint8_t expected[ST_DIFF_ROWS * ST_DIFF_ROW_BYTES];
+    size_t base = _st_diff_window(offset);
+    for (size_t n = 0; n < sizeof(expected); n++) {
+        expected[n] = ((const uint8_t*)pattern)[(base + n) % pattern_len];
+    }
+    _st_print_expected(offset, expected, ptr, len);
+    return false;
+}
+
+bool st_str_only_chars(const char* str, size_t len, const char* set)
+{
+    uint64_t bitmap[4] = {0};
+    for (const uint8_t* c = (const uint8_t*)set; '\0' != *c; c++) {
+        bitmap[*c >> 6] |= UINT64_C(1) << (*c & 63);
+    }
+
+    size_t offset = _st_find_char_not_in(str, len, bitmap);
+    if (offset == len) {
+        return true;
+    }
+
+    char char_str[8];
+    _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_CHAR_NOT_IN_SET, offset,
+        _st_format_char((uint8_t)str[offset], char_str));
+    return false;
+}
+
+bool st_str_utf8_valid(const char* str, size_t len)
+{
+    const uint8_t* bytes = (const uint8_t*)str;
+    size_t offset        = _st_find_utf8_invalid(bytes, len);
+    if (offset == len) {
+        return true;
+    }
+
+    /* the longest sequence is 4 bytes; show as many as there are. */
+    char seq_str[4 * 3] = {0};
+    int pos             = 0;
+    for (size_t n = 0; n < 4 && offset + n < len; n++) {
+        pos += snprintf(seq_str + pos, sizeof(seq_str) - (size_t)pos, n > 0 ? " %02x" : "%02x",
+            bytes[offset + n]);
+    }
+    _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_INVALID_UTF8, offset, seq_str);
+    return false;
+}
+
+bool st_str_matches(st_regex_site* site, const char* str, const char* pattern)
+{
+#if !defined(__WIN__)
+    bool matched = false;
+    if (!_st_regex_exec(site, str, pattern, NULL, &matched)) {
+        return false;
+    }
+    if (matched) {
+        return true;
+    }
+
+    size_t len = strlen(str);
+    _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_RE_NO_MATCH,
+        (int)(len < ST_MAX_VALUE_STR_LEN ? len : ST_MAX_VALUE_STR_LEN), str,
+        len > ST_MAX_VALUE_STR_LEN ? "..." : "", pattern);
+#else /* __WIN__ */
+    _ST_UNUSED(site);
+    _ST_UNUSED(str);
+    _ST_ERROR(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_NO_REGEX, pattern);
+#endif
+    return false;
+}
+
+bool st_str_not_matches(st_regex_site* site, const char* str, const char* pattern)
+{
+#if !defined(__WIN__)
+    regmatch_t match = {0};
+    bool matched     = false;
+    if (!_st_regex_exec(site, str, pattern, &match, &matched)) {
+        return false;
+    }
+    if (!matched) {
+        return true;
+    }
+
+    size_t len = (size_t)(match.rm_eo - match.rm_so);
+    _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_RE_MATCHED, pattern,
+        (int)(len < ST_MAX_VALUE_STR_LEN ? len : ST_MAX_VALUE_STR_LEN), str + match.rm_so,
+        len > ST_MAX_VALUE_STR_LEN ? "..." : "", (size_t)match.rm_so);
+#else /* __WIN__ */
+    _ST_UNUSED(site);
+    _ST_UNUSED(str);
+    _ST_ERROR(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_NO_REGEX, pattern);
+#endif
+    return false;
+}
+
+bool st_buf_equal(const char* lhs, size_t lhs_len, const char* rhs, size_t rhs_len,
+    bool ignore_case)
+{
+    if (!_st_check_bufs(ST_LOC_FIRST, lhs, lhs_len, ST_LOC_SECOND, rhs, rhs_len)) {
+        return false;
+    }
+
+    size_t offset = ignore_case ? _st_find_mismatch_i(lhs, lhs_len, rhs, rhs_len)
+                                : _st_find_mismatch(lhs, lhs_len, rhs, rhs_len);
+    if (offset == lhs_len && offset == rhs_len) {
+        return true;
+    }
+
+    _st_print_mismatch(offset, 0, ST_LOC_FIRST, lhs, lhs_len, ST_LOC_SECOND, rhs, rhs_len);
+    return false;
+}
+
+bool st_buf_not_equal(const char* lhs, size_t lhs_len, const char* rhs, size_t rhs_len,
+    bool ignore_case)
+{
+    if (!_st_check_bufs(ST_LOC_FIRST, lhs, lhs_len, ST_LOC_SECOND, rhs, rhs_len)) {
+        return false;
+    }
+    if (lhs_len != rhs_len) {
+        return true;
+    }
+
+    size_t offset = ignore_case ? _st_find_mismatch_i(lhs, lhs_len, rhs, rhs_len)
+                                : _st_find_mismatch(lhs, lhs_len, rhs, rhs_len);
+    if (offset < lhs_len) {
+        return true;
+    }
+
+    _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_BUFS_EQUAL, lhs_len,
+        _ST_PLURAL(ST_LOC_BYTE, lhs_len));
+    return false;
+}
+
+bool st_buf_contains(const char* needle, size_t needle_len, const char* haystack,
+    size_t haystack_len, bool ignore_case)
+{
+    if (!_st_check_bufs(ST_LOC_NEEDLE, needle, needle_len, ST_LOC_HAYSTACK, haystack,
+        haystack_len)) {
+        return false;
+    }
+    if (SIZE_MAX != _st_search((const uint8_t*)haystack, haystack_len,
+        (const uint8_t*)needle, needle_len, ignore_case)) {
+        return true;
+    }
+
+    _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_NEEDLE_MISSING, needle_len,
+        _ST_PLURAL(ST_LOC_BYTE, needle_len), haystack_len,
+        _ST_PLURAL(ST_LOC_BYTE, haystack_len));
+    return false;
+}
+
+bool st_buf_not_contains(const char* needle, size_t needle_len, const char* haystack,
+    size_t haystack_len, bool ignore_case)
+{
+    if (!_st_check_bufs(ST_LOC_NEEDLE, needle, needle_len, ST_LOC_HAYSTACK, haystack,
+        haystack_len)) {
+        return false;
+    }
+
+    size_t offset = _st_search((const uint8_t*)haystack, haystack_len,
+        (const uint8_t*)needle, needle_len, ignore_case);
+    if (SIZE_MAX == offset) {
+        return true;
+    }
+
+    _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_NEEDLE_FOUND, needle_len,
+        _ST_PLURAL(ST_LOC_BYTE, needle_len), offset, offset);
+    return false;
+}
+
+bool st_buf_begins_with(const char* needle, size_t needle_len, const char* haystack,
+    size_t haystack_len, bool ignore_case)
+{
+    if (!_st_check_bufs(ST_LOC_NEEDLE, needle, needle_len, ST_LOC_HAYSTACK, haystack,
+        haystack_len)) {
+        return false;
+    }
+
+    size_t prefix_len = haystack_len < needle_len ? haystack_len : needle_len;
+    size_t offset = ignore_case ? _st_find_mismatch_i(needle, needle_len, haystack, prefix_len)
+                                : _st_find_mismatch(needle, needle_len, haystack, prefix_len);
+    if (offset == needle_len) {
+        return true;
+    }
+
+    _st_print_mismatch(offset, 0, ST_LOC_NEEDLE, needle, needle_len, ST_LOC_HAYSTACK,
+        haystack, prefix_len);
+    return false;
+}
+
+bool st_buf_not_begins_with(const char* needle, size_t needle_len, const char* haystack,
+    size_t haystack_len, bool ignore_case)
+{
+    if (!_st_check_bufs(ST_LOC_NEEDLE, needle, needle_len, ST_LOC_HAYSTACK, haystack,
+        haystack_len)) {
+        return false;
+    }
+    if (haystack_len < needle_len) {
+        return true;
+    }
+
+    size_t offset = ignore_case ? _st_find_mismatch_i(needle, needle_len, haystack, needle_len)
+                                : _st_find_mismatch(needle, needle_len, haystack, needle_len);
+    if (offset < needle_len) {
+        return true;
+    }
+
+    _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_NEEDLE_FOUND, needle_len,
+        _ST_PLURAL(ST_LOC_BYTE, needle_len), (size_t)0, (size_t)0);
+    return false;
+}
+
+bool st_buf_ends_with(const char* needle, size_t needle_len, const char* haystack,
+    size_t haystack_len, bool ignore_case)
+{
+    if (!_st_check_bufs(ST_LOC_NEEDLE, needle, needle_len, ST_LOC_HAYSTACK, haystack,
+        haystack_len)) {
+        return false;
+    }
+
+    /* align the ends; if the needle is longer, its surplus is compared with nothing. */
+    size_t suffix_len  = haystack_len < needle_len ? haystack_len : needle_len;
+    const char* suffix = haystack + (haystack_len - suffix_len);
+    const char* tail   = needle + (needle_len - suffix_len);
+    size_t offset = ignore_case ? _st_find_mismatch_i(tail, suffix_len, suffix, suffix_len)
+                                : _st_find_mismatch(tail, suffix_len, suffix, suffix_len);
+    if (offset == suffix_len && suffix_len == needle_len) {
+        return true;
+    }
+
+    _st_print_mismatch(offset, 0, ST_LOC_NEEDLE, tail, suffix_len, ST_LOC_HAYSTACK, suffix,
+        suffix_len);
+    if (suffix_len < needle_len) {
+        _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_NEEDLE_LONGER, needle_len,
+            _ST_PLURAL(ST_LOC_BYTE, needle_len), haystack_len,
+            _ST_PLURAL(ST_LOC_BYTE, haystack_len));
+    }
+    return false;
+}
+
+bool st_buf_not_ends_with(const char* needle, size_t needle_len, const char* haystack,
+    size_t haystack_len, bool ignore_case)
+{
+    if (!_st_check_bufs(ST_LOC_NEEDLE, needle, needle_len, ST_LOC_HAYSTACK, haystack,
+        haystack_len)) {
+        return false;
+    }
+    if (haystack_len < needle_len) {
+        return true;
+    }
+
+    size_t start  = haystack_len - needle_len;
+    size_t offset = ignore_case ? _st_find_mismatch_i(needle, needle_len, haystack + start,
+                                    needle_len)
+                                : _st_find_mismatch(needle, needle_len, haystack + start,
+                                    needle_len);
+    if (offset < needle_len) {
+        return true;
+    }
+
+    _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_NEEDLE_FOUND, needle_len,
+        _ST_PLURAL(ST_LOC_BYTE, needle_len), start, start);
+    return false;
+}
+
+bool st_cases_next(st_case_iter* iter, st_case* out)
+{
+    const st_case_source* source = iter->source;
+    *out = (st_case){.index = iter->next};
+
+    switch (source->kind) {
+        case ST_CASES_TABLE:
+            if (iter->next >= source->count) {
+                return false;
+            }
+            out->data = (const char*)source->table + iter->next * source->elem_size;
+            out->size = source->elem_size;
+        break;
+        case ST_CASES_GENERATOR:
+            if (!source->generate || !source->generate(iter->next, out)) {
+                return false;
+            }
+            out->index = iter->next;
+        break;
+        case ST_CASES_FILE: {
+            if (iter->offset >= iter->map_size) {
+                return false;
+            }
+            const char* record = iter->map + iter->offset;
+            size_t remaining   = iter->map_size - iter->offset;
+            const char* end    = memchr(record, source->delim, remaining);
+            size_t len         = end ? (size_t)(end - record) : remaining;
+            iter->offset      += len + (end ? 1 : 0);
+            if ('\n' == source->delim && len > 0 && '\r' == record[len - 1]) {
+                len--;
+            }
+            out->data = record;
+            out->size = len;
+        }
+        break;
+        case ST_CASES_DIR:
+            if (!_st_next_corpus_file(iter, out)) {
+                return false;
+            }
+        break;
+        default:
+            return false;
+    }
+
+    iter->next++;
+    return true;
+}
+
+void st_cases_end(st_case_iter* iter)
+{
+    st_unmap_file(iter->map, iter->map_size);
+    if (iter->dir) {
+#if !defined(__WIN__)
+        (void)closedir(iter->dir);
+#else /* __WIN__ */
+        (void)FindClose(iter->dir);
+#endif
+    }
+    (void)memset(iter, 0, sizeof(st_case_iter));
+}
+
+const char* st_format_case(const st_case* test_case, char buf[ST_MAX_CASE_STR_LEN])
+{
+    if (test_case->label) {
+        return test_case->label;
+    }
+    (void)snprintf(buf, ST_MAX_CASE_STR_LEN, "%zu", test_case->index);
+    return buf;
+}
+
+const st_case* st_current_case(void)
+{
+    return _tstate.current_case;
+}
+
+bool st_acquire_fixtures(st_test* test)
+{
+    test->fixture_msec = 0.0;
+    if (!test->fixtures) {
+        return true;
+    }
+
+    for (st_fixture* const* cur = test->fixtures; *cur != NULL; cur++) {
+        st_fixture* fixture = *cur;
+        st_mutex_lock(&fixture->lock);
+        if (!fixture->created && !fixture->failed) {
+            uint64_t started = st_clock_nsec();
+            fixture->data    = fixture->create ? fixture->create() : NULL;
+            fixture->created = NULL != fixture->data;
+            fixture->failed  = !fixture->created;
+            fixture->create_nsec = st_clock_nsec() - started;
+
+            char elapsed[ST_MAX_DURATION_STR_LEN] = {0};
+            test->fixture_msec += (double)fixture->create_nsec / 1e6;
+            if (fixture->created) {
+                _ST_MESSAGE(ST_LOC_INDENT DGRAY(ST_LOC_FIXT_CREATED), fixture->name,
+                    _st_format_nsec((double)fixture->create_nsec, elapsed));
+            }
+        }
+        bool failed = fixture->failed;
+        st_mutex_unlock(&fixture->lock);
+
+        if (failed) {
+            /* construction is attempted only once; every user fails. */
+            _ST_ERROR(ST_LOC_INDENT ST_LOC_FIXT_FAILED, fixture->name);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void st_release_fixtures(const st_test* test)
+{
+    if (!test->fixtures) {
+        return;
+    }
+
+    for (st_fixture* const* cur = test->fixtures; *cur != NULL; cur++) {
+        st_fixture* fixture = *cur;
+        st_mutex_lock(&fixture->lock);
+        if (fixture->refs > 0 && 0 == --fixture->refs) {
+            _st_destroy_fixture(fixture);
+        }
+        st_mutex_unlock(&fixture->lock);
+    }
+}
+
+const void* st_fixture_data(st_fixture* fixture)
+{
+    st_mutex_lock(&fixture->lock);
+    const void* data = fixture->created ? fixture->data : NULL;
+    st_mutex_unlock(&fixture->lock);
+    return data;
+}
+
+void st_mutex_lock(st_mutex* mutex)
+{
+#if !defined(__WIN__)
+    (void)pthread_mutex_lock(mutex);
+#else /* __WIN__ */
+    AcquireSRWLockExclusive(mutex);
+#endif
+}
+
+void st_mutex_unlock(st_mutex* mutex)
+{
+#if !defined(__WIN__)
+    (void)pthread_mutex_unlock(mutex);
+#else /* __WIN__ */
+    ReleaseSRWLockExclusive(mutex);
+#endif
+}
+
+bool st_index_tags(st_tag_table* table, st_test* tests, size_t num_tests)
+{
+    (void)memset(table, 0, sizeof(st_tag_table));
+
+    for (size_t n = 0; n < num_tests; n++) {
+        st_tagset* tagset = &tests[n].tagset;
+        (void)memset(tagset, 0, sizeof(st_tagset));
+
+        if (tests[n].suite && *tests[n].suite && !_st_intern_tag(table, &tests[n],
+            tests[n].suite, strnlen(tests[n].suite, ST_MAX_TAG_STR_LEN + 1), true, tagset)) {
+            return false;
+        }
+
+        size_t len = 0;
+        for (const char* tag = _st_next_tag(tests[n].tags, &len); tag != NULL;
+            tag = _st_next_tag(tag + len, &len)) {
+            if (!_st_intern_tag(table, &tests[n], tag, len, false, tagset)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+typedef struct {
+    const char* p;
+    const st_tag_table* table;
+    st_tag_expr* expr;
+    bool ok;
+} _st_tag_parser;
+
+static void _st_tag_parse_or(_st_tag_parser* parser);
+
+static void _st_tag_emit(_st_tag_parser* parser, uint16_t op, uint16_t tag)
+{
+    if (parser->expr->num_ops >= ST_MAX_TAG_EXPR_OPS) {
+        parser->ok = false;
+        return;
+    }
+    parser->expr->ops[parser->expr->num_ops].op  = op;
+    parser->expr->ops[parser->expr->num_ops].tag = tag;
+    parser->expr->num_ops++;
+}
+
+static bool _st_is_tag_char(char c)
+{
+    return isalnum((unsigned char)c) || c == '_' || c == '-' || c == '.' || c == ':';
+}
+
+static void _st_tag_skip_space(_st_tag_parser* parser)
+{
+    while (isspace((unsigned char)*parser->p)) {
+        parser->p++;
+    }
+}
+
+static void _st_tag_parse_unary(_st_tag_parser* parser)
+{
+    _st_tag_skip_space(parser);
+    if (!parser->ok) {
+        return;
+    }
+
+    if (*parser->p == '!') {
+        parser->p++;
+        _st_tag_parse_unary(parser);
+        _st_tag_emit(parser, ST_TAGOP_NOT, 0);
+    } else if (*parser->p == '(') {
+        parser->p++;
+        _st_tag_parse_or(parser);
+        _st_tag_skip_space(parser);
+        if (*parser->p != ')') {
+            parser->ok = false;
+            return;
+        }
+        parser->p++;
+    } else if (_st_is_tag_char(*parser->p)) {
+        const char* start = parser->p;
+        while (_st_is_tag_char(*parser->p)) {
+            parser->p++;
+        }
+        size_t len = (size_t)(parser->p - start);
+        for (size_t t = 0; t < parser->table->count; t++) {
+            if (len == strnlen(parser->table->names[t], ST_MAX_TAG_STR_LEN) &&
+                0 == strncmp(parser->table->names[t], start, len)) {
+                _st_tag_emit(parser, ST_TAGOP_TAG, (uint16_t)t);
+                return;
+            }
+        }
+        _ST_WARNING("%s "ST_LOC_UNK_TAG, _ST_WARN_PREFIX, (int)len, start);
+        _st_tag_emit(parser, ST_TAGOP_FALSE, 0);
+    } else {
+        parser->ok = false;
+    }
+}
+
+static void _st_tag_parse_and(_st_tag_parser* parser)
+{
+    _st_tag_parse_unary(parser);
+    for (_st_tag_skip_space(parser); parser->ok && *parser->p == '&';
+        _st_tag_skip_space(parser)) {
+        parser->p += parser->p[1] == '&' ? 2 : 1;
+        _st_tag_parse_unary(parser);
+        _st_tag_emit(parser, ST_TAGOP_AND, 0);
+    }
+}
+
+static void _st_tag_parse_or(_st_tag_parser* parser)
+{
+    _st_tag_parse_and(parser);
+    for (_st_tag_skip_space(parser); parser->ok && *parser->p == '|';
+        _st_tag_skip_space(parser)) {
+        parser->p += parser->p[1] == '|' ? 2 : 1;
+        _st_tag_parse_and(parser);
+        _st_tag_emit(parser, ST_TAGOP_OR, 0);
+    }
+}
+
+bool st_compile_tag_expr(const char* str, const st_tag_table* table, st_tag_expr* expr)
+{
+    /* grammar: or := and ('|' and)*; and := unary ('&' unary)*;
+     * unary := '!' unary | '(' or ')' | tag. */
+    expr->num_ops = 0;
+    _st_tag_parser parser = {str, table, expr, true};
+    _st_tag_parse_or(&parser);
+    _st_tag_skip_space(&parser);
+
+    if (!parser.ok || *parser.p != '\0') {
+        _ST_ERROR("%s "ST_LOC_INVAL_TAGS, _ST_ERROR_PREFIX, str, parser.p);
+        return false;
+    }
+
+    return true;
+}
+
+bool st_eval_tag_expr(const st_tag_expr* expr, const st_tagset* tagset)
+{
+    bool stack[ST_MAX_TAG_EXPR_OPS];
+    size_t top = 0;
+
+    for (size_t n = 0; n < expr->num_ops; n++) {
+        const st_tag_op* op = &expr->ops[n];
+        switch (op->op) {
+            case ST_TAGOP_TAG:
+                stack[top++] = 0ULL != (tagset->words[op->tag / 64] &
+                    (UINT64_C(1) << (op->tag % 64)));
+            break;
+            case ST_TAGOP_FALSE:
+                stack[top++] = false;
+            break;
+            case ST_TAGOP_NOT:
+                stack[top - 1] = !stack[top - 1];
+            break;
+            case ST_TAGOP_AND:
+                top--;
+                stack[top - 1] = stack[top - 1] && stack[top];
+            break;
+            case ST_TAGOP_OR:
+                top--;
+                stack[top - 1] = stack[top - 1] || stack[top];
+            break;
+            default:
+                assert(false);
+            break;
+        }
+    }
+
+    return top > 0 && stack[top - 1];
+}
+
+bool st_select_tagged(st_cl_config* config, st_test* tests, size_t num_tests)
+{
+    if (!config->tags) {
+        return true;
+    }
+
+    st_tag_expr expr;
+    if (!st_index_tags(&_state.tags, tests, num_tests) ||
+        !st_compile_tag_expr(config->tags, &_state.tags, &expr)) {
+        return false;
+    }
+
+    config->to_run = 0;
+    for (size_t n = 0; n < num_tests; n++) {
+        tests[n].run = (!config->only || tests[n].run) &&
+            st_eval_tag_expr(&expr, &tests[n].tagset);
+        if (tests[n].run) {
+            config->to_run++;
+        }
+    }
+
+    config->only = true;
+    if (0 == config->to_run) {
+        _ST_ERROR("%s "ST_LOC_NO_MATCH, _ST_ERROR_PREFIX);
+        return false;
+    }
+
+    return true;
+}
+
+void st_print_usage_info(const st_cl_arg* args, size_t num_args)
+{
+    size_t longest = 0;
+    for (size_t n = 0; n < num_args; n++) {
+        size_t len = strnlen(args[n].flag, ST_MAX_CLI_FLAG_STR_LEN) +
+            strnlen(args[n].s_flag, ST_MAX_CLI_S_FLAG_STR_LEN);
+        if (len > longest) {
+            longest = len;
+        }
+    }
+
+    (void)fprintf(stderr, "\n" WHITE(ST_LOC_USAGE":") "\n\n");
+
+    for (size_t n = 0; n < num_args; n++) {
+        (void)fprintf(stderr, "\t%s, %s  ", args[n].s_flag, args[n].flag);
+
+        size_t len = strnlen(args[n].flag, ST_MAX_CLI_FLAG_STR_LEN) +
+            strnlen(args[n].s_flag, ST_MAX_CLI_S_FLAG_STR_LEN);
+        if (len < longest) {
+            for (size_t j = len; j < longest; j++) {
+                (void)fprintf(stderr, " ");
+            }
+        }
+
+        (void)fprintf(stderr, "%s%s%s\n", args[n].usage,
+            args[n].usage[0] != '\0' ? " " : "", args[n].desc);
+    }
+
+    (void)fprintf(stderr, "\n");
+}
+
+void st_print_version_info(void)
+{
+    (void)printf("\n" ULINE("%s") " "ST_LOC_TEST_SUITE" " EMPH("("ST_LOC_BUILT_WITH)
+        " ", _state.app_name);
+    st_print_seatest_ansi(false);
+    (void)printf(EMPH("%s)")" \n\n", st_get_version_string());
+}
+
+void st_print_seatest_ansi(bool bold)
+{
+    static const struct {
+        unsigned char r;
+        unsigned char g;
+        unsigned char b;
+        char c;
+    } elements[] = {
+        { 65, 105, 238, 's'},
+        { 63, 125, 238, 'e'},
+        { 71, 145, 237, 'a'},
+        { 74, 165, 236, 't'},
+        { 77, 185, 235, 'e'},
+        { 80, 205, 234, 's'},
+        { 83, 225, 233, 't'},
+    };
+
+    for (size_t n = 0; n <_ST_COUNTOF(elements); n++) {
+        (void)printf("\x1b[%d;38;2;%03d;%03d;%03d;49;2m%c\x1b[0m", bold ? 1 : 0,
+            elements[n].r, elements[n].g, elements[n].b, elements[n].c);
+    }
+}
+
+bool st_is_cl_arg(const st_cl_arg* arg, const char* flag)
+{
+    /* compare the entire flag, so that e.g. --repeat doesn't match --repeat-until-fail. */
+    size_t len = strnlen(flag, ST_MAX_CLI_FLAG_STR_LEN + 1);
+    size_t flag_len = strnlen(arg->flag, ST_MAX_CLI_FLAG_STR_LEN);
+    size_t s_flag_len = strnlen(arg->s_flag, ST_MAX_CLI_S_FLAG_STR_LEN);
+    return (len == flag_len && 0 == st_strncmp(flag, arg->flag, flag_len)) ||
+           (len == s_flag_len && 0 == st_strncmp(flag, arg->s_flag, s_flag_len));
+}
+
+const st_cl_arg* st_find_cl_arg(const char* flag, const st_cl_arg* args, size_t num_args)
+{
+    for (size_t n = 0; n < num_args; n++) {
+        if (st_is_cl_arg(&args[n], flag)) {
+            return &args[n];
+        }
+    }
+    return NULL;
+}
+
+bool st_parse_cmd_line(int argc, char** argv, const st_cl_arg* args, size_t num_args,
+    st_test* tests, size_t num_tests, st_cl_config* config)
+{
+    if (!argv || !args || !tests || !config)
+        return false;
+
+    (void)memset(config, 0, sizeof(st_cl_config));
+
+    for (int n = 1; n < argc; n++) {
+        const st_cl_arg* cur = st_find_cl_arg(argv[n], args, num_args);
+        if (!cur) {
+            _ST_ERROR(ST_LOC_UNK_OPT" '%s'", argv[n]);
+            st_print_usage_info(args, num_args);
+            return false;
+        }
+        if (st_is_cl_arg(cur, ST_LOC_WAIT_FLAG)) {
+            config->wait = true;
+        } else if (st_is_cl_arg(cur, ST_LOC_ONLY_FLAG)) {
+            while (++n < argc) {
+                if (!argv[n] || !*argv[n])
+                    continue;
+                if (*argv[n] == '-') {
+                    n--; /* the next option. */
+                    break;
+                }
+                if (*argv[n] == '@') {
+                    _st_only_ctx ctx = {argv[n] + 1, tests, num_tests, config};
+                    if (!_st_for_each_line(argv[n] + 1, &_st_only_line, &ctx)) {
+                        return false;
+                    }
+                    continue;
+                }
+                const char* case_name = NULL;
+                st_test* test = _st_find_test_or_case(argv[n], tests, num_tests, &case_name);
+                if (!test) {
+                    _ST_ERROR(ST_LOC_INVAL_ARG" %s: '%s'", ST_LOC_ONLY_FLAG, argv[n]);
+                    st_print_usage_info(args, num_args);
+                    return false;
+                }
+                if (!_st_select_test(test, case_name, &config->to_run)) {
+                    _ST_ERROR("%s "ST_LOC_CASE_CONFLICT, _ST_ERROR_PREFIX, test->name,
+                        test->only_case, case_name);
+                    return false;
+                }
+            }
+            if (0 == config->to_run) {
+                _ST_ERROR(ST_LOC_VAL_EXPECT" '%s'", ST_LOC_ONLY_FLAG);
+                st_print_usage_info(args, num_args);
+                return false;
+            }
+            config->only = true;
+        } else if (st_is_cl_arg(cur, ST_LOC_FLTR_FLAG)) {
+            size_t added = 0;
+            while (++n < argc) {
+                if (!argv[n] || !*argv[n])
+                    continue;
+                if (*argv[n] == '-') {
+                    n--; /* the next option. */
+                    break;
+                }
+                if (!_st_add_filter(config, argv[n])) {
+                    st_free_filters(config);
+                    return false;
+                }
+                added++;
+            }
+            if (0 == added) {
+                _ST_ERROR(ST_LOC_VAL_EXPECT" '%s'", ST_LOC_FLTR_FLAG);
+                st_print_usage_info(args, num_args);
+                st_free_filters(config);
+                return false;
+            }
+        } else if (st_is_cl_arg(cur, ST_LOC_LIST_FLAG)) {
+            if (n + 1 < argc && argv[n + 1] && (0 == strcmp(argv[n + 1], ST_LOC_LIST_SUITES) ||
+                0 == strcmp(argv[n + 1], ST_LOC_LIST_TAGS))) {
+                (void)st_print_test_groups(tests, num_tests,
+                    0 == strcmp(argv[n + 1], ST_LOC_LIST_TAGS));
+            } else {
+                st_print_test_list(tests, num_tests);
+            }
+            return false;
+        } else if (st_is_cl_arg(cur, ST_LOC_TAGS_FLAG)) {
+            if (++n >= argc || !argv[n] || !*argv[n]) {
+                _ST_ERROR(ST_LOC_VAL_EXPECT" '%s'", ST_LOC_TAGS_FLAG);
+                st_print_usage_info(args, num_args);
+                return false;
+            }
+            config->tags = argv[n];
+        } else if (st_is_cl_arg(cur, ST_LOC_FAIL_FLAG)) {
+            _ST_DEBUG("will exit immediately upon any falied test due to %s",
+                ST_LOC_FAIL_FLAG);
+            _state.fail_early = true;
+        } else if (st_is_cl_arg(cur, ST_LOC_PIN_FLAG)) {
+            uint64_t cpu = 0ULL;
+            if (!_st_parse_cl_uint(argc, argv, &n, ST_LOC_PIN_FLAG, UINT32_MAX, &cpu)) {
+                st_print_usage_info(args, num_args);
+                return false;
+            }
+            config->pin = true;
+            config->cpu = (uint32_t)cpu;
+        } else if (st_is_cl_arg(cur, ST_LOC_WARM_FLAG)) {
+            uint64_t batches = 0ULL;
+            if (!_st_parse_cl_uint(argc, argv, &n, ST_LOC_WARM_FLAG, UINT32_MAX, &batches)) {
+                st_print_usage_info(args, num_args);
+                return false;
+            }
+            _state.bench_warmup = (uint32_t)batches;
+        } else if (st_is_cl_arg(cur, ST_LOC_RPT_FLAG)) {
+            uint64_t repeat = 0ULL;
+            if (!_st_parse_cl_uint(argc, argv, &n, ST_LOC_RPT_FLAG, ST_MAX_REPEAT, &repeat)) {
+                st_print_usage_info(args, num_args);
+                return false;
+            }
+            if (0ULL == repeat) {
+                _ST_ERROR(ST_LOC_INVAL_ARG" %s: '%s'", ST_LOC_RPT_FLAG, argv[n]);
+                st_print_usage_info(args, num_args);
+                return false;
+            }
+            config->repeat = (uint32_t)repeat;
+        } else if (st_is_cl_arg(cur, ST_LOC_RUF_FLAG)) {
+            config->until_fail = true;
+        } else if (st_is_cl_arg(cur, ST_LOC_RTRY_FLAG)) {
+            uint64_t retries = 0ULL;
+            if (!_st_parse_cl_uint(argc, argv, &n, ST_LOC_RTRY_FLAG, ST_MAX_RETRIES, &retries)) {
+                st_print_usage_info(args, num_args);
+                return false;
+            }
+            config->retries = (uint32_t)retries;
+        } else if (st_is_cl_arg(cur, ST_LOC_QUAR_FLAG)) {
+            if (++n >= argc || !argv[n] || !*argv[n] || *argv[n] == '-') {
+                _ST_ERROR(ST_LOC_VAL_EXPECT" '%s'", ST_LOC_QUAR_FLAG);
+                st_print_usage_info(args, num_args);
+                return false;
+            }
+            if (!st_load_quarantine(argv[n], tests, num_tests)) {
+                return false;
+            }
+        } else if (st_is_cl_arg(cur, ST_LOC_TMO_FLAG)) {
+            uint64_t timeout = 0ULL;
+            if (!_st_parse_cl_uint(argc, argv, &n, ST_LOC_TMO_FLAG, ST_MAX_TIMEOUT_SEC,
+                &timeout)) {
+                st_print_usage_info(args, num_args);
+                return false;
+            }
+            _state.timeout = (uint32_t)timeout;
+        } else if (st_is_cl_arg(cur, ST_LOC_MAXF_FLAG)) {
+            uint64_t max_failures = 0ULL;
+            if (!_st_parse_cl_uint(argc, argv, &n, ST_LOC_MAXF_FLAG, UINT32_MAX,
+                &max_failures)) {
+                st_print_usage_info(args, num_args);
+                return false;
+            }
+            _state.max_failures = (uint32_t)max_failures;
+        } else if (st_is_cl_arg(cur, ST_LOC_SEED_FLAG)) {
+            uint64_t seed = 0ULL;
+            if (!_st_parse_cl_uint(argc, argv, &n, ST_LOC_SEED_FLAG, UINT64_MAX, &seed)) {
+                st_print_usage_info(args, num_args);
+                return false;
+            }
+            _state.seed = seed;
+        } else if (st_is_cl_arg(cur, ST_LOC_UPD_FLAG)) {
+            _state.update_snapshots = true;
+        } else if (st_is_cl_arg(cur, ST_LOC_RRF_FLAG)) {
+            config->rerun_failed = true;
+        } else if (st_is_cl_arg(cur, ST_LOC_RSM_FLAG)) {
+            config->resume = true;
+        } else if (st_is_cl_arg(cur, ST_LOC_JRNL_FLAG)) {
+            if (++n >= argc || !argv[n] || !*argv[n] || *argv[n] == '-') {
+                _ST_ERROR(ST_LOC_VAL_EXPECT" '%s'", ST_LOC_JRNL_FLAG);
+                st_print_usage_info(args, num_args);
+                return false;
+            }
+            if (strnlen(argv[n], ST_MAX_JOURNAL_PATH_LEN) >= ST_MAX_JOURNAL_PATH_LEN) {
+                _ST_ERROR(ST_LOC_INVAL_ARG" %s: '%s'", ST_LOC_JRNL_FLAG, argv[n]);
+                st_print_usage_info(args, num_args);
+                return false;
+            }
+            config->journal = argv[n];
+        } else if (st_is_cl_arg(cur, ST_LOC_NOJ_FLAG)) {
+            config->no_journal = true;
+        } else if (st_is_cl_arg(cur, ST_LOC_VERS_FLAG)) {
+            st_print_version_info();
+            return false;
+        } else if (st_is_cl_arg(cur, ST_LOC_HELP_FLAG)) {
+            st_print_usage_info(args, num_args);
+            return false;
+        } else {
+            _ST_ERROR(ST_LOC_UNK_OPT" '%s'", cur->flag);
+            return false;
+        }
+    }
+
+    /* the failures of a repeated test are counted (to find flaky tests), not retried. */
+    bool repeats = config->repeat > 1U || (config->until_fail && 0U == config->repeat);
+    if (config->retries > 0U && repeats) {
+        _ST_ERROR(ST_LOC_FLAG_CONFLICT, ST_LOC_RTRY_FLAG,
+            config->repeat > 1U ? ST_LOC_RPT_FLAG : ST_LOC_RUF_FLAG);
+        st_print_usage_info(args, num_args);
+        return false;
+    }
+
+    /* both continue the previous journal, which this run would leave stale. */
+    if (config->no_journal && (config->resume || config->rerun_failed)) {
+        _ST_ERROR(ST_LOC_FLAG_CONFLICT, ST_LOC_NOJ_FLAG,
+            config->resume ? ST_LOC_RSM_FLAG : ST_LOC_RRF_FLAG);
+        st_print_usage_info(args, num_args);
+        return false;
+    }
+    return true;
+}
+
+bool st_getchar(char* input) {
+#if defined(__WIN__)
+    if (input)
+        *input = (char)_getch();
+     return true;
+#else /* !__WIN__ */
+    struct termios cur = {0};
+    if (0 != tcgetattr(STDIN_FILENO, &cur))
+        return false;
+
+    struct termios new = cur;
+    new.c_lflag &= ~(tcflag_t)(ICANON | ECHO);
+
+    if (0 != tcsetattr(STDIN_FILENO, TCSANOW, &new))
+        return false;
+
+    int ch = getchar();
+
+    if (NULL != input)
+        *input = (char)ch;
+
+    return 0 == tcsetattr(STDIN_FILENO, TCSANOW, &cur) ? true : false;
+#endif
+}
+
+void st_wait_for_keypress(void)
+{
+    (void)printf(WHITEB(ST_LOC_PRESS_KEY"\n"));
+    bool get = st_getchar(NULL);
+   _ST_UNUSED(get);
+}
+
+void st_timer_begin(st_timer* timer)
+{
+    (void)st_msec_since(NULL, timer);
+}
+
+double st_timer_elapsed(const st_timer* timer)
+{
+    st_timer now;
+    return st_msec_since(timer, &now);
+}
+
+long st_timer_getres(void)
+{
+    long retval = 0L;
+#if !defined(__WIN__)
+    struct timespec res;
+    int get = clock_getres(ST_INTERVALCLOCK, &res);
+    if (0 == get)
+        retval = res.tv_nsec;
+#else /* __WIN__ */
+    LARGE_INTEGER perf_freq;
+    (void)QueryPerformanceFrequency(&perf_freq);
+    if (perf_freq.QuadPart <= 0)
+        retval = 0L;
+    else
+        retval = (long)(ceil(((double)perf_freq.QuadPart) / 1e9));
+#endif
+    return retval;
+}
+
+uint64_t st_clock_nsec(void)
+{
+#if !defined(__WIN__)
+    struct timespec ts = {0};
+    if (0 != clock_gettime(ST_INTERVALCLOCK, &ts))
+        return 0ULL;
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+#else /* __WIN__ */
+    static LARGE_INTEGER perf_freq = {0};
+    if (perf_freq.QuadPart <= 0)
+        (void)QueryPerformanceFrequency(&perf_freq);
+    LARGE_INTEGER counter = {0};
+    (void)QueryPerformanceCounter(&counter);
+    uint64_t freq = (uint64_t)perf_freq.QuadPart;
+    uint64_t ticks = (uint64_t)counter.QuadPart;
+    return ((ticks / freq) * 1000000000ULL) + (((ticks % freq) * 1000000000ULL) / freq);
+#endif
+}
+
+st_section* st_section_enter(st_section* section)
+{
+    section->parent = _tstate.section;
+    _tstate.section = section;
+    section->started = st_clock_nsec();
+    return section;
+}
+
+st_section* st_section_leave(st_section* section)
+{
+    uint64_t nsec = st_clock_nsec() - section->started;
+    _tstate.section = section->parent;
+
+    /* retain only the slowest ST_SECTION_TOP_N sections. */
+    size_t slot = _tstate.num_sections;
+    if (slot >= ST_SECTION_TOP_N) {
+        slot = 0;
+        for (size_t n = 1; n < ST_SECTION_TOP_N; n++) {
+            if (_tstate.sections[n].nsec < _tstate.sections[slot].nsec)
+                slot = n;
+        }
+        if (_tstate.sections[slot].nsec >= nsec)
+            return NULL;
+    } else {
+        _tstate.num_sections++;
+    }
+
+    st_section_rec* rec = &_tstate.sections[slot];
+    rec->name     = section->name;
+    rec->parent   = section->parent ? section->parent->name : NULL;
+    rec->nsec     = nsec;
+    rec->errors   = section->errors;
+    rec->warnings = section->warnings;
+
+    return NULL;
+}
+
+const char* st_section_on_failure(bool fatal)
+{
+    st_section* section = _tstate.section;
+    if (!section)
+        return "";
+
+    if (fatal)
+        section->errors++;
+    else
+        section->warnings++;
+
+    (void)snprintf(_tstate.section_label, ST_MAX_SECTION_LABEL_LEN, " [%s]",
+        section->name ? section->name : "");
+    return _tstate.section_label;
+}
+
+void st_eval_failed(const char* name, const char* expr, uint32_t line, int color, bool fatal)
+{
+    if (st_output_muted()) {
+        return;
+    }
+    if (st_failures_suppressed()) {
+        (void)st_section_on_failure(fatal);
+        _tstate.suppressed++;
+        return;
+    }
+
+    _tstate.failures++;
+    __ST_MESSAGE(ST_LOC_INDENT _ESC_SEQ("0;38;5;%d", "%s (" ST_LOC_LINE " %"PRIu32")%s:")
+        _ESC_RST DGRAY(" " ST_LOC_EXPRESSION) WHITE(" '%s'") DGRAY(" " ST_LOC_IS_FALSE "\n"),
+        color, name, line, st_section_on_failure(fatal), expr);
+}
+
+void st_cmp_failed(const st_cmp_site* site, const void* lhs, const void* rhs)
+{
+    if (!st_failures_suppressed()) {
+        char lhs_str[ST_MAX_VALUE_STR_LEN] = {0};
+        char rhs_str[ST_MAX_VALUE_STR_LEN] = {0};
+        _st_format_elem(lhs, site->lhs_size, site->lhs_kind, lhs_str);
+        _st_format_elem(rhs, site->rhs_size, site->rhs_kind, rhs_str);
+
+        /* a literal operand already reads as its value. */
+        bool show_lhs = 0 != strcmp(site->lhs_expr, lhs_str);
+        bool show_rhs = 0 != strcmp(site->rhs_expr, rhs_str);
+        if (show_lhs && show_rhs) {
+            _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_OPERANDS, site->lhs_expr, lhs_str,
+                site->rhs_expr, rhs_str);
+        } else if (show_lhs || show_rhs) {
+            _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_OPERAND,
+                show_lhs ? site->lhs_expr : site->rhs_expr, show_lhs ? lhs_str : rhs_str);
+        }
+    }
+
+    /* comparison evaluators are fatal, as _ST_EVALUATE_EXPR. */
+    st_eval_failed(site->name, site->text, site->line, 196, true);
+}
+
+void st_for_all_fail(st_for_all* all, size_t index)
+{
+    if (all->count < ST_MAX_FOR_ALL_INDICES) {
+        all->first[all->count] = index;
+    }
+    all->count++;
+}
+
+void st_for_all_failed(const st_for_all* all, size_t count, const char* index,
+    const char* predicate, bool expected, uint32_t line)
+{
+    char list[ST_MAX_FOR_ALL_INDICES * 22] = {0};
+    size_t listed = all->count < ST_MAX_FOR_ALL_INDICES ? all->count : ST_MAX_FOR_ALL_INDICES;
+    size_t pos    = 0;
+    for (size_t n = 0; n < listed && pos < sizeof(list); n++) {
+        int len = snprintf(list + pos, sizeof(list) - pos, "%s%zu", n > 0 ? ", " : "",
+            all->first[n]);
+        if (len < 0) {
+            break;
+        }
+        pos += (size_t)len;
+    }
+
+    _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_FOR_ALL, predicate,
+        expected ? ST_LOC_FALSE : ST_LOC_TRUE, all->count, count, index, list,
+        all->count > listed ? ", ..." : "");
+
+    /* as ST_FALSE, ST_FOR_NONE reads as the negation of its predicate. */
+    char text[ST_MAX_EVAL_STR_LEN] = {0};
+    if (!expected) {
+        (void)snprintf(text, sizeof(text), "!(%s)", predicate);
+    }
+    st_eval_failed(expected ? "ST_FOR_ALL" : "ST_FOR_NONE", expected ? predicate : text,
+        line, 196, true);
+}
+
+bool st_clock_gettime(int clock, time_t* tbuf, double* msecbuf)
+{
+    if (tbuf) {
+#if defined(ST_MSEC_POSIX)
+        struct timespec ts = {0};
+        int ret = clock_gettime(clock, &ts);
+        if (0 == ret) {
+            *tbuf = ts.tv_sec;
+            if (msecbuf) {
+                *msecbuf = (double)(ts.tv_nsec) / 1e6;
+            }
+        } else {
+            if (msecbuf) {
+                *msecbuf = 0.0;
+            }
+            return false;
+        }
+#elif defined(ST_MSEC_WIN32)
+       _ST_UNUSED(clock);
+        static const ULONGLONG uepoch = (ULONGLONG)116444736e9;
+
+        FILETIME ftutc = {0};
+        GetSystemTimePreciseAsFileTime(&ftutc);
+
+        ULARGE_INTEGER ftnow = {0};
+        ftnow.HighPart = ftutc.dwHighDateTime;
+        ftnow.LowPart  = ftutc.dwLowDateTime;
+        ftnow.QuadPart = (ULONGLONG)((ftnow.QuadPart - uepoch) / 10000000ULL);
+
+        *tbuf = (time_t)ftnow.QuadPart;
+
+        SYSTEMTIME st = {0};
+        if (FileTimeToSystemTime(&ftutc, &st)) {
+            if (msecbuf)
+                *msecbuf = (double)st.wMilliseconds;
+        } else {
+            if (msecbuf)
+                *msecbuf = 0.0;
+            return false;
+        }
+#else
+       _ST_UNUSED(clock);
+        time(tbuf);
+        if (msecbuf)
+            *msecbuf = 0.0;
+#endif
+        return true;
+    }
+    return false;
+}
+
+double st_msec_since(const st_timer* when, st_timer* out)
+{
+    if (out == NULL)
+        return 0.0;
+
+#if !defined(__WIN__)
+    out->sec = 0;
+    out->msec = 0.0;
+
+    bool gettime = st_clock_gettime(ST_INTERVALCLOCK, &out->sec, &out->msec);
+    if (when == NULL || !gettime || (out->sec < when->sec ||
+        (out->sec == when->sec && out->msec < when->msec)))
+        return 0.0;
+
+
+
+    return ((((double)out->sec) * 1e3) + out->msec) -
+           ((((double)when->sec) * 1e3) + when->msec);
+#else /* __WIN__ */
+    LARGE_INTEGER perf_freq = {0};
+
+    // TODO: store somewhere in static storage
+    (void)QueryPerformanceFrequency(&perf_freq);
+    (void)QueryPerformanceCounter(&out->counter);
+
+    if (when == NULL || out->counter.QuadPart <= when->counter.QuadPart)
+        return 0.0;
+
+    double msec_ratio = ((double)perf_freq.QuadPart) / 1e3;
+    return ((double)(out->counter.QuadPart - when->counter.QuadPart)) / msec_ratio;
+#endif
+}
+
+st_benchmark st_benchmark_init(const char* name, uint64_t iterations)
+{
+    st_benchmark bench = {0};
+    bench.name       = name;
+    bench.iterations = iterations > 0ULL ? iterations : 1ULL;
+    bench.before.cpu = -1;
+    return bench;
+}
+
+bool st_benchmark_next(st_benchmark* bench)
+{
+    uint64_t now = st_clock_nsec();
+
+    if (bench->measuring) {
+        _st_benchmark_report(bench, now - bench->started);
+        return false;
+    }
+
+    if (bench->batch > 0ULL) {
+        /* a warmup batch has completed. */
+        for (size_t n = 1; n < ST_BENCH_WARMUP_WINDOW; n++)
+            bench->window[n - 1] = bench->window[n];
+        bench->window[ST_BENCH_WARMUP_WINDOW - 1] = now - bench->started;
+        bench->warmups++;
+    }
+
+    bool stable = false;
+    if (bench->warmups >= ST_BENCH_WARMUP_WINDOW) {
+        uint64_t fastest = bench->window[0];
+        uint64_t slowest = bench->window[0];
+        for (size_t n = 1; n < ST_BENCH_WARMUP_WINDOW; n++) {
+            if (bench->window[n] < fastest)
+                fastest = bench->window[n];
+            if (bench->window[n] > slowest)
+                slowest = bench->window[n];
+        }
+        stable = (double)(slowest - fastest) * 100.0 <= ST_BENCH_STABLE_PCT * (double)fastest;
+    }
+
+    if (!stable && bench->warmups < _state.bench_warmup) {
+        bench->batch = bench->iterations / ST_BENCH_WARMUP_DIVISOR;
+        if (bench->batch == 0ULL)
+            bench->batch = 1ULL;
+    } else {
+        if (!stable && _state.bench_warmup > 0U)
+            bench->noisy |= ST_NOISY_UNSTABLE;
+        bench->measuring = true;
+        bench->batch     = bench->iterations;
+        (void)st_get_cpu_freq(st_get_current_cpu(), &bench->before);
+    }
+
+    bench->remaining = bench->batch - 1ULL;
+    bench->started   = st_clock_nsec();
+    return true;
+}
+
+st_digest st_digest_begin(void)
+{
+    _st_crc32c_init();
+
+    st_digest digest = {
+        .acc = {_ST_XXH_PRIME32_3, _ST_XXH_PRIME64_1, _ST_XXH_PRIME64_2, _ST_XXH_PRIME64_3,
+            _ST_XXH_PRIME64_4, _ST_XXH_PRIME32_2, _ST_XXH_PRIME64_5, _ST_XXH_PRIME32_1},
+        .crc = UINT32_MAX
+    };
+    return digest;
+}
+
+void st_digest_update(st_digest* digest, const void* data, size_t size)
+{
+    const uint8_t* input = data;
+    if (0 == size) {
+        return;
+    }
+
+    digest->total += size;
+    digest->crc = _st_crc32c_update(digest->crc, input, size);
+
+    /* as in the reference implementation of XXH3, input is consumed one buffer's
+     * worth of stripes at a time, leaving at least one byte (and, if input is
+     * consumed directly, a copy of the last stripe) for the final stripe. */
+    if (digest->buffered + size <= _ST_DIGEST_BUFFER_SIZE) {
+        (void)memcpy(digest->buffer + digest->buffered, input, size);
+        digest->buffered += size;
+        return;
+    }
+
+    if (digest->buffered > 0) {
+        size_t fill = _ST_DIGEST_BUFFER_SIZE - digest->buffered;
+        (void)memcpy(digest->buffer + digest->buffered, input, fill);
+        input += fill;
+        size -= fill;
+        _st_xxh3_consume(digest, digest->buffer, _ST_DIGEST_BUFFER_SIZE / _ST_XXH_STRIPE_LEN);
+        digest->buffered = 0;
+    }
+
+    if (size > _ST_DIGEST_BUFFER_SIZE) {
+        do {
+            _st_xxh3_consume(digest, input, _ST_DIGEST_BUFFER_SIZE / _ST_XXH_STRIPE_LEN);
+            input += _ST_DIGEST_BUFFER_SIZE;
+            size -= _ST_DIGEST_BUFFER_SIZE;
+        } while (size > _ST_DIGEST_BUFFER_SIZE);
+        (void)memcpy(digest->buffer + _ST_DIGEST_BUFFER_SIZE - _ST_XXH_STRIPE_LEN,
+            input - _ST_XXH_STRIPE_LEN, _ST_XXH_STRIPE_LEN);
+    }
+
+    (void)memcpy(digest->buffer, input, size);
+    digest->buffered = size;
+}
+
+uint64_t st_digest_xxh3(const st_digest* digest)
+{
+    if (digest->total <= _ST_XXH_MID_SIZE_MAX) {
+        return _st_xxh3_short(digest->buffer, digest->buffered);
+    }
+
+    /* the digest is left as is, so that it may be updated further. */
+    st_digest last = *digest;
+    const uint8_t* secret = _st_xxh3_secret;
+    if (last.buffered >= _ST_XXH_STRIPE_LEN) {
+        size_t stripes = (last.buffered - 1) / _ST_XXH_STRIPE_LEN;
+        _st_xxh3_consume(&last, last.buffer, stripes);
+        _st_xxh3_accumulate(last.acc, last.buffer + last.buffered - _ST_XXH_STRIPE_LEN,
+            secret + _ST_XXH_SECRET_SIZE - _ST_XXH_STRIPE_LEN - _ST_XXH_SECRET_LASTACC_START, 1);
+    } else {
+        /* the final stripe overlaps input that was consumed by the last update. */
+        uint8_t stripe[_ST_XXH_STRIPE_LEN];
+        size_t catchup = _ST_XXH_STRIPE_LEN - last.buffered;
+        (void)memcpy(stripe, last.buffer + _ST_DIGEST_BUFFER_SIZE - catchup, catchup);
+        (void)memcpy(stripe + catchup, last.buffer, last.buffered);
+        _st_xxh3_accumulate(last.acc, stripe,
+            secret + _ST_XXH_SECRET_SIZE - _ST_XXH_STRIPE_LEN - _ST_XXH_SECRET_LASTACC_START, 1);
+    }
+
+    uint64_t result = last.total * _ST_XXH_PRIME64_1;
+    for (size_t n = 0; n < 4; n++) {
+        const uint8_t* key = secret + _ST_XXH_SECRET_MERGEACCS_START + n * 16;
+        result += _st_mul128_fold64(last.acc[2 * n] ^ _st_read64le(key),
+            last.acc[2 * n + 1] ^ _st_read64le(key + 8));
+    }
+
+    return _st_xxh3_avalanche(result);
+}
+
+uint32_t st_digest_crc32c(const st_digest* digest)
+{
+    return ~digest->crc;
+}
+
+bool st_digest_equal(const st_digest* digest, const char* expected_hex)
+{
+    uint64_t xxh3 = st_digest_xxh3(digest);
+    uint32_t crc  = st_digest_crc32c(digest);
+
+    /* 16 hex digits name an XXH3 hash; 8, a CRC32C. */
+    size_t len     = expected_hex ? strnlen(expected_hex, 17) : 0;
+    uint64_t value = 0;
+    bool valid     = 16 == len || 8 == len;
+    for (size_t n = 0; valid && n < len; n++) {
+        int ch = tolower((unsigned char)expected_hex[n]);
+        if (!isxdigit(ch)) {
+            valid = false;
+            break;
+        }
+        value = (value << 4) | (uint64_t)(isdigit(ch) ? ch - '0' : ch - 'a' + 10);
+    }
+
+    if (valid && (16 == len ? value == xxh3 : value == crc)) {
+        return true;
+    }
+
+    if (!valid) {
+        _ST_ERROR(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_DIGEST_INVAL,
+            expected_hex ? expected_hex : "(null)");
+    }
+    _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_DIGEST_ACTUAL, digest->total,
+        _ST_PLURAL(ST_LOC_BYTE, digest->total), xxh3, crc);
+    return false;
+}
+
+st_testres st_check_property(const char* name, st_test_fn body, size_t num_cases)
+{
+    st_testres res = {.pass = true};
+    st_prop* prop  = &_tstate.prop;
+
+    if (!_st_prop_init(prop)) {
+        _ST_ERROR(ST_LOC_INDENT ST_LOC_PROP_NOMEM, name);
+        res.errors = 1;
+        res.pass   = false;
+        res.fatal  = true;
+        return res;
+    }
+
+    /* each property has its own stream of choices, so that the seed reproduces its
+     * cases regardless of which other tests are run. */
+    st_rng_seed(&prop->rng, _state.seed ^ st_hash_str(name));
+    prop->verbose       = false;
+    _tstate.in_property = true;
+
+    size_t failed_case = 0;
+    for (size_t n = 0; n < num_cases && 0 == failed_case; n++) {
+        _st_prop_reset(prop, 0, false);
+        _tstate.muted = true;
+        st_testres case_res = body();
+        _tstate.muted = false;
+
+        /* a warning (e.g. ST_EXPECT) falsifies a property, too. */
+        if (!case_res.pass) {
+            failed_case = n + 1;
+            (void)memcpy(prop->best, prop->choices, prop->pos * sizeof(uint64_t));
+            prop->num_best = prop->pos;
+        }
+    }
+
+    if (0 == failed_case) {
+        _tstate.in_property = false;
+        _ST_MESSAGE(ST_LOC_INDENT DGRAY(ST_LOC_PROP_PASSED), num_cases,
+            _ST_PLURAL(ST_LOC_CASE, num_cases), _state.seed);
+        return res;
+    }
+
+    size_t steps = _st_prop_shrink(prop, body);
+
+    /* replays the counterexample, this time printing the values generated and the
+     * evaluators that fail. */
+    (void)memcpy(prop->choices, prop->best, prop->num_best * sizeof(uint64_t));
+    _st_prop_reset(prop, prop->num_best, true);
+    prop->verbose = true;
+    res = body();
+    prop->verbose       = false;
+    _tstate.in_property = false;
+
+    if (res.pass) {
+        _ST_ERROR(ST_LOC_INDENT "%s", ST_LOC_PROP_FLAKY);
+        res.errors++;
+        res.pass  = false;
+        res.fatal = true;
+    }
+
+    _ST_ERROR(ST_LOC_INDENT ST_LOC_PROP_FAILED, failed_case, num_cases, steps,
+        _ST_PLURAL(ST_LOC_STEP, steps));
+    _ST_MESSAGE(ST_LOC_INDENT DGRAY(ST_LOC_PROP_REPRO), ST_LOC_SEED_FLAG, _state.seed,
+        ST_LOC_ONLY_FLAG, name);
+
+    return res;
+}
+
+uint64_t st_prop_draw(uint64_t max)
+{
+    return _st_prop_draw(max, NULL);
+}
+
+
+void* st_prop_alloc(size_t size)
+{
+    st_prop* prop = &_tstate.prop;
+    if (!_tstate.in_property || !prop->arena) {
+        return NULL;
+    }
+
+    size_t offset = (prop->arena_used + 15U) & ~(size_t)15U;
+    if (offset > ST_PROP_ARENA_SIZE || size > ST_PROP_ARENA_SIZE - offset) {
+        return NULL;
+    }
+
+    prop->arena_used = offset + size;
+    return prop->arena + offset;
+}
+
+int64_t st_gen_int(int64_t lo, int64_t hi)
+{
+    int64_t value = _st_gen_int(lo, hi);
+    if (_tstate.prop.verbose) {
+        _ST_MESSAGE(ST_LOC_INDENT DGRAY(ST_LOC_GIVEN " int:") " %"PRId64, value);
+    }
+    return value;
+}
+
+uint64_t st_gen_uint(uint64_t lo, uint64_t hi)
+{
+    if (lo > hi) {
+        uint64_t tmp = lo;
+        lo = hi;
+        hi = tmp;
+    }
+
+    uint64_t value = lo + st_prop_draw(hi - lo);
+    if (_tstate.prop.verbose) {
+        _ST_MESSAGE(ST_LOC_INDENT DGRAY(ST_LOC_GIVEN " uint:") " %"PRIu64, value);
+    }
+    return value;
+}
+
+double st_gen_double(double lo, double hi)
+{
+    if (lo > hi) {
+        double tmp = lo;
+        lo = hi;
+        hi = tmp;
+    }
+
+    /* a sign (if the range spans zero) and a fraction with 53 bits of precision. */
+    bool negative = lo < 0.0 && hi > 0.0 && 1ULL == st_prop_draw(1ULL);
+    double frac   = (double)st_prop_draw(UINT64_C(1) << 53) / (double)(UINT64_C(1) << 53);
+
+    double value = 0.0;
+    if (lo >= 0.0) {
+        value = lo + frac * hi - frac * lo;
+    } else if (hi <= 0.0) {
+        value = hi - frac * hi + frac * lo;
+    } else {
+        value = negative ? frac * lo : frac * hi;
+    }
+    value = value < lo ? lo : value > hi ? hi : value;
+
+    if (_tstate.prop.verbose) {
+        _ST_MESSAGE(ST_LOC_INDENT DGRAY(ST_LOC_GIVEN " double:") " %.17g", value);
+    }
+    return value;
+}
+
+bool st_gen_bool(void)
+{
+    bool value = 1ULL == st_prop_draw(1ULL);
+    if (_tstate.prop.verbose) {
+        _ST_MESSAGE(ST_LOC_INDENT DGRAY(ST_LOC_GIVEN " bool:") " %s",
+            value ? "true" : "false");
+    }
+    return value;
+}
+
+const char* st_gen_string(size_t max_len, const char* alphabet)
+{
+    size_t alpha_len = alphabet ? strlen(alphabet) : 0;
+    if (alphabet && 0 == alpha_len) {
+        max_len = 0;
+    }
+
+    char* str = _st_prop_reserve(sizeof(char), 1, &max_len);
+    if (!str) {
+        return "";
+    }
+
+    size_t len    = 0;
+    size_t target = _st_prop_target_len(max_len);
+    while (_st_prop_more(len, max_len, target)) {
+        str[len++] = alphabet ? alphabet[st_prop_draw(alpha_len - 1)]
+                              : (char)(' ' + st_prop_draw('~' - ' '));
+    }
+    str[len] = '\0';
+    _tstate.prop.arena_used += len + 1;
+
+    if (_tstate.prop.verbose) {
+        _ST_MESSAGE(ST_LOC_INDENT DGRAY(ST_LOC_GIVEN " string:") " \"%.*s\"%s",
+            ST_PROP_MAX_PRINTED, str, len > ST_PROP_MAX_PRINTED ? "..." : "");
+    }
+    return str;
+}
+
+const uint8_t* st_gen_bytes(size_t* len, size_t max_len)
+{
+    *len = 0;
+
+    uint8_t* buf = _st_prop_reserve(sizeof(uint8_t), 1, &max_len);
+    if (!buf) {
+        static const uint8_t empty = 0;
+        return &empty;
+    }
+
+    size_t target = _st_prop_target_len(max_len);
+    while (_st_prop_more(*len, max_len, target)) {
+        buf[(*len)++] = (uint8_t)st_prop_draw(UINT8_MAX);
+    }
+    _tstate.prop.arena_used += *len + 1;
+
+    if (_tstate.prop.verbose) {
+        __ST_MESSAGE(ST_LOC_INDENT DGRAY(ST_LOC_GIVEN " bytes (%zu):"), *len);
+        for (size_t n = 0; n < *len && n < ST_PROP_MAX_PRINTED; n++) {
+            __ST_MESSAGE(" %02"PRIx8, buf[n]);
+        }
+        __ST_MESSAGE("%s\n", *len > ST_PROP_MAX_PRINTED ? " ..." : "");
+    }
+    return buf;
+}
+
+int64_t* st_gen_int_array(size_t* len, size_t max_len, int64_t lo, int64_t hi)
+{
+    *len = 0;
+
+    int64_t* arr = _st_prop_reserve(sizeof(int64_t), sizeof(int64_t), &max_len);
+    if (!arr) {
+        static int64_t empty = 0;
+        return &empty;
+    }
+
+    size_t target = _st_prop_target_len(max_len);
+    while (_st_prop_more(*len, max_len, target)) {
+        arr[(*len)++] = _st_gen_int(lo, hi);
+    }
+    _tstate.prop.arena_used += (*len + 1) * sizeof(int64_t);
+
+    if (_tstate.prop.verbose) {
+        __ST_MESSAGE(ST_LOC_INDENT DGRAY(ST_LOC_GIVEN " array (%zu):") " [", *len);
+        for (size_t n = 0; n < *len && n < ST_PROP_MAX_PRINTED; n++) {
+            __ST_MESSAGE("%s%"PRId64, n > 0 ? ", " : "", arr[n]);
+        }
+        __ST_MESSAGE("%s]\n", *len > ST_PROP_MAX_PRINTED ? ", ..." : "");
+    }
+    return arr;
+}
+
+bool st_output_muted(void)
+{
+    return _tstate.muted;
+}
+
+bool st_failures_suppressed(void)
+{
+    return _state.max_failures > 0U && _tstate.failures >= _state.max_failures;
+}
+
+void st_rng_seed(st_rng* rng, uint64_t seed)
+{
+    /* splitmix64, as recommended by the authors of xoshiro. */
+    for (size_t n = 0; n < 4; n++) {
+        seed += UINT64_C(0x9e3779b97f4a7c15);
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+        z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+        rng->s[n] = z ^ (z >> 31);
+    }
+}
+
+uint64_t st_rng_next(st_rng* rng)
+{
+    uint64_t* s = rng->s;
+    uint64_t x  = s[1] * 5U;
+    uint64_t result = ((x << 7) | (x >> 57)) * 9U;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3]  = (s[3] << 45) | (s[3] >> 19);
+
+    return result;
+}
+
+bool st_pin_thread_to_cpu(uint32_t cpu)
+{
+#if defined(__linux__)
+    if (cpu >= CPU_SETSIZE) {
+        _ST_REPORT_ERROR(ST_E_INVALID);
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (0 != sched_setaffinity(0, sizeof(set), &set)) {
+        _ST_REPORT_ERROR(errno);
+        return false;
+    }
+    _ST_DEBUG("pinned thread to cpu %"PRIu32, cpu);
+    return true;
+#elif defined(__WIN__)
+    if (cpu >= (sizeof(DWORD_PTR) * 8)) {
+        _ST_REPORT_ERROR(ST_E_INVALID);
+        return false;
+    }
+    if (0 == SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu)) {
+        _ST_REPORT_ERROR(GetLastError());
+        return false;
+    }
+    return true;
+#else
+    _ST_UNUSED(cpu);
+    _ST_REPORT_ERROR(ST_E_UNSUPPORTED);
+    return false;
+#endif
+}
+
+int st_get_current_cpu(void)
+{
+#if defined(__linux__)
+    return sched_getcpu();
+#elif defined(__WIN__)
+    return (int)GetCurrentProcessorNumber();
+#else
+    return -1;
+#endif
+}
+
+#if defined(__linux__)
+static bool _st_read_sysfs_str(const char* fmt, int cpu, char* buf, size_t size)
+{
+    char path[ST_MAX_ERROR_STR_LEN] = {0};
+    (void)snprintf(path, sizeof(path), fmt, cpu);
+
+    FILE* file = fopen(path, "r");
+    if (!file)
+        return false;
+
+    bool read = NULL != fgets(buf, (int)size, file);
+    (void)fclose(file);
+
+    if (read)
+        buf[strcspn(buf, "\r\n")] = '\0';
+    return read;
+}
+
+static bool _st_read_sysfs_u64(const char* fmt, int cpu, uint64_t* value)
+{
+    char buf[ST_MAX_GOVERNOR_STR_LEN] = {0};
+    if (!_st_read_sysfs_str(fmt, cpu, buf, sizeof(buf)))
+        return false;
+    char* end = NULL;
+    *value = (uint64_t)strtoull(buf, &end, 10);
+    return end != buf;
+}
+#endif
+
+bool st_get_cpu_freq(int cpu, st_cpu_freq* freq)
+{
+    if (!freq)
+        return false;
+
+    (void)memset(freq, 0, sizeof(st_cpu_freq));
+    freq->cpu = cpu;
+
+#if defined(__linux__)
+    if (cpu < 0)
+        return false;
+
+    (void)_st_read_sysfs_str("/sys/devices/system/cpu/cpu%d/cpufreq/scaling_governor",
+        cpu, freq->governor, sizeof(freq->governor));
+    freq->have_throttle = _st_read_sysfs_u64(
+        "/sys/devices/system/cpu/cpu%d/thermal_throttle/core_throttle_count", cpu,
+        &freq->throttle_count);
+
+    return _st_read_sysfs_u64("/sys/devices/system/cpu/cpu%d/cpufreq/scaling_cur_freq",
+        cpu, &freq->khz);
+#else
+    return false;
+#endif
+}
+
+char* st_format_error_msg(int code, char message[ST_MAX_ERROR_STR_LEN])
+{
+    message[0] = '\0';
+
+#if !defined(__WIN__)
+    int finderr = -1;
+# if defined(__HAVE_XSI_STRERROR_R__)
+    finderr = strerror_r(code, message, ST_MAX_ERROR_STR_LEN);
+#  if defined(__HAVE_XSI_STRERROR_R_ERRNO__)
+    if (finderr == -1) {
+        finderr = errno;
+    }
+#  endif
+# elif defined(__HAVE_GNU_STRERROR_R__)
+    const char* tmp = strerror_r(code, message, ST_MAX_ERROR_STR_LEN);
+    if (tmp != message)
+        _st_strcpy(message, ST_MAX_ERROR_STR_LEN, tmp, strnlen(tmp, ST_MAX_ERROR_STR_LEN));
+# elif defined(__HAVE_STRERROR_S__)
+    finderr = (int)strerror_s(msg, ST_MAX_ERROR_STR_LEN, code);
+# else
+    const char* tmp = strerror(code);
+    _st_strcpy(message, ST_MAX_ERROR_STR_LEN, tmp, strnlen(tmp, ST_MAX_ERROR_STR_LEN);
+# endif
+# if defined(__HAVE_XSI_STRERROR_R__) || defined(__HAVE_STRERROR_S__)
+    assert(0 == finderr);
+    _ST_UNUSED(finderr);
+# else
+   _ST_UNUSED(finderr);
+# endif
+#else /* __WIN__ */
+    DWORD flags = FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS |
+                  FORMAT_MESSAGE_MAX_WIDTH_MASK;
+    DWORD fmt = FormatMessageA(flags, NULL, (DWORD)code, 0UL, message, ST_MAX_ERROR_STR_LEN, NULL);
+    assert(0UL != fmt);
+    if (fmt > 0UL) {
+        if (message[fmt - 1] == '\n' || message[fmt - 1] == ' ') {
+            message[fmt - 1] = '\0';
+        }
+    }
+#endif
+
+    return &message[0];
 }
 
 void st_sleep_msec(uint32_t msec)
 {
-    if (0U == msec) {
-        return;
+    if (0U == msec) {
+        return;
+    }
+#if !defined(__WIN__)
+    struct timespec ts = { msec / 1000, (msec % 1000) * 1000000 };
+    (void)nanosleep(&ts, NULL);
+#else /* __WIN__ */
+    (void)SleepEx((DWORD)msec, TRUE);
+#endif
+}
+
+bool st_sync_file(FILE* file)
+{
+#if !defined(__WIN__)
+    if (0 != fsync(fileno(file))) {
+        _ST_REPORT_ERROR(errno);
+        return false;
+    }
+#else /* __WIN__ */
+    if (0 != _commit(_fileno(file))) {
+        _ST_REPORT_ERROR(errno);
+        return false;
+    }
+#endif
+    return true;
+}
+
+char* st_getcwd(void)
+{
+#if !defined(__WIN__)
+# if defined(__linux__) && defined(_GNU_SOURCE)
+    return get_current_dir_name();
+# else
+    return getcwd(NULL, 0);
+# endif
+#else /* __WIN__ */
+    return _getcwd(NULL, 0);
+#endif
+}
+
+bool st_get_avail_fs_bytes(const char* restrict path, uint64_t* bytes)
+{
+    if (bytes) {
+        *bytes = 0;
+    }
+    if (!bytes || !path || !*path) {
+        _ST_REPORT_ERROR(ST_E_INVALID);
+        return false;
+    }
+    _ST_DEBUG("getting available fs space (path: '%s')...", path);
+#if !defined(__WIN__)
+    struct statvfs stvfs = {0};
+    if (-1 == statvfs(path, &stvfs)) {
+        _ST_REPORT_ERROR(errno);
+        return false;
+    }
+    *bytes = (stvfs.f_bavail * (stvfs.f_frsize ? stvfs.f_frsize : stvfs.f_bsize));
+#else
+    ULARGE_INTEGER free_bytes = {0};
+    if (!GetDiskFreeSpaceExA(NULL, &free_bytes, NULL, NULL)) {
+        _ST_REPORT_ERROR(GetLastError());
+        return false;
+    }
+    *bytes = free_bytes.QuadPart;
+#endif
+    _ST_DEBUG("available fs space: %"PRIu64" bytes (%.02f GiB)", *bytes,
+        ((double)(*bytes) / 1024.0 / 1024.0));
+    return true;
+}
+
+bool st_have_inet_connection(void)
+{
+#if defined(__WIN__)
+    WSADATA wsad = {0};
+    (void)WSAStartup(MAKEWORD(2, 2), &wsad);
+#endif
+    struct addrinfo hints = {
+        .ai_flags = 0,
+        .ai_family = AF_INET,
+        .ai_socktype = SOCK_STREAM
+    };
+    struct addrinfo* result = NULL;
+    int get = getaddrinfo(ST_INET_TARGET_HOST, ST_INET_TARGET_SRV,
+        (const struct addrinfo*)&hints, &result);
+    if (0 != get) {
+        __ST_REPORT_ERROR(get, gai_strerror(get));
+#if defined(__WIN__)
+        (void)WSACleanup();
+#endif
+        return false;
+    }
+
+    _ST_DEBUG("getaddrinfo for %s [%s] OK; creating a suitable socket...",
+        ST_INET_TARGET_HOST, ST_INET_TARGET_SRV);
+
+    bool connected = false;
+    struct addrinfo* cur = result;
+    while (cur != NULL) {
+        st_descriptor sock = socket(AF_INET, cur->ai_socktype, cur->ai_protocol);
+        if (sock == ST_BAD_DESCRIPTOR) {
+            _ST_DEBUG("socket failed (%d)", st_last_sockerr());
+            cur = cur->ai_next;
+            continue;
+        }
+
+        _ST_DEBUG("got socket descriptor %d; connecting to %s [%s]...", (int)sock,
+            ST_INET_TARGET_HOST, ST_INET_TARGET_SRV);
+
+        const struct timeval timeout = {
+            .tv_sec = ST_INET_TIMEOUT,
+            .tv_usec = 0
+        };
+
+        (void)setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, (const void*)&timeout,
+            sizeof(timeout));
+        (void)setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const void*)&timeout,
+            sizeof(timeout));
+
+        int conn = connect(sock, (const struct sockaddr*)cur->ai_addr,
+            (st_optlen)cur->ai_addrlen);
+        if (conn == 0) {
+            _ST_DEBUG("connected to %s!", ST_INET_TARGET_HOST);
+            connected = true;
+        } else {
+            _ST_DEBUG("connect failed (%d)", st_last_sockerr());
+        }
+#if !defined(__WIN__)
+        close(sock);
+#else
+        closesocket(sock);
+#endif
+        if (connected) {
+            break;
+        }
+        cur = cur->ai_next;
+    }
+    freeaddrinfo(result);
+#if defined(__WIN__)
+    (void)WSACleanup();
+#endif
+    return connected;
+}
+
+static int _st_section_rec_cmp(const void* lhs, const void* rhs)
+{
+    const st_section_rec* l = (const st_section_rec*)lhs;
+    const st_section_rec* r = (const st_section_rec*)rhs;
+    return (l->nsec < r->nsec) - (l->nsec > r->nsec);
+}
+
+static st_testres _st_run_test(st_test* test)
+{
+    _tstate.section          = NULL;
+    _tstate.num_sections     = 0;
+    _tstate.noisy_benchmarks = 0;
+    _tstate.failures         = 0;
+    _tstate.suppressed       = 0;
+    test->timed_out          = false;
+    _st_scratch_reset(&_tstate.scratch);
+
+    st_testres res = test->cases ? _st_run_cases(test) : _st_run_test_once(test);
+
+    /* sections left via return from the test are not recorded. */
+    _tstate.section = NULL;
+
+    test->noisy_benchmarks = _tstate.noisy_benchmarks;
+    test->suppressed       = _tstate.suppressed;
+    test->num_sections     = _tstate.num_sections;
+    if (test->num_sections > 0) {
+        (void)memcpy(test->sections, _tstate.sections,
+            test->num_sections * sizeof(st_section_rec));
+        qsort(test->sections, test->num_sections, sizeof(st_section_rec),
+            &_st_section_rec_cmp);
+    }
+
+    return res;
+}
+
+static st_testres _st_run_test_once(st_test* test)
+{
+    st_testres res = {0};
+    uint32_t timeout = test->timeout > 0U ? test->timeout : _state.timeout;
+
+    if (test->setup && !test->setup()) {
+        _ST_ERROR(ST_LOC_INDENT "%s", ST_LOC_SETUP_FAILED);
+        res.errors = 1;
+        res.fatal  = true;
+        return res;
+    }
+
+    if (test->isolate) {
+        res = _st_run_isolated(test, timeout);
+    } else if (timeout > 0U && _state.watchdog.running) {
+        res = _st_call_test_fn(test, timeout);
+    } else {
+        res = test->fn();
+    }
+
+    /* a property interrupted by a timeout leaves its state behind. */
+    _tstate.in_property = false;
+    _tstate.muted       = false;
+
+    if (test->teardown) {
+        (void)test->teardown();
+    }
+
+    return res;
+}
+
+static st_testres _st_run_cases(st_test* test)
+{
+    st_testres res    = {.pass = true};
+    test->num_cases    = 0;
+    test->failed_cases = 0;
+
+    st_case_iter iter;
+    if (!st_cases_begin(&iter, test->cases)) {
+        _ST_ERROR(ST_LOC_INDENT ST_LOC_CASES_ERR, test->name, test->cases->path);
+        res.errors = 1;
+        res.pass   = false;
+        res.fatal  = true;
+        return res;
+    }
+
+    st_case cur;
+    char index[ST_MAX_CASE_STR_LEN] = {0};
+    while (st_cases_next(&iter, &cur)) {
+        const char* case_name = st_format_case(&cur, index);
+        if (*test->only_case && 0 != strcmp(case_name, test->only_case)) {
+            continue;
+        }
+
+        _tstate.current_case = &cur;
+        st_testres case_res  = _st_run_test_once(test);
+        _tstate.current_case = NULL;
+
+        test->num_cases++;
+        res.errors    += case_res.errors;
+        res.warnings  += case_res.warnings;
+        res.last_fail  = case_res.last_fail;
+        res.pass      &= case_res.pass;
+        if (case_res.fatal) {
+            res.fatal = true;
+            test->failed_cases++;
+            _ST_ERROR(ST_LOC_INDENT ST_LOC_CASE_FAILED, test->name, case_name);
+        }
+    }
+
+    bool unreadable = iter.error;
+    st_cases_end(&iter);
+
+    if (unreadable) {
+        _ST_ERROR(ST_LOC_INDENT ST_LOC_CASES_ERR, test->name, test->cases->path);
+        res.errors++;
+        res.pass  = false;
+        res.fatal = true;
+    }
+
+    if (*test->only_case && 0 == test->num_cases) {
+        _ST_ERROR(ST_LOC_INDENT ST_LOC_NO_CASE, test->name, test->only_case);
+        res.errors++;
+        res.pass  = false;
+        res.fatal = true;
+    }
+
+    return res;
+}
+
+static void _st_print_sections(const st_test* test)
+{
+    if (test->num_sections == 0)
+        return;
+
+    (void)printf(ST_LOC_INDENT DGRAY(ST_LOC_SLOWEST_SECT":") "\n");
+
+    for (size_t n = 0; n < test->num_sections; n++) {
+        const st_section_rec* rec = &test->sections[n];
+        (void)printf(ST_LOC_INDENT ST_LOC_INDENT DGRAY(ST_BULLET) " " WHITE("%s%s%s")
+            DGRAY(" %.03f"ST_LOC_MSEC_ABV), (rec->parent ? rec->parent : ""),
+            (rec->parent ? "/" : ""), rec->name ? rec->name : "",
+            (double)rec->nsec / 1e6);
+        if (rec->warnings > 0 && rec->errors > 0) {
+            (void)printf(FG_COLOR(0, 196, " (%d %s, %d %s)"), rec->warnings,
+                _ST_PLURAL(ST_LOC_WARNING, rec->warnings), rec->errors,
+                _ST_PLURAL(ST_LOC_ERROR, rec->errors));
+        } else if (rec->errors > 0) {
+            (void)printf(FG_COLOR(0, 196, " (%d %s)"), rec->errors,
+                _ST_PLURAL(ST_LOC_ERROR, rec->errors));
+        } else if (rec->warnings > 0) {
+            (void)printf(FG_COLOR(0, 208, " (%d %s)"), rec->warnings,
+                _ST_PLURAL(ST_LOC_WARNING, rec->warnings));
+        }
+        (void)printf("\n");
+    }
+}
+
+static bool _st_parse_cl_uint(int argc, char** argv, int* n, const char* flag,
+    uint64_t max, uint64_t* out)
+{
+    if (*n + 1 >= argc || !argv[*n + 1] || !*argv[*n + 1] || *argv[*n + 1] == '-') {
+        _ST_ERROR(ST_LOC_VAL_EXPECT" '%s'", flag);
+        return false;
+    }
+
+    const char* str = argv[++(*n)];
+    char* end = NULL;
+    errno = 0;
+    unsigned long long val = strtoull(str, &end, 10);
+    if (0 != errno || !end || *end != '\0' || val > max) {
+        _ST_ERROR(ST_LOC_INVAL_ARG" %s: '%s'", flag, str);
+        return false;
+    }
+
+    *out = (uint64_t)val;
+    return true;
+}
+
+static const char* _st_format_nsec(double nsec, char buf[ST_MAX_DURATION_STR_LEN])
+{
+    if (nsec < 1e3) {
+        (void)snprintf(buf, ST_MAX_DURATION_STR_LEN, "%.03f"ST_LOC_NSEC_ABV, nsec);
+    } else if (nsec < 1e6) {
+        (void)snprintf(buf, ST_MAX_DURATION_STR_LEN, "%.03f"ST_LOC_USEC_ABV, nsec / 1e3);
+    } else if (nsec < 1e9) {
+        (void)snprintf(buf, ST_MAX_DURATION_STR_LEN, "%.03f"ST_LOC_MSEC_ABV, nsec / 1e6);
+    } else {
+        (void)snprintf(buf, ST_MAX_DURATION_STR_LEN, "%.03f"ST_LOC_SEC_ABV, nsec / 1e9);
+    }
+    return buf;
+}
+
+static void _st_benchmark_report(st_benchmark* bench, uint64_t elapsed)
+{
+    st_cpu_freq after = {0};
+    int cpu = st_get_current_cpu();
+    (void)st_get_cpu_freq(cpu, &after);
+
+    const st_cpu_freq* before = &bench->before;
+    if (before->cpu >= 0 && cpu >= 0 && before->cpu != cpu)
+        bench->noisy |= ST_NOISY_MIGRATED;
+    if (before->khz > 0ULL && after.khz > 0ULL) {
+        uint64_t delta = before->khz > after.khz ? before->khz - after.khz
+                                                 : after.khz - before->khz;
+        if ((double)delta * 100.0 > ST_BENCH_FREQ_PCT * (double)before->khz)
+            bench->noisy |= ST_NOISY_FREQ;
+    }
+    if (before->have_throttle && after.have_throttle &&
+        after.throttle_count > before->throttle_count)
+        bench->noisy |= ST_NOISY_THROTTLE;
+
+    char total[ST_MAX_DURATION_STR_LEN] = {0};
+    char per_iter[ST_MAX_DURATION_STR_LEN] = {0};
+    (void)printf(ST_LOC_INDENT WHITE(ST_LOC_BENCHMARK" '%s': %"PRIu64" "ST_LOC_ITERATIONS
+        " "ST_LOC_IN" %s (%s/"ST_LOC_PER_ITER")"), bench->name ? bench->name : "",
+        bench->iterations, _st_format_nsec((double)elapsed, total),
+        _st_format_nsec((double)elapsed / (double)bench->iterations, per_iter));
+
+    if (before->khz > 0ULL && after.khz > 0ULL) {
+        (void)printf(DGRAY(" ["ST_LOC_CPU" %d, %"PRIu64" -> %"PRIu64" "ST_LOC_MHZ", "
+            ST_LOC_GOVERNOR": %s]"), cpu, before->khz / UINT64_C(1000), after.khz / UINT64_C(1000),
+            before->governor[0] != '\0' ? before->governor : "?");
+    }
+    (void)printf("\n");
+
+    if (bench->noisy != 0) {
+        static const struct {
+            int reason;
+            const char* desc;
+        } reasons[] = {
+            {ST_NOISY_UNSTABLE, ST_LOC_NOISY_UNSTBL},
+            {ST_NOISY_FREQ,     ST_LOC_NOISY_FREQ},
+            {ST_NOISY_THROTTLE, ST_LOC_NOISY_THRTL},
+            {ST_NOISY_MIGRATED, ST_LOC_NOISY_MIGRTD},
+        };
+
+        char desc[ST_MAX_ERROR_STR_LEN] = {0};
+        for (size_t n = 0; n < _ST_COUNTOF(reasons); n++) {
+            if ((bench->noisy & reasons[n].reason) == reasons[n].reason) {
+                if (desc[0] != '\0')
+                    _st_strcat(desc, sizeof(desc), "; ", 2);
+                _st_strcat(desc, sizeof(desc), reasons[n].desc,
+                    strnlen(reasons[n].desc, ST_MAX_ERROR_STR_LEN));
+            }
+        }
+
+        _tstate.noisy_benchmarks++;
+        _ST_WARNING(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_NOISY": %s", desc);
+    }
+}
+
+static int _st_double_cmp(const void* lhs, const void* rhs)
+{
+    double l = *(const double*)lhs;
+    double r = *(const double*)rhs;
+    return (l > r) - (l < r);
+}
+
+static void _st_run_test_repeatedly(st_test* test, uint32_t repeat, bool until_fail,
+    double* samples, size_t max_samples)
+{
+    st_repeat_stats* stats = &test->stats;
+    (void)memset(stats, 0, sizeof(st_repeat_stats));
+
+    st_testres worst = {0};
+    double mean = 0.0;
+    double m2   = 0.0;
+    size_t num_samples = 0;
+    st_rng rng;
+    st_rng_seed(&rng, _state.seed);
+
+    for (uint32_t r = 0; r < repeat; r++) {
+        uint64_t started = st_clock_nsec();
+        st_testres res = _st_run_test(test);
+        double msec = (double)(st_clock_nsec() - started) / 1e6;
+
+        /* the mean and variance are streamed (Welford), and the median is that of a
+         * uniform sample of the durations (reservoir sampling), so memory is bounded. */
+        stats->runs++;
+        double delta = msec - mean;
+        mean += delta / (double)stats->runs;
+        m2   += delta * (msec - mean);
+        stats->min = r == 0 || msec < stats->min ? msec : stats->min;
+        stats->max = r == 0 || msec > stats->max ? msec : stats->max;
+        if (num_samples < max_samples) {
+            samples[num_samples++] = msec;
+        } else {
+            uint64_t slot = _st_rng_bounded(&rng, r);
+            if (slot < max_samples) {
+                samples[slot] = msec;
+            }
+        }
+
+        if (res.fatal) {
+            stats->failed++;
+        } else if (!res.pass) {
+            stats->warned++;
+        } else {
+            stats->passed++;
+        }
+
+        /* the outcome of the test is that of its worst run. */
+        if (r == 0 || (res.fatal && !worst.fatal) || (!res.pass && worst.pass)) {
+            worst = res;
+        }
+
+        if (until_fail && res.fatal) {
+            break;
+        }
+    }
+
+    test->res = worst;
+    stats->stddev = sqrt(m2 / (double)stats->runs);
+
+    qsort(samples, num_samples, sizeof(double), &_st_double_cmp);
+    stats->median = (num_samples % 2) != 0 ? samples[num_samples / 2]
+        : (samples[(num_samples / 2) - 1] + samples[num_samples / 2]) / 2.0;
+
+    /* a spread of a few microseconds is timer jitter, however large relative to the
+     * duration of a short test. */
+    uint32_t outcomes = (stats->passed > 0) + (stats->warned > 0) + (stats->failed > 0);
+    stats->unstable = outcomes > 1 ||
+        (stats->stddev * 1e3 > ST_REPEAT_UNSTABLE_MIN_USEC &&
+        mean > 0.0 && (stats->stddev / mean) * 100.0 > ST_REPEAT_UNSTABLE_PCT);
+}
+
+static void _st_print_repeat_stats(const st_test* test)
+{
+    const st_repeat_stats* stats = &test->stats;
+    if (stats->runs < 2U)
+        return;
+
+    (void)printf(ST_LOC_INDENT WHITE("%"PRIu32" "ST_LOC_RUNS":") " "
+        FG_COLOR(0, 40, "%"PRIu32" "ST_LOC_PASSED) ", " FG_COLOR(0, 208, "%"PRIu32" "
+        ST_LOC_WARNED) ", " FG_COLOR(0, 196, "%"PRIu32" "ST_LOC_FAILED_L) DGRAY("; "
+        ST_LOC_MIN" %.03f"ST_LOC_MSEC_ABV", "ST_LOC_MEDIAN" %.03f"ST_LOC_MSEC_ABV", "
+        ST_LOC_MAX" %.03f"ST_LOC_MSEC_ABV", "ST_LOC_STDDEV" %.03f"ST_LOC_MSEC_ABV),
+        stats->runs, stats->passed, stats->warned, stats->failed, stats->min,
+        stats->median, stats->max, stats->stddev);
+
+    if (stats->unstable) {
+        (void)printf(" " FG_COLOR(1, 208, ST_LOC_UNSTABLE));
+    }
+
+    (void)printf("\n");
+}
+
+static void _st_retry_test(st_test* test, uint32_t retries)
+{
+    for (uint32_t r = 1U; r <= retries; r++) {
+        _ST_WARNING("\n"ST_LOC_INDENT ST_LOC_RETRYING" '%s' ("ST_LOC_ATTEMPT" %"PRIu32
+            " "ST_LOC_OF" %"PRIu32")...\n", test->name, r + 1U, retries + 1U);
+
+        st_testres res = _st_run_test(test);
+        test->attempts = r + 1U;
+        if (!res.fatal) {
+            test->res   = res;
+            test->flaky = true;
+            break;
+        }
+    }
+}
+
+static void _st_print_flagged_tests(const st_test* tests, size_t num_tests,
+    bool (*flagged)(const st_test*), const char* title)
+{
+    size_t count = 0;
+    for (size_t t = 0; t < num_tests; t++) {
+        if (flagged(&tests[t])) {
+            count++;
+        }
+    }
+
+    if (count > 0) {
+        _ST_WARNING("%s %s:\n", title, _ST_PLURAL(ST_LOC_TEST, count));
+        for (size_t t = 0; t < num_tests; t++) {
+            if (flagged(&tests[t])) {
+                _ST_WARNING("\t  " ST_BULLET " %s", tests[t].name);
+            }
+        }
+        (void)printf("\n");
+    }
+}
+
+static bool _st_for_each_line(const char* path, bool (*fn)(char*, void*), void* ctx)
+{
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        _ST_REPORT_ERROR(errno);
+        return false;
+    }
+
+    bool retval = true;
+    char line[ST_MAX_LINE_STR_LEN] = {0};
+    while (retval && NULL != fgets(line, (int)sizeof(line), file)) {
+        /* strip trailing whitespace; skip blank lines and comments. */
+        size_t len = strnlen(line, sizeof(line));
+        while (len > 0 && isspace((unsigned char)line[len - 1])) {
+            line[--len] = '\0';
+        }
+        const char* start = line;
+        while (isspace((unsigned char)*start)) {
+            start++;
+        }
+        if (*start != '\0' && *start != '#') {
+            retval = fn(line + (start - line), ctx);
+        }
+    }
+
+    (void)fclose(file);
+    return retval;
+}
+
+static bool _st_test_passed(const st_test* test)
+{
+    return test->res.pass || !test->res.fatal || test->res.skip || test->quarantined;
+}
+
+static bool _st_apply_journal(const char* path, st_cl_config* config, st_test* tests,
+    size_t num_tests)
+{
+    bool complete = false;
+    if (!st_journal_load(path, tests, num_tests, &complete)) {
+        _ST_ERROR("%s "ST_LOC_NO_JOURNAL, _ST_ERROR_PREFIX, path);
+        return false;
+    }
+
+    if (config->rerun_failed) {
+        /* failed tests are run again; the rest keep their previous results. */
+        for (size_t n = 0; n < num_tests; n++) {
+            if (tests[n].resumed && !_st_test_passed(&tests[n]) && !tests[n].run) {
+                tests[n].run = true;
+                config->to_run++;
+            }
+            if (tests[n].run && tests[n].resumed) {
+                (void)memset(&tests[n].res, 0, sizeof(st_testres));
+                tests[n].msec    = 0.0;
+                tests[n].resumed = false;
+            }
+        }
+        config->only = true;
+        return true;
+    }
+
+    size_t resumed = 0;
+    for (size_t n = 0; n < num_tests; n++) {
+        if (complete && tests[n].resumed) {
+            (void)memset(&tests[n].res, 0, sizeof(st_testres));
+            tests[n].msec    = 0.0;
+            tests[n].resumed = false;
+        }
+        if (tests[n].resumed && (!config->only || tests[n].run)) {
+            resumed++;
+        }
+    }
+
+    if (complete) {
+        _ST_WARNING("%s "ST_LOC_RUN_COMPLETE, _ST_WARN_PREFIX);
+    } else if (resumed > 0) {
+        _ST_WARNING("%s "ST_LOC_RESUMING, _ST_WARN_PREFIX, resumed,
+            _ST_PLURAL(ST_LOC_TEST, resumed));
+    }
+
+    return true;
+}
+
+static bool _st_test_timed_out(const st_test* test)
+{
+    return test->timed_out;
+}
+
+#if !defined(__WIN__)
+static void _st_on_timeout_signal(int sig)
+{
+    /* only records the hung thread's frames (backtrace() was called once up front, so
+     * that it doesn't load anything now); the watchdog thread prints them. */
+    (void)sig;
+    sigjmp_buf* jmp = _tstate.timeout_jmp;
+    if (!jmp) {
+        return;
+    }
+# if defined(__HAVE_BACKTRACE__)
+    _state.watchdog.num_frames = backtrace(_state.watchdog.frames, ST_MAX_BACKTRACE_FRAMES);
+# endif
+    _state.watchdog.captured = 1;
+    siglongjmp(*jmp, 1);
+}
+#endif
+
+static st_testres _st_call_test_fn(st_test* test, uint32_t timeout)
+{
+    st_testres res = {0};
+#if !defined(__WIN__)
+    /* the watchdog interrupts this thread with ST_TIMEOUT_SIGNAL if the test hangs;
+     * the test is abandoned (along with any resources it holds), and the run goes on.
+     * the signal is blocked except while the test runs, so that it's never taken with
+     * the watchdog's lock held, or once the test has returned. */
+    sigset_t sigs;
+    (void)sigemptyset(&sigs);
+    (void)sigaddset(&sigs, ST_TIMEOUT_SIGNAL);
+    (void)pthread_sigmask(SIG_BLOCK, &sigs, NULL);
+
+    _st_watchdog_arm(test, timeout);
+    sigjmp_buf jmp;
+    _tstate.timeout_jmp = &jmp;
+    if (0 == sigsetjmp(jmp, 1)) {
+        (void)pthread_sigmask(SIG_UNBLOCK, &sigs, NULL);
+        res = test->fn();
+        (void)pthread_sigmask(SIG_BLOCK, &sigs, NULL);
+    }
+    _tstate.timeout_jmp = NULL;
+
+    /* the test may have returned just as the watchdog fired; it's reported as timed
+     * out either way, and the pending signal is ignored once unblocked. */
+    if (_st_watchdog_disarm()) {
+        res.errors      = 1;
+        res.fatal       = true;
+        res.pass        = false;
+        test->timed_out = true;
+    }
+    (void)pthread_sigmask(SIG_UNBLOCK, &sigs, NULL);
+#else /* __WIN__ */
+    /* there's no way to safely abandon the test thread; the watchdog ends the process. */
+    _st_watchdog_arm(test, timeout);
+    res = test->fn();
+    (void)_st_watchdog_disarm();
+#endif
+    return res;
+}
+
+#if !defined(__WIN__)
+static void* _st_watchdog_thread(void* arg)
+#else /* __WIN__ */
+static DWORD WINAPI _st_watchdog_thread(LPVOID arg)
+#endif
+{
+    (void)arg;
+    st_watchdog* wd = &_state.watchdog;
+
+    _st_watchdog_lock();
+    while (!wd->quit) {
+        if (!wd->name) {
+            _st_watchdog_wait(0ULL);
+            continue;
+        }
+
+        uint64_t now = st_clock_nsec();
+        if (now < wd->deadline) {
+            _st_watchdog_wait(wd->deadline - now);
+            continue;
+        }
+
+        _st_watchdog_fire();
+        wd->name = NULL;
+    }
+    _st_watchdog_unlock();
+
+#if !defined(__WIN__)
+    return NULL;
+#else /* __WIN__ */
+    return 0;
+#endif
+}
+
+static bool _st_watchdog_start(const st_test* tests, size_t num_tests)
+{
+    bool needed = _state.timeout > 0U;
+    for (size_t n = 0; n < num_tests && !needed; n++) {
+        needed = tests[n].timeout > 0U;
+    }
+
+    if (!needed) {
+        return true;
+    }
+
+    st_watchdog* wd = &_state.watchdog;
+#if !defined(__WIN__)
+# if defined(__HAVE_BACKTRACE__)
+    /* the first call may load libgcc (and allocate), which the handler mustn't do. */
+    (void)backtrace(wd->frames, 1);
+# endif
+    struct sigaction action = {0};
+    action.sa_handler = &_st_on_timeout_signal;
+    (void)sigemptyset(&action.sa_mask);
+    if (0 != sigaction(ST_TIMEOUT_SIGNAL, &action, &wd->prev_action)) {
+        _ST_REPORT_ERROR(errno);
+        return false;
+    }
+
+    wd->target = pthread_self();
+    (void)pthread_mutex_init(&wd->lock, NULL);
+    (void)pthread_cond_init(&wd->cond, NULL);
+
+    int err = pthread_create(&wd->thread, NULL, &_st_watchdog_thread, NULL);
+    if (0 != err) {
+        _ST_REPORT_ERROR(err);
+        (void)pthread_cond_destroy(&wd->cond);
+        (void)pthread_mutex_destroy(&wd->lock);
+        (void)sigaction(ST_TIMEOUT_SIGNAL, &wd->prev_action, NULL);
+        return false;
+    }
+#else /* __WIN__ */
+    InitializeCriticalSection(&wd->lock);
+    InitializeConditionVariable(&wd->cond);
+
+    wd->thread = CreateThread(NULL, 0, &_st_watchdog_thread, NULL, 0, NULL);
+    if (!wd->thread) {
+        _ST_REPORT_ERROR((int)GetLastError());
+        DeleteCriticalSection(&wd->lock);
+        return false;
+    }
+#endif
+
+    wd->running = true;
+    return true;
+}
+
+static void _st_watchdog_stop(void)
+{
+    st_watchdog* wd = &_state.watchdog;
+    if (!wd->running) {
+        return;
+    }
+
+    _st_watchdog_lock();
+    wd->quit = true;
+    _st_watchdog_signal();
+    _st_watchdog_unlock();
+
+#if !defined(__WIN__)
+    (void)pthread_join(wd->thread, NULL);
+    (void)pthread_cond_destroy(&wd->cond);
+    (void)pthread_mutex_destroy(&wd->lock);
+    (void)sigaction(ST_TIMEOUT_SIGNAL, &wd->prev_action, NULL);
+#else /* __WIN__ */
+    (void)WaitForSingleObject(wd->thread, INFINITE);
+    (void)CloseHandle(wd->thread);
+    DeleteCriticalSection(&wd->lock);
+#endif
+
+    wd->running = false;
+    wd->quit    = false;
+}
+
+static void _st_watchdog_arm(const st_test* test, uint32_t timeout)
+{
+    st_watchdog* wd = &_state.watchdog;
+    _st_watchdog_lock();
+    wd->name     = test->name;
+    wd->fired    = false;
+    wd->timeout  = timeout;
+    wd->deadline = st_clock_nsec() + (uint64_t)timeout * UINT64_C(1000000000);
+    _st_watchdog_signal();
+    _st_watchdog_unlock();
+}
+
+static bool _st_watchdog_disarm(void)
+{
+    _st_watchdog_lock();
+    _state.watchdog.name = NULL;
+    bool fired = _state.watchdog.fired;
+    _st_watchdog_unlock();
+    return fired;
+}
+
+static void _st_watchdog_lock(void)
+{
+#if !defined(__WIN__)
+    (void)pthread_mutex_lock(&_state.watchdog.lock);
+#else /* __WIN__ */
+    EnterCriticalSection(&_state.watchdog.lock);
+#endif
+}
+
+static void _st_watchdog_unlock(void)
+{
+#if !defined(__WIN__)
+    (void)pthread_mutex_unlock(&_state.watchdog.lock);
+#else /* __WIN__ */
+    LeaveCriticalSection(&_state.watchdog.lock);
+#endif
+}
+
+static void _st_watchdog_signal(void)
+{
+#if !defined(__WIN__)
+    (void)pthread_cond_signal(&_state.watchdog.cond);
+#else /* __WIN__ */
+    WakeConditionVariable(&_state.watchdog.cond);
+#endif
+}
+
+static void _st_watchdog_wait(uint64_t nsec)
+{
+    /* must be called with the lock held; 0 waits until signaled. */
+#if !defined(__WIN__)
+    if (0ULL == nsec) {
+        (void)pthread_cond_wait(&_state.watchdog.cond, &_state.watchdog.lock);
+        return;
+    }
+
+    struct timespec until = {0};
+    (void)clock_gettime(CLOCK_REALTIME, &until);
+    uint64_t total = (uint64_t)until.tv_nsec + nsec;
+    until.tv_sec  += (time_t)(total / UINT64_C(1000000000));
+    until.tv_nsec  = (long)(total % UINT64_C(1000000000));
+    (void)pthread_cond_timedwait(&_state.watchdog.cond, &_state.watchdog.lock, &until);
+#else /* __WIN__ */
+    DWORD msec = 0ULL == nsec ? INFINITE : (DWORD)(nsec / UINT64_C(1000000)) + 1UL;
+    (void)SleepConditionVariableCS(&_state.watchdog.cond, &_state.watchdog.lock, msec);
+#endif
+}
+
+static void _st_watchdog_fire(void)
+{
+    /* must be called with the lock held. nothing here uses stdio (or allocates): the
+     * hung test may hold the lock of stdout (or of the allocator), which would block
+     * this thread with the watchdog's lock held, and the test thread with it. */
+    st_watchdog* wd = &_state.watchdog;
+    wd->fired = true;
+
+    char notice[ST_MAX_ERROR_STR_LEN] = {0};
+#if !defined(__WIN__)
+    int len = snprintf(notice, sizeof(notice), "\n" FG_COLOR(0, 196, ST_LOC_INDENT
+        ST_LOC_TIMED_OUT) "\n", wd->name, wd->timeout);
+    _st_watchdog_print(notice, len < 0 ? 0U : strnlen(notice, sizeof(notice)));
+# if !defined(__HAVE_BACKTRACE__)
+    static const char no_backtrace[] = FG_COLOR(0, 196, ST_LOC_INDENT ST_LOC_NO_BACKTRACE)
+        "\n";
+    _st_watchdog_print(no_backtrace, sizeof(no_backtrace) - 1);
+# endif
+    wd->captured = 0;
+    (void)pthread_kill(wd->target, ST_TIMEOUT_SIGNAL);
+
+    /* the lock is held meanwhile, so the test thread waits (in _st_watchdog_disarm)
+     * until the backtrace is printed. it isn't recorded if the test had just returned,
+     * or the test blocked the signal. */
+    for (uint32_t msec = 0U; !wd->captured && msec < ST_BACKTRACE_WAIT_MSEC; msec++) {
+        st_sleep_msec(1U);
+    }
+# if defined(__HAVE_BACKTRACE__)
+    if (wd->captured) {
+        backtrace_symbols_fd(wd->frames, wd->num_frames, STDOUT_FILENO);
+    } else {
+        static const char no_frames[] = FG_COLOR(0, 196, ST_LOC_INDENT ST_LOC_NO_FRAMES)
+            "\n";
+        _st_watchdog_print(no_frames, sizeof(no_frames) - 1);
+    }
+# endif
+#else /* __WIN__ */
+    int len = snprintf(notice, sizeof(notice), "\n" FG_COLOR(0, 196, ST_LOC_INDENT
+        ST_LOC_TIMEOUT_EXIT) "\n", wd->name, wd->timeout, EXIT_FAILURE);
+    _st_watchdog_print(notice, len < 0 ? 0U : strnlen(notice, sizeof(notice)));
+    ExitProcess(EXIT_FAILURE);
+#endif
+}
+
+static void _st_watchdog_print(const char* str, size_t len)
+{
+    /* straight to the file, bypassing stdout's buffer (and its lock). */
+#if !defined(__WIN__)
+    while (len > 0U) {
+        ssize_t written = write(STDOUT_FILENO, str, len);
+        if (written < 0 && EINTR == errno) {
+            continue;
+        } else if (written <= 0) {
+            return;
+        }
+        str += written;
+        len -= (size_t)written;
+    }
+#else /* __WIN__ */
+    DWORD written = 0;
+    (void)WriteFile(GetStdHandle(STD_OUTPUT_HANDLE), str, (DWORD)len, &written, NULL);
+#endif
+}
+
+static bool _st_only_line(char* line, void* ctx)
+{
+    _st_only_ctx* octx = (_st_only_ctx*)ctx;
+    const char* case_name = NULL;
+    st_test* test = _st_find_test_or_case(line, octx->tests, octx->num_tests, &case_name);
+    if (!test) {
+        _ST_WARNING("%s "ST_LOC_UNK_FILE_TEST, _ST_WARN_PREFIX, octx->path, line);
+    } else if (!_st_select_test(test, case_name, &octx->config->to_run)) {
+        _ST_ERROR("%s "ST_LOC_CASE_CONFLICT, _ST_ERROR_PREFIX, test->name, test->only_case,
+            case_name);
+        return false;
+    }
+    return true;
+}
+
+static bool _st_add_filter(st_cl_config* config, const char* pattern)
+{
+    st_filter* filters = realloc(config->filters,
+        (config->num_filters + 1) * sizeof(st_filter));
+    if (!filters) {
+        _ST_REPORT_ERROR(errno);
+        return false;
+    }
+
+    config->filters = filters;
+    st_filter* filter = &filters[config->num_filters];
+    (void)memset(filter, 0, sizeof(st_filter));
+
+    filter->negate = *pattern == '!';
+    if (filter->negate) {
+        pattern++;
+    }
+    filter->pattern = pattern;
+
+    /* /regex/ is an extended regular expression; anything else is a glob. */
+    size_t len = strnlen(pattern, ST_MAX_EVAL_STR_LEN);
+    if (len < 2 || pattern[0] != '/' || pattern[len - 1] != '/') {
+        config->num_filters++;
+        return true;
+    }
+
+#if !defined(__WIN__)
+    char* expr = calloc(len - 1, sizeof(char));
+    if (!expr) {
+        _ST_REPORT_ERROR(errno);
+        return false;
+    }
+    (void)memcpy(expr, pattern + 1, len - 2);
+
+    regex_t* re = calloc(1, sizeof(regex_t));
+    if (!re) {
+        _ST_REPORT_ERROR(errno);
+        _st_safefree(&expr);
+        return false;
+    }
+
+    int err = regcomp(re, expr, REG_EXTENDED | REG_NOSUB);
+    if (0 != err) {
+        char message[ST_MAX_ERROR_STR_LEN] = {0};
+        (void)regerror(err, re, message, sizeof(message));
+        _ST_ERROR("%s "ST_LOC_INVAL_REGEX, _ST_ERROR_PREFIX, expr, message);
+        _st_safefree(&expr);
+        _st_safefree(&re);
+        return false;
+    }
+
+    _st_safefree(&expr);
+    filter->re    = re;
+    filter->regex = true;
+    config->num_filters++;
+    return true;
+#else /* __WIN__ */
+    _ST_ERROR("%s "ST_LOC_NO_REGEX, _ST_ERROR_PREFIX, pattern);
+    return false;
+#endif
+}
+
+static bool _st_filter_match(const st_filter* filter, const char* name)
+{
+#if !defined(__WIN__)
+    if (filter->regex) {
+        return 0 == regexec(filter->re, name, 0, NULL, 0);
+    }
+#endif
+    return st_glob_match(filter->pattern, name);
+}
+
+static const char* _st_next_tag(const char* str, size_t* len)
+{
+    if (!str) {
+        return NULL;
+    }
+
+    while (*str == ' ' || *str == ',' || *str == '\t') {
+        str++;
+    }
+
+    *len = 0;
+    while (str[*len] && str[*len] != ' ' && str[*len] != ',' && str[*len] != '\t') {
+        (*len)++;
+    }
+
+    return *len > 0 ? str : NULL;
+}
+
+static bool _st_test_has_tag(const st_test* test, const char* tag)
+{
+    size_t len = 0;
+    bool any   = false;
+    for (const char* cur = _st_next_tag(test->tags, &len); cur != NULL;
+        cur = _st_next_tag(cur + len, &len)) {
+        if (tag && len == strnlen(tag, ST_MAX_TAG_STR_LEN) && 0 == strncmp(cur, tag, len)) {
+            return true;
+        }
+        any = true;
+    }
+    return !tag && !any;
+}
+
+static bool _st_test_in_suite(const st_test* test, const char* suite)
+{
+    bool has_suite = test->suite && *test->suite;
+    return suite ? has_suite && 0 == strcmp(test->suite, suite) : !has_suite;
+}
+
+static bool _st_intern_tag(st_tag_table* table, const st_test* test, const char* tag,
+    size_t len, bool suite, st_tagset* tagset)
+{
+    if (len > ST_MAX_TAG_STR_LEN) {
+        _ST_ERROR("%s "ST_LOC_TEST" '%s': "ST_LOC_TAG_TOO_LONG, _ST_ERROR_PREFIX,
+            test->name, ST_MAX_TAG_STR_LEN);
+        return false;
+    }
+
+    size_t bit = 0;
+    while (bit < table->count && (len != strnlen(table->names[bit], ST_MAX_TAG_STR_LEN) ||
+        0 != strncmp(table->names[bit], tag, len))) {
+        bit++;
+    }
+
+    if (bit == table->count) {
+        if (table->count >= ST_MAX_TAGS) {
+            _ST_ERROR("%s "ST_LOC_TOO_MANY_TAGS, _ST_ERROR_PREFIX, ST_MAX_TAGS);
+            return false;
+        }
+        (void)memcpy(table->names[bit], tag, len);
+        table->names[bit][len] = '\0';
+        table->count++;
+    }
+
+    if (suite) {
+        table->is_suite[bit] = true;
+    } else {
+        table->is_tag[bit] = true;
+    }
+
+    tagset->words[bit / 64] |= UINT64_C(1) << (bit % 64);
+    return true;
+}
+
+static void _st_print_test_group(const st_test* tests, size_t num_tests,
+    const char* group, bool (*member)(const st_test*, const char*))
+{
+    size_t count = 0;
+    for (size_t n = 0; n < num_tests; n++) {
+        if (member(&tests[n], group)) {
+            count++;
+        }
+    }
+
+    if (0 == count) {
+        return;
+    }
+
+    (void)printf("\n\t" WHITEB("%s") DGRAY(" (%zu)") "\n", group ? group : ST_LOC_UNGROUPED,
+        count);
+
+    for (size_t n = 0; n < num_tests; n++) {
+        if (member(&tests[n], group)) {
+            (void)printf("\t  " DGRAY(ST_BULLET) " %s", tests[n].name);
+            if (tests[n].tags && *tests[n].tags) {
+                (void)printf(DGRAY(" [%s]"), tests[n].tags);
+            }
+            (void)printf("\n");
+        }
+    }
+}
+
+static void _st_count_fixture_refs(const st_cl_config* config, st_test* tests,
+    size_t num_tests)
+{
+    /* each selected test that will run holds a reference to its fixtures until it
+     * finishes; the last to finish destroys them. */
+    for (size_t n = 0; n < num_tests; n++) {
+        if ((config->only && !tests[n].run) || tests[n].resumed || !tests[n].fixtures) {
+            continue;
+        }
+        for (st_fixture* const* cur = tests[n].fixtures; *cur != NULL; cur++) {
+            st_mutex_lock(&(*cur)->lock);
+            (*cur)->refs++;
+            st_mutex_unlock(&(*cur)->lock);
+        }
+    }
+}
+
+static void _st_destroy_fixtures(st_test* tests, size_t num_tests)
+{
+    for (size_t n = 0; n < num_tests; n++) {
+        if (!tests[n].fixtures) {
+            continue;
+        }
+        for (st_fixture* const* cur = tests[n].fixtures; *cur != NULL; cur++) {
+            st_mutex_lock(&(*cur)->lock);
+            (*cur)->refs = 0;
+            _st_destroy_fixture(*cur);
+            st_mutex_unlock(&(*cur)->lock);
+        }
+    }
+}
+
+static void _st_destroy_fixture(st_fixture* fixture)
+{
+    /* must be called with the fixture's lock held. */
+    if (!fixture->created) {
+        return;
+    }
+
+    uint64_t started = st_clock_nsec();
+    if (fixture->destroy) {
+        fixture->destroy(fixture->data);
+    }
+
+    char elapsed[ST_MAX_DURATION_STR_LEN] = {0};
+    _ST_MESSAGE(ST_LOC_INDENT DGRAY(ST_LOC_FIXT_DESTROYED), fixture->name,
+        _st_format_nsec((double)(st_clock_nsec() - started), elapsed));
+
+    fixture->data    = NULL;
+    fixture->created = false;
+}
+
+static st_test* _st_find_test_or_case(const char* name, st_test* tests, size_t num_tests,
+    const char** case_name)
+{
+    *case_name    = NULL;
+    st_test* test = st_find_test(name, tests, num_tests);
+    if (test) {
+        return test;
+    }
+
+    /* 'name/case' selects a single case of a parameterized test. */
+    const char* slash = strrchr(name, '/');
+    if (!slash || !slash[1] || strlen(slash + 1) >= ST_MAX_CASE_STR_LEN) {
+        return NULL;
+    }
+
+    char test_name[ST_MAX_LINE_STR_LEN] = {0};
+    size_t len = (size_t)(slash - name);
+    if (len >= sizeof(test_name)) {
+        return NULL;
+    }
+    (void)memcpy(test_name, name, len);
+
+    test = st_find_test(test_name, tests, num_tests);
+    if (!test || !test->cases) {
+        return NULL;
+    }
+
+    *case_name = slash + 1;
+    return test;
+}
+
+static bool _st_select_test(st_test* test, const char* case_name, size_t* to_run)
+{
+    /* a test runs once, whether named once or more; naming the whole test (too) runs
+     * all of its cases. fails if two of its cases are named, as only one is kept. */
+    if (!test->run) {
+        test->run = true;
+        (*to_run)++;
+        if (case_name) {
+            (void)snprintf(test->only_case, ST_MAX_CASE_STR_LEN, "%s", case_name);
+        }
+        return true;
+    }
+
+    if (!*test->only_case) {
+        return true;
+    }
+    if (!case_name) {
+        test->only_case[0] = '\0';
+        return true;
+    }
+    return 0 == strcmp(test->only_case, case_name);
+}
+
+static bool _st_prop_init(st_prop* prop)
+{
+    /* allocated once and reused by every property. */
+    if (!prop->choices) {
+        prop->choices = calloc(ST_PROP_MAX_CHOICES, sizeof(uint64_t));
+    }
+    if (!prop->best) {
+        prop->best = calloc(ST_PROP_MAX_CHOICES, sizeof(uint64_t));
+    }
+    if (!prop->arena) {
+        prop->arena = malloc(ST_PROP_ARENA_SIZE);
+    }
+    return prop->choices && prop->best && prop->arena;
+}
+
+static void _st_prop_free(st_prop* prop)
+{
+    _st_safefree(&prop->choices);
+    _st_safefree(&prop->best);
+    _st_safefree(&prop->arena);
+}
+
+static void _st_prop_reset(st_prop* prop, size_t num_choices, bool replay)
+{
+    prop->num_choices = num_choices;
+    prop->pos         = 0;
+    prop->arena_used  = 0;
+    prop->replay      = replay;
+}
+
+static bool _st_prop_try(st_prop* prop, st_test_fn body, size_t num_choices)
+{
+    /* the candidate is in prop->choices; it's kept if it fails and is simpler. */
+    _st_prop_reset(prop, num_choices, true);
+    _tstate.muted = true;
+    st_testres res = body();
+    _tstate.muted = false;
+
+    if (res.pass ||
+        !_st_prop_simpler(prop->choices, prop->pos, prop->best, prop->num_best)) {
+        return false;
+    }
+
+    (void)memcpy(prop->best, prop->choices, prop->pos * sizeof(uint64_t));
+    prop->num_best = prop->pos;
+    return true;
+}
+
+static bool _st_prop_simpler(const uint64_t* lhs, size_t num_lhs, const uint64_t* rhs,
+    size_t num_rhs)
+{
+    /* fewer choices, or the same number with smaller values. */
+    if (num_lhs != num_rhs) {
+        return num_lhs < num_rhs;
+    }
+    for (size_t n = 0; n < num_lhs; n++) {
+        if (lhs[n] != rhs[n]) {
+            return lhs[n] < rhs[n];
+        }
+    }
+    return false;
+}
+
+static size_t _st_prop_shrink(st_prop* prop, st_test_fn body)
+{
+    size_t steps    = 0;
+    size_t attempts = 0;
+    bool improved   = true;
+
+    while (improved && attempts < ST_PROP_MAX_SHRINKS) {
+        improved = false;
+
+        /* deletes runs of choices (e.g. elements of strings and arrays). */
+        for (size_t k = 8; k > 0; k--) {
+            for (size_t n = prop->num_best; n-- > 0 && attempts < ST_PROP_MAX_SHRINKS;) {
+                if (n + k > prop->num_best) {
+                    continue;
+                }
+                (void)memcpy(prop->choices, prop->best, n * sizeof(uint64_t));
+                (void)memcpy(prop->choices + n, prop->best + n + k,
+                    (prop->num_best - n - k) * sizeof(uint64_t));
+                attempts++;
+                if (_st_prop_try(prop, body, prop->num_best - k)) {
+                    steps++;
+                    improved = true;
+                }
+            }
+        }
+
+        /* moves the value of a choice onto a later one, so that e.g. the sum of an
+         * array's elements can be kept while one of them is zeroed (and deleted). */
+        for (size_t n = 0; n < prop->num_best && attempts < ST_PROP_MAX_SHRINKS; n++) {
+            for (size_t k = n + 1; k < prop->num_best && k <= n + 8 &&
+                attempts < ST_PROP_MAX_SHRINKS; k++) {
+                if (0ULL == prop->best[n] || prop->best[k] > UINT64_MAX - prop->best[n]) {
+                    continue;
+                }
+                (void)memcpy(prop->choices, prop->best, prop->num_best * sizeof(uint64_t));
+                prop->choices[k] += prop->choices[n];
+                prop->choices[n]  = 0ULL;
+                attempts++;
+                if (_st_prop_try(prop, body, prop->num_best)) {
+                    steps++;
+                    improved = true;
+                }
+            }
+        }
+
+        /* minimizes each choice: zero if possible, otherwise by binary search. */
+        for (size_t n = 0; n < prop->num_best && attempts < ST_PROP_MAX_SHRINKS; n++) {
+            uint64_t lo = 0ULL;
+            bool first  = true;
+            while (n < prop->num_best && lo < prop->best[n] &&
+                attempts < ST_PROP_MAX_SHRINKS) {
+                uint64_t cur = prop->best[n];
+                uint64_t mid = first ? lo : lo + (cur - lo) / 2U;
+                first        = false;
+
+                (void)memcpy(prop->choices, prop->best, prop->num_best * sizeof(uint64_t));
+                prop->choices[n] = mid;
+                attempts++;
+                if (_st_prop_try(prop, body, prop->num_best)) {
+                    steps++;
+                    improved = true;
+                } else {
+                    lo = mid + 1U;
+                }
+            }
+        }
+    }
+
+    return steps;
+}
+
+static uint64_t _st_prop_choose(st_rng* rng, uint64_t max)
+{
+    /* favors the edges of the range, where bugs tend to be. */
+    switch (st_rng_next(rng) & 15U) {
+        case 0:
+            return 0ULL;
+        case 1:
+            return max;
+        case 2:
+        case 3:
+            return _st_rng_bounded(rng, max < 16U ? max : 16U);
+        default:
+            return _st_rng_bounded(rng, max);
+    }
+}
+
+static uint64_t _st_rng_bounded(st_rng* rng, uint64_t max)
+{
+    if (UINT64_MAX == max) {
+        return st_rng_next(rng);
+    }
+
+    /* rejects the values that would bias the modulus. */
+    uint64_t range     = max + 1U;
+    uint64_t threshold = (0U - range) % range;
+    uint64_t value     = 0ULL;
+    do {
+        value = st_rng_next(rng);
+    } while (value < threshold);
+
+    return value % range;
+}
+
+static int64_t _st_gen_int(int64_t lo, int64_t hi)
+{
+    if (lo > hi) {
+        int64_t tmp = lo;
+        lo = hi;
+        hi = tmp;
+    }
+
+    uint64_t span = (uint64_t)hi - (uint64_t)lo;
+    if (lo >= 0) {
+        return (int64_t)((uint64_t)lo + st_prop_draw(span));
+    }
+    if (hi <= 0) {
+        return (int64_t)((uint64_t)hi - st_prop_draw(span));
+    }
+
+    /* a sign and a magnitude, so that both shrink toward zero. */
+    bool negative = 1ULL == st_prop_draw(1ULL);
+    uint64_t mag  = st_prop_draw(negative ? 0U - (uint64_t)lo : (uint64_t)hi);
+    return negative ? (int64_t)(0U - mag) : (int64_t)mag;
+}
+
+static uint64_t _st_prop_draw(uint64_t max, const uint64_t* forced)
+{
+    st_prop* prop = &_tstate.prop;
+    if (!_tstate.in_property || prop->pos >= ST_PROP_MAX_CHOICES) {
+        return 0ULL;
+    }
+
+    uint64_t value = 0ULL;
+    if (!prop->replay) {
+        value = forced ? *forced : _st_prop_choose(&prop->rng, max);
+    } else if (prop->pos < prop->num_choices) {
+        /* shrinking an earlier choice may have narrowed this one's range. */
+        value = prop->choices[prop->pos] > max ? max : prop->choices[prop->pos];
+    }
+
+    prop->choices[prop->pos++] = value;
+    return value;
+}
+
+static void* _st_prop_reserve(size_t elem_size, size_t extra, size_t* max_len)
+{
+    /* the elements of a collection are appended to the arena as they are drawn; the
+     * caller commits what it used by advancing arena_used. */
+    void* buf = st_prop_alloc(0);
+    if (!buf) {
+        *max_len = 0;
+        return NULL;
+    }
+
+    size_t avail = ST_PROP_ARENA_SIZE - _tstate.prop.arena_used;
+    if (avail < extra) {
+        *max_len = 0;
+        return NULL;
+    }
+
+    avail = (avail - extra) / elem_size;
+    if (*max_len > avail) {
+        *max_len = avail;
+    }
+    return buf;
+}
+
+static bool _st_prop_more(size_t len, size_t max_len, size_t target)
+{
+    /* collections draw a choice before each element (rather than a length up
+     * front), so that deleting an element's choices deletes just the element. */
+    if (len >= max_len) {
+        return false;
+    }
+    uint64_t more = len < target ? 1ULL : 0ULL;
+    return 1ULL == _st_prop_draw(1ULL, &more);
+}
+
+static size_t _st_prop_target_len(size_t max_len)
+{
+    /* only chosen (and not recorded) when generating; replays follow the choices. */
+    return _tstate.prop.replay ? 0 : (size_t)_st_prop_choose(&_tstate.prop.rng, max_len);
+}
+
+#if !defined(__WIN__)
+/** What an isolated test's child process reports to the parent, through a pipe. */
+typedef struct {
+    st_testres res;
+    st_section_rec sections[ST_SECTION_TOP_N];
+    size_t num_sections;
+    size_t failures;
+    size_t suppressed;
+    int noisy_benchmarks;
+} _st_isolated_outcome;
+
+static void _st_on_isolated_timeout(int sig)
+{
+    /* runs in the child once the parent's deadline has passed: prints the child's
+     * frames (backtrace() was called once up front) and exits. */
+    (void)sig;
+# if defined(__HAVE_BACKTRACE__)
+    int num_frames = backtrace(_state.watchdog.frames, ST_MAX_BACKTRACE_FRAMES);
+    backtrace_symbols_fd(_state.watchdog.frames, num_frames, STDOUT_FILENO);
+# endif
+    _exit(EXIT_FAILURE);
+}
+
+static bool _st_wait_isolated(pid_t pid, int* status, uint64_t deadline)
+{
+    /* false if the child is still running at the deadline (0 waits indefinitely). */
+    uint32_t nap = 1U;
+    while (true) {
+        pid_t done = waitpid(pid, status, 0ULL == deadline ? 0 : WNOHANG);
+        if (done == pid) {
+            return true;
+        } else if (done < 0 && EINTR != errno) {
+            _ST_REPORT_ERROR(errno);
+            *status = 0;
+            return true;
+        } else if (0 == done) {
+            if (st_clock_nsec() >= deadline) {
+                return false;
+            }
+            st_sleep_msec(nap);
+            nap = nap * 2U > ST_ISOLATE_POLL_MSEC ? ST_ISOLATE_POLL_MSEC : nap * 2U;
+        }
+    }
+}
+
+static void _st_kill_isolated(const st_test* test, pid_t pid, uint32_t timeout)
+{
+    /* asks the child for its backtrace first; a child that blocks (or handles) the
+     * signal, or doesn't exit in time, is killed outright. */
+    int status = 0;
+    _ST_ERROR(ST_LOC_INDENT ST_LOC_TIMED_OUT, test->name, timeout);
+# if defined(__HAVE_BACKTRACE__)
+    (void)fflush(stdout);
+    if (0 == kill(pid, ST_TIMEOUT_SIGNAL) && _st_wait_isolated(pid, &status,
+        st_clock_nsec() + (uint64_t)ST_BACKTRACE_WAIT_MSEC * UINT64_C(1000000))) {
+        return;
+    }
+    _ST_ERROR(ST_LOC_INDENT "%s", ST_LOC_NO_FRAMES);
+# else
+    _ST_ERROR(ST_LOC_INDENT "%s", ST_LOC_NO_BACKTRACE);
+# endif
+    (void)kill(pid, SIGKILL);
+    (void)_st_wait_isolated(pid, &status, 0ULL);
+}
+#endif
+
+static st_testres _st_run_isolated(st_test* test, uint32_t timeout)
+{
+    st_testres res = {0};
+#if !defined(__WIN__)
+    /* the test runs in a child process, so that a crash (or hang) ends only the
+     * child. the parent enforces the time limit, and the child reports its result,
+     * failure counts and sections back through a pipe. */
+    int fds[2] = {-1, -1};
+    if (0 != pipe(fds)) {
+        _ST_REPORT_ERROR(errno);
+        res.errors = 1;
+        res.fatal  = true;
+        return res;
+    }
+
+    (void)fflush(stdout);
+    (void)fflush(stderr);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        _ST_REPORT_ERROR(errno);
+        (void)close(fds[0]);
+        (void)close(fds[1]);
+        res.errors = 1;
+        res.fatal  = true;
+        return res;
+    }
+
+    if (0 == pid) {
+        (void)close(fds[0]);
+# if defined(__HAVE_BACKTRACE__)
+        /* the first call may load libgcc (and allocate), which the handler mustn't do. */
+        (void)backtrace(_state.watchdog.frames, 1);
+# endif
+        struct sigaction action = {0};
+        action.sa_handler = &_st_on_isolated_timeout;
+        (void)sigemptyset(&action.sa_mask);
+        (void)sigaction(ST_TIMEOUT_SIGNAL, &action, NULL);
+
+        _st_isolated_outcome outcome = {0};
+        outcome.res = test->fn();
+        (void)fflush(stdout);
+
+        /* the child began with a copy of the parent's state, so these are totals. */
+        outcome.num_sections     = _tstate.num_sections;
+        outcome.failures         = _tstate.failures;
+        outcome.suppressed       = _tstate.suppressed;
+        outcome.noisy_benchmarks = _tstate.noisy_benchmarks;
+        (void)memcpy(outcome.sections, _tstate.sections, sizeof(outcome.sections));
+
+        const char* cur = (const char*)&outcome;
+        size_t left = sizeof(outcome);
+        while (left > 0U) {
+            ssize_t written = write(fds[1], cur, left);
+            if (written < 0 && EINTR == errno) {
+                continue;
+            } else if (written <= 0) {
+                break;
+            }
+            cur  += written;
+            left -= (size_t)written;
+        }
+        _exit(0U == left ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    (void)close(fds[1]);
+    int status = 0;
+    uint64_t deadline = 0ULL;
+    if (timeout > 0U) {
+        deadline = st_clock_nsec() + (uint64_t)timeout * UINT64_C(1000000000);
+    }
+
+    if (!_st_wait_isolated(pid, &status, deadline)) {
+        _st_kill_isolated(test, pid, timeout);
+        (void)close(fds[0]);
+        test->timed_out = true;
+        res.errors      = 1;
+        res.fatal       = true;
+        return res;
+    }
+
+    /* the child has exited, so the whole outcome (if any) is in the pipe. */
+    _st_isolated_outcome outcome = {0};
+    char* cur = (char*)&outcome;
+    size_t left = sizeof(outcome);
+    while (left > 0U) {
+        ssize_t got = read(fds[0], cur, left);
+        if (got < 0 && EINTR == errno) {
+            continue;
+        } else if (got <= 0) {
+            break;
+        }
+        cur  += got;
+        left -= (size_t)got;
+    }
+    (void)close(fds[0]);
+
+    if (WIFEXITED(status) && EXIT_SUCCESS == WEXITSTATUS(status) && 0U == left) {
+        res                      = outcome.res;
+        _tstate.num_sections     = outcome.num_sections;
+        _tstate.failures         = outcome.failures;
+        _tstate.suppressed       = outcome.suppressed;
+        _tstate.noisy_benchmarks = outcome.noisy_benchmarks;
+        (void)memcpy(_tstate.sections, outcome.sections, sizeof(_tstate.sections));
+    } else {
+        res.errors = 1;
+        res.fatal  = true;
+        if (WIFSIGNALED(status)) {
+            _ST_ERROR(ST_LOC_INDENT ST_LOC_CRASHED, WTERMSIG(status),
+                strsignal(WTERMSIG(status)));
+        }
+    }
+#else /* __WIN__ */
+    /* there's no fork(); the test runs in-process. */
+    _ST_UNUSED(timeout);
+    res = test->fn();
+#endif
+    return res;
+}
+
+static bool _st_next_corpus_file(st_case_iter* iter, st_case* out)
+{
+    /* each file remains mapped until the next case is produced. */
+    st_unmap_file(iter->map, iter->map_size);
+    iter->map      = NULL;
+    iter->map_size = 0;
+
+    while (true) {
+#if !defined(__WIN__)
+        struct dirent* entry = readdir(iter->dir);
+        if (!entry) {
+            return false;
+        }
+        (void)snprintf(iter->label, sizeof(iter->label), "%s", entry->d_name);
+#else /* __WIN__ */
+        if (!iter->found) {
+            return false;
+        }
+        bool is_dir = 0 != (iter->find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY);
+        (void)snprintf(iter->label, sizeof(iter->label), "%s", iter->find_data.cFileName);
+        iter->found = FALSE != FindNextFileA(iter->dir, &iter->find_data);
+        if (is_dir) {
+            continue;
+        }
+#endif
+        /* hidden files, '.' and '..'. */
+        if ('.' == iter->label[0]) {
+            continue;
+        }
+
+        int len = snprintf(iter->path, sizeof(iter->path), "%s/%s", iter->source->path,
+            iter->label);
+        if (len < 0 || (size_t)len >= sizeof(iter->path)) {
+            iter->error = true;
+            continue;
+        }
+#if !defined(__WIN__)
+        struct stat st;
+        if (0 != stat(iter->path, &st) || !S_ISREG(st.st_mode)) {
+            continue;
+        }
+#endif
+        if (!st_map_file(iter->path, &iter->map, &iter->map_size)) {
+            iter->error = true;
+            continue;
+        }
+
+        static const char empty = '\0';
+        out->label = iter->label;
+        out->data  = iter->map ? iter->map : &empty;
+        out->size  = iter->map_size;
+        return true;
+    }
+}
+
+static size_t _st_find_mismatch(const void* lhs, size_t lhs_size, const void* rhs,
+    size_t rhs_size)
+{
+    const unsigned char* a = lhs;
+    const unsigned char* b = rhs;
+    size_t size            = lhs_size < rhs_size ? lhs_size : rhs_size;
+    size_t off             = 0;
+
+    /* the vector kernels stop at the first difference, or before the tail that
+     * doesn't fill a vector; either way, the scalar loops below finish. */
+#if defined(__HAVE_X86_DISPATCH__)
+    if (_st_cpu_has("avx512bw")) {
+        off = _st_mismatch_avx512(a, b, size);
+    } else if (_st_cpu_has("avx2")) {
+        off = _st_mismatch_avx2(a, b, size);
+    } else if (_st_cpu_has("sse2")) {
+        off = _st_mismatch_sse2(a, b, size);
+    }
+#endif
+
+    /* compare 32-byte chunks as four words, then single words, then bytes; memcpy
+     * loads are safe for any alignment and compile to plain (or vector) loads. */
+    for (; off + 4 * sizeof(uint64_t) <= size; off += 4 * sizeof(uint64_t)) {
+        uint64_t wa[4];
+        uint64_t wb[4];
+        (void)memcpy(wa, a + off, sizeof(wa));
+        (void)memcpy(wb, b + off, sizeof(wb));
+        if (0 != ((wa[0] ^ wb[0]) | (wa[1] ^ wb[1]) | (wa[2] ^ wb[2]) | (wa[3] ^ wb[3]))) {
+            break;
+        }
+    }
+    for (; off + sizeof(uint64_t) <= size; off += sizeof(uint64_t)) {
+        uint64_t wa;
+        uint64_t wb;
+        (void)memcpy(&wa, a + off, sizeof(wa));
+        (void)memcpy(&wb, b + off, sizeof(wb));
+        if (wa != wb) {
+            break;
+        }
+    }
+    while (off < size && a[off] == b[off]) {
+        off++;
+    }
+
+    return off;
+}
+
+static size_t _st_diff_window(size_t offset)
+{
+    /* the row before the one containing `offset`, if any. */
+    size_t row = offset - offset % ST_DIFF_ROW_BYTES;
+    return row >= ST_DIFF_ROW_BYTES ? row - ST_DIFF_ROW_BYTES : row;
+}
+
+static void _st_print_mismatch(size_t offset, size_t base, const char* lhs_name,
+    const void* lhs, size_t lhs_size, const char* rhs_name, const void* rhs,
+    size_t rhs_size)
+{
+    if (st_failures_suppressed()) {
+        return;
+    }
+
+    _ST_MESSAGE(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_FIRST_DIFF, offset, offset, lhs_name,
+        lhs_size, rhs_name, rhs_size);
+
+    /* `lhs` and `rhs` point at offset `base` (at most the start of the window). */
+    const unsigned char* sides[2] = {lhs, rhs};
+    const size_t sizes[2]         = {lhs_size, rhs_size};
+    const char marks[2]           = {'-', '+'};
+    size_t row                    = _st_diff_window(offset);
+
+    for (size_t r = 0; r < ST_DIFF_ROWS; r++, row += ST_DIFF_ROW_BYTES) {
+        if (row >= lhs_size && row >= rhs_size) {
+            break;
+        }
+        for (size_t side = 0; side < 2; side++) {
+            if (row >= sizes[side]) {
+                continue;
+            }
+            const unsigned char* other = sides[side ^ 1];
+            __ST_MESSAGE(ST_LOC_INDENT ST_LOC_INDENT DGRAY("%c%08zx "), marks[side], row);
+            for (size_t n = row; n < row + ST_DIFF_ROW_BYTES; n++) {
+                if (n >= sizes[side]) {
+                    __ST_MESSAGE("%s", "   ");
+                } else if (n >= sizes[side ^ 1] || sides[side][n - base] != other[n - base]) {
+                    __ST_MESSAGE(FG_COLOR(1, 196, " %02x"), sides[side][n - base]);
+                } else {
+                    __ST_MESSAGE(" %02x", sides[side][n - base]);
+                }
+            }
+            __ST_MESSAGE("%s", DGRAY("  |"));
+            for (size_t n = row; n < row + ST_DIFF_ROW_BYTES && n < sizes[side]; n++) {
+                int ch = isprint(sides[side][n - base]) ? sides[side][n - base] : '.';
+                if (n >= sizes[side ^ 1] || sides[side][n - base] != other[n - base]) {
+                    __ST_MESSAGE(FG_COLOR(1, 196, "%c"), ch);
+                } else {
+                    __ST_MESSAGE("%c", ch);
+                }
+            }
+            __ST_MESSAGE("%s", DGRAY("|") "\n");
+        }
+    }
+}
+
+static void _st_print_expected(size_t offset, const uint8_t* expected, const void* data,
+    size_t size)
+{
+    size_t base = _st_diff_window(offset);
+    _st_print_mismatch(offset, base, ST_LOC_EXPECTED, expected, size, ST_LOC_ACTUAL,
+        (const uint8_t*)data + base, size);
+}
+
+static size_t _st_find_byte_not(const void* ptr, size_t len, uint8_t byte)
+{
+    const uint8_t* bytes = ptr;
+    size_t off           = 0;
+
+    /* the vector kernels stop at the first other byte, or before the tail that
+     * doesn't fill a vector; either way, the scalar loops below finish. */
+#if defined(__HAVE_X86_DISPATCH__)
+    if (_st_cpu_has("avx512bw")) {
+        off = _st_find_byte_not_avx512(bytes, len, byte);
+    } else if (_st_cpu_has("avx2")) {
+        off = _st_find_byte_not_avx2(bytes, len, byte);
+    } else if (_st_cpu_has("sse2")) {
+        off = _st_find_byte_not_sse2(bytes, len, byte);
+    }
+#endif
+
+    uint64_t want = UINT64_C(0x0101010101010101) * byte;
+    for (; off + 4 * sizeof(uint64_t) <= len; off += 4 * sizeof(uint64_t)) {
+        uint64_t words[4];
+        (void)memcpy(words, bytes + off, sizeof(words));
+        if (0 != ((words[0] ^ want) | (words[1] ^ want) | (words[2] ^ want) |
+            (words[3] ^ want))) {
+            break;
+        }
+    }
+    for (; off + sizeof(uint64_t) <= len; off += sizeof(uint64_t)) {
+        uint64_t word;
+        (void)memcpy(&word, bytes + off, sizeof(word));
+        if (word != want) {
+            break;
+        }
+    }
+    while (off < len && bytes[off] == byte) {
+        off++;
+    }
+
+    return off;
+}
+
+#if defined(__HAVE_X86_DISPATCH__)
+_ST_TARGET("sse2")
+static size_t _st_find_byte_not_sse2(const uint8_t* bytes, size_t len, uint8_t byte)
+{
+    __m128i want = _mm_set1_epi8((char)byte);
+    size_t off   = 0;
+    for (; off + 4 * 16 <= len; off += 4 * 16) {
+        __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(const void*)(bytes + off)),
+            want);
+        for (size_t n = 1; n < 4; n++) {
+            eq = _mm_and_si128(eq, _mm_cmpeq_epi8(
+                _mm_loadu_si128((const __m128i*)(const void*)(bytes + off + 16 * n)), want));
+        }
+        if (0xffff != _mm_movemask_epi8(eq)) {
+            break;
+        }
+    }
+    for (; off + 16 <= len; off += 16) {
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(
+            _mm_loadu_si128((const __m128i*)(const void*)(bytes + off)), want));
+        if (0xffff != mask) {
+            return off + (size_t)__builtin_ctz(~mask);
+        }
+    }
+    return off;
+}
+
+_ST_TARGET("avx2")
+static size_t _st_find_byte_not_avx2(const uint8_t* bytes, size_t len, uint8_t byte)
+{
+    __m256i want = _mm256_set1_epi8((char)byte);
+    size_t off   = 0;
+    for (; off + 4 * 32 <= len; off += 4 * 32) {
+        __m256i eq = _mm256_cmpeq_epi8(
+            _mm256_loadu_si256((const __m256i*)(const void*)(bytes + off)), want);
+        for (size_t n = 1; n < 4; n++) {
+            eq = _mm256_and_si256(eq, _mm256_cmpeq_epi8(
+                _mm256_loadu_si256((const __m256i*)(const void*)(bytes + off + 32 * n)), want));
+        }
+        if (-1 != _mm256_movemask_epi8(eq)) {
+            break;
+        }
+    }
+    for (; off + 32 <= len; off += 32) {
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+            _mm256_loadu_si256((const __m256i*)(const void*)(bytes + off)), want));
+        if (UINT32_MAX != mask) {
+            return off + (size_t)__builtin_ctz(~mask);
+        }
+    }
+    return off;
+}
+
+_ST_TARGET("avx512bw")
+static size_t _st_find_byte_not_avx512(const uint8_t* bytes, size_t len, uint8_t byte)
+{
+    __m512i want = _mm512_set1_epi8((char)byte);
+    size_t off   = 0;
+    for (; off + 4 * 64 <= len; off += 4 * 64) {
+        __mmask64 ne = 0;
+        for (size_t n = 0; n < 4; n++) {
+            ne |= _mm512_cmpneq_epi8_mask(_mm512_loadu_si512(bytes + off + 64 * n), want);
+        }
+        if (0 != ne) {
+            break;
+        }
+    }
+    for (; off + 64 <= len; off += 64) {
+        __mmask64 ne = _mm512_cmpneq_epi8_mask(_mm512_loadu_si512(bytes + off), want);
+        if (0 != ne) {
+            return off + (size_t)__builtin_ctzll(ne);
+        }
+    }
+    return off;
+}
+#endif
+
+static size_t _st_find_char_not_in(const void* ptr, size_t len, const uint64_t set[4])
+{
+    const uint8_t* bytes = ptr;
+    size_t off           = 0;
+
+#if defined(__HAVE_X86_DISPATCH__)
+    /* a set of ASCII characters is looked up 16 bytes at a time by nibble: rows[lo]
+     * has bit hi set if the character (hi << 4 | lo) is in the set. bytes >= 0x80
+     * never match, so sets that contain any are left to the scalar loop. */
+    if (0 == set[2] && 0 == set[3]) {
+        uint8_t rows[16] = {0};
+        for (unsigned c = 0; c < 0x80; c++) {
+            if (0 != (set[c >> 6] >> (c & 63) & 1)) {
+                rows[c & 0x0f] |= (uint8_t)(1u << (c >> 4));
+            }
+        }
+        if (_st_cpu_has("avx512bw")) {
+            off = _st_find_char_not_in_avx512(bytes, len, rows);
+        } else if (_st_cpu_has("avx2")) {
+            off = _st_find_char_not_in_avx2(bytes, len, rows);
+        } else if (_st_cpu_has("ssse3")) {
+            off = _st_find_char_not_in_ssse3(bytes, len, rows);
+        }
+    }
+#endif
+
+    while (off < len && 0 != (set[bytes[off] >> 6] >> (bytes[off] & 63) & 1)) {
+        off++;
+    }
+
+    return off;
+}
+
+#if defined(__HAVE_X86_DISPATCH__)
+_ST_TARGET("ssse3")
+static size_t _st_find_char_not_in_ssse3(const uint8_t* bytes, size_t len,
+    const uint8_t rows[16])
+{
+    __m128i row_lut = _mm_loadu_si128((const __m128i*)(const void*)rows);
+    __m128i bit_lut = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, (char)0x80, 0, 0, 0, 0, 0, 0, 0, 0);
+    __m128i nibble  = _mm_set1_epi8(0x0f);
+    size_t off      = 0;
+    for (; off + 16 <= len; off += 16) {
+        __m128i v   = _mm_loadu_si128((const __m128i*)(const void*)(bytes + off));
+        __m128i row = _mm_shuffle_epi8(row_lut, _mm_and_si128(v, nibble));
+        __m128i bit = _mm_shuffle_epi8(bit_lut, _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+        unsigned miss = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(row, bit),
+            _mm_setzero_si128()));
+        if (0 != miss) {
+            return off + (size_t)__builtin_ctz(miss);
+        }
+    }
+    return off;
+}
+
+_ST_TARGET("avx2")
+static size_t _st_find_char_not_in_avx2(const uint8_t* bytes, size_t len,
+    const uint8_t rows[16])
+{
+    __m256i row_lut = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i*)(const void*)rows));
+    __m256i bit_lut = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, (char)0x80, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 2, 4, 8, 16, 32, 64, (char)0x80, 0, 0, 0, 0, 0, 0, 0, 0);
+    __m256i nibble  = _mm256_set1_epi8(0x0f);
+    size_t off      = 0;
+    for (; off + 32 <= len; off += 32) {
+        __m256i v   = _mm256_loadu_si256((const __m256i*)(const void*)(bytes + off));
+        __m256i row = _mm256_shuffle_epi8(row_lut, _mm256_and_si256(v, nibble));
+        __m256i bit = _mm256_shuffle_epi8(bit_lut,
+            _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+        uint32_t miss = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+            _mm256_and_si256(row, bit), _mm256_setzero_si256()));
+        if (0 != miss) {
+            return off + (size_t)__builtin_ctz(miss);
+        }
+    }
+    return off;
+}
+
+_ST_TARGET("avx512bw")
+static size_t _st_find_char_not_in_avx512(const uint8_t* bytes, size_t len,
+    const uint8_t rows[16])
+{
+    __m512i row_lut = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)(const void*)rows));
+    __m512i bit_lut = _mm512_broadcast_i32x4(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, (char)0x80,
+        0, 0, 0, 0, 0, 0, 0, 0));
+    __m512i nibble  = _mm512_set1_epi8(0x0f);
+    size_t off      = 0;
+    for (; off + 64 <= len; off += 64) {
+        __m512i v   = _mm512_loadu_si512(bytes + off);
+        __m512i row = _mm512_shuffle_epi8(row_lut, _mm512_and_si512(v, nibble));
+        __m512i bit = _mm512_shuffle_epi8(bit_lut,
+            _mm512_and_si512(_mm512_srli_epi16(v, 4), nibble));
+        __mmask64 miss = _mm512_testn_epi8_mask(row, bit);
+        if (0 != miss) {
+            return off + (size_t)__builtin_ctzll(miss);
+        }
+    }
+    return off;
+}
+#endif
+
+static size_t _st_find_non_ascii(const uint8_t* bytes, size_t len)
+{
+    size_t off = 0;
+
+#if defined(__HAVE_X86_DISPATCH__)
+    if (_st_cpu_has("avx512bw")) {
+        off = _st_find_non_ascii_avx512(bytes, len);
+    } else if (_st_cpu_has("avx2")) {
+        off = _st_find_non_ascii_avx2(bytes, len);
+    } else if (_st_cpu_has("sse2")) {
+        off = _st_find_non_ascii_sse2(bytes, len);
+    }
+#endif
+
+    for (; off + sizeof(uint64_t) <= len; off += sizeof(uint64_t)) {
+        uint64_t word;
+        (void)memcpy(&word, bytes + off, sizeof(word));
+        if (0 != (word & UINT64_C(0x8080808080808080))) {
+            break;
+        }
+    }
+    while (off < len && bytes[off] < 0x80) {
+        off++;
+    }
+
+    return off;
+}
+
+#if defined(__HAVE_X86_DISPATCH__)
+_ST_TARGET("sse2")
+static size_t _st_find_non_ascii_sse2(const uint8_t* bytes, size_t len)
+{
+    size_t off = 0;
+    for (; off + 4 * 16 <= len; off += 4 * 16) {
+        __m128i any = _mm_loadu_si128((const __m128i*)(const void*)(bytes + off));
+        for (size_t n = 1; n < 4; n++) {
+            any = _mm_or_si128(any,
+                _mm_loadu_si128((const __m128i*)(const void*)(bytes + off + 16 * n)));
+        }
+        if (0 != _mm_movemask_epi8(any)) {
+            break;
+        }
+    }
+    for (; off + 16 <= len; off += 16) {
+        unsigned mask = (unsigned)_mm_movemask_epi8(
+            _mm_loadu_si128((const __m128i*)(const void*)(bytes + off)));
+        if (0 != mask) {
+            return off + (size_t)__builtin_ctz(mask);
+        }
+    }
+    return off;
+}
+
+_ST_TARGET("avx2")
+static size_t _st_find_non_ascii_avx2(const uint8_t* bytes, size_t len)
+{
+    size_t off = 0;
+    for (; off + 4 * 32 <= len; off += 4 * 32) {
+        __m256i any = _mm256_loadu_si256((const __m256i*)(const void*)(bytes + off));
+        for (size_t n = 1; n < 4; n++) {
+            any = _mm256_or_si256(any,
+                _mm256_loadu_si256((const __m256i*)(const void*)(bytes + off + 32 * n)));
+        }
+        if (0 != _mm256_movemask_epi8(any)) {
+            break;
+        }
+    }
+    for (; off + 32 <= len; off += 32) {
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(
+            _mm256_loadu_si256((const __m256i*)(const void*)(bytes + off)));
+        if (0 != mask) {
+            return off + (size_t)__builtin_ctz(mask);
+        }
+    }
+    return off;
+}
+
+_ST_TARGET("avx512bw")
+static size_t _st_find_non_ascii_avx512(const uint8_t* bytes, size_t len)
+{
+    size_t off = 0;
+    for (; off + 4 * 64 <= len; off += 4 * 64) {
+        __m512i any = _mm512_loadu_si512(bytes + off);
+        for (size_t n = 1; n < 4; n++) {
+            any = _mm512_or_si512(any, _mm512_loadu_si512(bytes + off + 64 * n));
+        }
+        if (0 != _mm512_movepi8_mask(any)) {
+            break;
+        }
+    }
+    for (; off + 64 <= len; off += 64) {
+        __mmask64 mask = _mm512_movepi8_mask(_mm512_loadu_si512(bytes + off));
+        if (0 != mask) {
+            return off + (size_t)__builtin_ctzll(mask);
+        }
+    }
+    return off;
+}
+#endif
+
+static inline
+uint8_t _st_fold_case(uint8_t c)
+{
+    return (uint8_t)(c - 'A') < 26 ? (uint8_t)(c | 0x20) : c;
+}
+
+static inline
+uint8_t _st_canon(uint8_t c, bool ignore_case)
+{
+    return ignore_case ? _st_fold_case(c) : c;
+}
+
+static size_t _st_find_mismatch_i(const void* lhs, size_t lhs_size, const void* rhs,
+    size_t rhs_size)
+{
+    const uint8_t* a = lhs;
+    const uint8_t* b = rhs;
+    size_t size      = lhs_size < rhs_size ? lhs_size : rhs_size;
+    size_t off       = 0;
+
+#if defined(__HAVE_X86_DISPATCH__)
+    if (_st_cpu_has("avx512bw")) {
+        off = _st_mismatch_i_avx512(a, b, size);
+    } else if (_st_cpu_has("avx2")) {
+        off = _st_mismatch_i_avx2(a, b, size);
+    } else if (_st_cpu_has("sse2")) {
+        off = _st_mismatch_i_sse2(a, b, size);
+    }
+#endif
+
+    while (off < size && _st_fold_case(a[off]) == _st_fold_case(b[off])) {
+        off++;
+    }
+
+    return off;
+}
+
+#if defined(__HAVE_X86_DISPATCH__)
+/* the vector forms of _st_fold_case: 'A'-'Z' are those for which (c - 'A') is at
+ * most 25, unsigned. */
+_ST_TARGET("sse2")
+static inline
+__m128i _st_fold_case_sse2(__m128i v)
+{
+    __m128i rel   = _mm_sub_epi8(v, _mm_set1_epi8('A'));
+    __m128i upper = _mm_cmpeq_epi8(_mm_min_epu8(rel, _mm_set1_epi8(25)), rel);
+    return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+_ST_TARGET("avx2")
+static inline
+__m256i _st_fold_case_avx2(__m256i v)
+{
+    __m256i rel   = _mm256_sub_epi8(v, _mm256_set1_epi8('A'));
+    __m256i upper = _mm256_cmpeq_epi8(_mm256_min_epu8(rel, _mm256_set1_epi8(25)), rel);
+    return _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+
+_ST_TARGET("avx512bw")
+static inline
+__m512i _st_fold_case_avx512(__m512i v)
+{
+    __mmask64 upper = _mm512_cmple_epu8_mask(_mm512_sub_epi8(v, _mm512_set1_epi8('A')),
+        _mm512_set1_epi8(25));
+    return _mm512_mask_add_epi8(v, upper, v, _mm512_set1_epi8(0x20));
+}
+
+_ST_TARGET("sse2")
+static size_t _st_mismatch_i_sse2(const uint8_t* lhs, const uint8_t* rhs, size_t size)
+{
+    size_t off = 0;
+    for (; off + 16 <= size; off += 16) {
+        __m128i a     = _st_fold_case_sse2(_mm_loadu_si128((const __m128i*)(const void*)(lhs + off)));
+        __m128i b     = _st_fold_case_sse2(_mm_loadu_si128((const __m128i*)(const void*)(rhs + off)));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(a, b));
+        if (0xffff != mask) {
+            return off + (size_t)__builtin_ctz(~mask);
+        }
+    }
+    return off;
+}
+
+_ST_TARGET("avx2")
+static size_t _st_mismatch_i_avx2(const uint8_t* lhs, const uint8_t* rhs, size_t size)
+{
+    size_t off = 0;
+    for (; off + 32 <= size; off += 32) {
+        __m256i a = _st_fold_case_avx2(
+            _mm256_loadu_si256((const __m256i*)(const void*)(lhs + off)));
+        __m256i b = _st_fold_case_avx2(
+            _mm256_loadu_si256((const __m256i*)(const void*)(rhs + off)));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b));
+        if (UINT32_MAX != mask) {
+            return off + (size_t)__builtin_ctz(~mask);
+        }
+    }
+    return off;
+}
+
+_ST_TARGET("avx512bw")
+static size_t _st_mismatch_i_avx512(const uint8_t* lhs, const uint8_t* rhs, size_t size)
+{
+    size_t off = 0;
+    for (; off + 64 <= size; off += 64) {
+        __mmask64 ne = _mm512_cmpneq_epi8_mask(
+            _st_fold_case_avx512(_mm512_loadu_si512(lhs + off)),
+            _st_fold_case_avx512(_mm512_loadu_si512(rhs + off)));
+        if (0 != ne) {
+            return off + (size_t)__builtin_ctzll(ne);
+        }
+    }
+    return off;
+}
+#endif
+
+static size_t _st_search(const uint8_t* haystack, size_t haystack_len,
+    const uint8_t* needle, size_t needle_len, bool ignore_case)
+{
+    if (needle_len > haystack_len) {
+        return SIZE_MAX;
+    }
+    if (0 == needle_len) {
+        return 0;
+    }
+
+    /* candidates are the positions at which both the first and last bytes of the
+     * needle match, found a vector at a time; the bytes between are then compared.
+     * that is quadratic at worst (e.g. "aaa...ab" in "aaa...a"), so once the
+     * comparisons outweigh the distance covered, Two-Way takes over. */
+    size_t count  = haystack_len - needle_len + 1;
+    size_t gap    = needle_len - 1;
+    uint8_t first = ignore_case ? _st_fold_case(needle[0]) : needle[0];
+    uint8_t last  = ignore_case ? _st_fold_case(needle[gap]) : needle[gap];
+    size_t work   = 0;
+
+    for (size_t pos = 0; pos < count; pos++) {
+        pos += _st_find_pair(haystack + pos, count - pos, gap, first, last, ignore_case);
+        if (pos >= count) {
+            break;
+        }
+        if (needle_len <= 2) {
+            return pos;
+        }
+
+        size_t inner = needle_len - 2;
+        size_t same  = ignore_case
+            ? _st_find_mismatch_i(haystack + pos + 1, inner, needle + 1, inner)
+            : _st_find_mismatch(haystack + pos + 1, inner, needle + 1, inner);
+        if (same == inner) {
+            return pos;
+        }
+
+        work += same + 16;
+        if (work > pos + 1024) {
+            size_t found = _st_two_way(haystack + pos, haystack_len - pos, needle, needle_len,
+                ignore_case);
+            return SIZE_MAX == found ? SIZE_MAX : pos + found;
+        }
+    }
+
+    return SIZE_MAX;
+}
+
+static size_t _st_find_pair(const uint8_t* bytes, size_t count, size_t gap, uint8_t first,
+    uint8_t last, bool ignore_case)
+{
+    size_t off = 0;
+
+    /* the vector kernels stop at the first candidate, or before the tail that
+     * doesn't fill a vector; either way, the scalar loop below finishes. */
+#if defined(__HAVE_X86_DISPATCH__)
+    if (_st_cpu_has("avx512bw")) {
+        off = _st_find_pair_avx512(bytes, count, gap, first, last, ignore_case);
+    } else if (_st_cpu_has("avx2")) {
+        off = _st_find_pair_avx2(bytes, count, gap, first, last, ignore_case);
+    } else if (_st_cpu_has("sse2")) {
+        off = _st_find_pair_sse2(bytes, count, gap, first, last, ignore_case);
+    }
+#endif
+
+    if (ignore_case) {
+        while (off < count && (_st_fold_case(bytes[off]) != first ||
+            _st_fold_case(bytes[off + gap]) != last)) {
+            off++;
+        }
+    } else {
+        while (off < count && (bytes[off] != first || bytes[off + gap] != last)) {
+            off++;
+        }
+    }
+
+    return off;
+}
+
+#if defined(__HAVE_X86_DISPATCH__)
+_ST_TARGET("sse2")
+static size_t _st_find_pair_sse2(const uint8_t* bytes, size_t count, size_t gap,
+    uint8_t first, uint8_t last, bool ignore_case)
+{
+    __m128i want_first = _mm_set1_epi8((char)first);
+    __m128i want_last  = _mm_set1_epi8((char)last);
+    size_t off         = 0;
+    for (; off + 16 <= count; off += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(const void*)(bytes + off));
+        __m128i b = _mm_loadu_si128((const __m128i*)(const void*)(bytes + off + gap));
+        if (ignore_case) {
+            a = _st_fold_case_sse2(a);
+            b = _st_fold_case_sse2(b);
+        }
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(a, want_first), _mm_cmpeq_epi8(b, want_last)));
+        if (0 != mask) {
+            return off + (size_t)__builtin_ctz(mask);
+        }
+    }
+    return off;
+}
+
+_ST_TARGET("avx2")
+static size_t _st_find_pair_avx2(const uint8_t* bytes, size_t count, size_t gap,
+    uint8_t first, uint8_t last, bool ignore_case)
+{
+    __m256i want_first = _mm256_set1_epi8((char)first);
+    __m256i want_last  = _mm256_set1_epi8((char)last);
+    size_t off         = 0;
+    for (; off + 32 <= count; off += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(const void*)(bytes + off));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(const void*)(bytes + off + gap));
+        if (ignore_case) {
+            a = _st_fold_case_avx2(a);
+            b = _st_fold_case_avx2(b);
+        }
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(a, want_first), _mm256_cmpeq_epi8(b, want_last)));
+        if (0 != mask) {
+            return off + (size_t)__builtin_ctz(mask);
+        }
+    }
+    return off;
+}
+
+_ST_TARGET("avx512bw")
+static size_t _st_find_pair_avx512(const uint8_t* bytes, size_t count, size_t gap,
+    uint8_t first, uint8_t last, bool ignore_case)
+{
+    __m512i want_first = _mm512_set1_epi8((char)first);
+    __m512i want_last  = _mm512_set1_epi8((char)last);
+    size_t off         = 0;
+    for (; off + 64 <= count; off += 64) {
+        __m512i a = _mm512_loadu_si512(bytes + off);
+        __m512i b = _mm512_loadu_si512(bytes + off + gap);
+        if (ignore_case) {
+            a = _st_fold_case_avx512(a);
+            b = _st_fold_case_avx512(b);
+        }
+        __mmask64 mask = _mm512_cmpeq_epi8_mask(a, want_first) &
+            _mm512_cmpeq_epi8_mask(b, want_last);
+        if (0 != mask) {
+            return off + (size_t)__builtin_ctzll(mask);
+        }
+    }
+    return off;
+}
+#endif
+
+static size_t _st_two_way(const uint8_t* haystack, size_t haystack_len,
+    const uint8_t* needle, size_t needle_len, bool ignore_case)
+{
+    /* critical factorization (Crochemore-Perrin): the later of the maximal suffixes
+     * under the two orderings of the alphabet, and the period of the needle's
+     * right half. indices start at SIZE_MAX (i.e. -1) and wrap on increment. */
+    size_t suffix[2] = {SIZE_MAX, SIZE_MAX};
+    size_t periods[2];
+    for (size_t order = 0; order < 2; order++) {
+        size_t j = 0;
+        size_t k = 1;
+        size_t p = 1;
+        while (j + k < needle_len) {
+            uint8_t a = _st_canon(needle[j + k], ignore_case);
+            uint8_t b = _st_canon(needle[suffix[order] + k], ignore_case);
+            if (0 == order ? a < b : a > b) {
+                j += k;
+                k = 1;
+                p = j - suffix[order];
+            } else if (a == b) {
+                if (k != p) {
+                    k++;
+                } else {
+                    j += p;
+                    k = 1;
+                }
+            } else {
+                suffix[order] = j++;
+                k = p = 1;
+            }
+        }
+        periods[order] = p;
+    }
+    size_t order  = suffix[1] + 1 < suffix[0] + 1 ? 0 : 1;
+    size_t split  = suffix[order] + 1;
+    size_t period = periods[order];
+
+    size_t n = 0;
+    while (n < split && _st_canon(needle[n], ignore_case) ==
+        _st_canon(needle[n + period], ignore_case)) {
+        n++;
+    }
+
+    if (n == split) {
+        /* the needle is periodic: after a shift by the period, the part of the
+         * right half that overlapped the previous match need not be compared again. */
+        size_t memory = 0;
+        for (size_t j = 0; j <= haystack_len - needle_len;) {
+            size_t i = split > memory ? split : memory;
+            while (i < needle_len && _st_canon(needle[i], ignore_case) ==
+                _st_canon(haystack[i + j], ignore_case)) {
+                i++;
+            }
+            if (i < needle_len) {
+                j += i - split + 1;
+                memory = 0;
+                continue;
+            }
+            i = split - 1;
+            while (memory < i + 1 && _st_canon(needle[i], ignore_case) ==
+                _st_canon(haystack[i + j], ignore_case)) {
+                i--;
+            }
+            if (i + 1 < memory + 1) {
+                return j;
+            }
+            j += period;
+            memory = needle_len - period;
+        }
+    } else {
+        period = (split > needle_len - split ? split : needle_len - split) + 1;
+        for (size_t j = 0; j <= haystack_len - needle_len;) {
+            size_t i = split;
+            while (i < needle_len && _st_canon(needle[i], ignore_case) ==
+                _st_canon(haystack[i + j], ignore_case)) {
+                i++;
+            }
+            if (i < needle_len) {
+                j += i - split + 1;
+                continue;
+            }
+            i = split - 1;
+            while (SIZE_MAX != i && _st_canon(needle[i], ignore_case) ==
+                _st_canon(haystack[i + j], ignore_case)) {
+                i--;
+            }
+            if (SIZE_MAX == i) {
+                return j;
+            }
+            j += period;
+        }
+    }
+
+    return SIZE_MAX;
+}
+
+static bool _st_check_bufs(const char* lhs_name, const void* lhs, size_t lhs_len,
+    const char* rhs_name, const void* rhs, size_t rhs_len)
+{
+    /* a NULL buffer is fine when empty; zero-copy parsers produce such slices. */
+    if (!lhs && lhs_len > 0) {
+        _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_NULL_BUF, lhs_name, lhs_len);
+        return false;
+    }
+    if (!rhs && rhs_len > 0) {
+        _ST_DETAIL(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_NULL_BUF, rhs_name, rhs_len);
+        return false;
+    }
+    return true;
+}
+
+#if !defined(__WIN__)
+static bool _st_regex_exec(st_regex_site* site, const char* str, const char* pattern,
+    regmatch_t* match, bool* matched)
+{
+    st_mutex_lock(&site->lock);
+    if (!site->pattern) {
+        size_t len    = strlen(pattern);
+        site->pattern = calloc(len + 1, sizeof(char));
+        site->re      = calloc(1, sizeof(regex_t));
+        if (!site->pattern || !site->re) {
+            _ST_REPORT_ERROR(errno);
+            _st_safefree(&site->pattern);
+            _st_safefree(&site->re);
+            st_mutex_unlock(&site->lock);
+            return false;
+        }
+        if (!_st_regex_compile(site->re, pattern)) {
+            _st_safefree(&site->pattern);
+            _st_safefree(&site->re);
+            st_mutex_unlock(&site->lock);
+            return false;
+        }
+        (void)memcpy(site->pattern, pattern, len);
+
+        st_mutex_lock(&_st_regex_lock);
+        site->next         = _state.regex_sites;
+        _state.regex_sites = site;
+        st_mutex_unlock(&_st_regex_lock);
+    }
+    bool cached = 0 == strcmp(site->pattern, pattern);
+    st_mutex_unlock(&site->lock);
+
+    /* a site evaluated with varying patterns keeps the first; the others are
+     * compiled for the one call. */
+    regex_t uncached;
+    if (!cached && !_st_regex_compile(&uncached, pattern)) {
+        return false;
+    }
+
+    const regex_t* re = cached ? site->re : &uncached;
+    *matched = 0 == regexec(re, str, match ? 1 : 0, match, 0);
+
+    if (!cached) {
+        regfree(&uncached);
+    }
+    return true;
+}
+
+static bool _st_regex_compile(regex_t* re, const char* pattern)
+{
+    int err = regcomp(re, pattern, REG_EXTENDED);
+    if (0 != err) {
+        char message[ST_MAX_ERROR_STR_LEN] = {0};
+        (void)regerror(err, re, message, sizeof(message));
+        _ST_ERROR(ST_LOC_INDENT ST_LOC_INDENT ST_LOC_INVAL_REGEX, pattern, message);
+        return false;
+    }
+    return true;
+}
+#endif
+
+static void _st_regex_free_sites(void)
+{
+    /* detach the list first: sites are locked before _st_regex_lock, never after. */
+    st_mutex_lock(&_st_regex_lock);
+    st_regex_site* site = _state.regex_sites;
+    _state.regex_sites  = NULL;
+    st_mutex_unlock(&_st_regex_lock);
+
+    while (site != NULL) {
+        st_regex_site* next = site->next;
+        st_mutex_lock(&site->lock);
+#if !defined(__WIN__)
+        regfree(site->re);
+        _st_safefree(&site->re);
+#endif
+        _st_safefree(&site->pattern);
+        site->next = NULL;
+        st_mutex_unlock(&site->lock);
+        site = next;
+    }
+}
+
+static bool _st_elem_near(double lhs, double rhs, double abs_tol, uint64_t max_ulps,
+    bool single, uint64_t* ulps)
+{
+    *ulps = _st_ulp_distance(lhs, rhs, single);
+    if (lhs == rhs || (isnan(lhs) && isnan(rhs))) {
+        return true;
+    }
+    if (!isfinite(lhs) || !isfinite(rhs)) {
+        return false;
+    }
+
+    /* single-precision differences are taken in single precision, as the kernels do. */
+    bool within = single ? fabsf((float)lhs - (float)rhs) <= (float)abs_tol
+                         : fabs(lhs - rhs) <= abs_tol;
+    return within || *ulps <= max_ulps;
+}
+
+static uint64_t _st_ulp_distance(double lhs, double rhs, bool single)
+{
+    if (isnan(lhs) || isnan(rhs)) {
+        return isnan(lhs) && isnan(rhs) ? 0 : UINT64_MAX;
+    }
+
+    /* map the bits to unsigned integers in the order of the values they represent
+     * (negative values have their bits flipped; others their sign bit set). */
+    uint64_t keys[2];
+    const double values[2] = {lhs, rhs};
+    for (size_t n = 0; n < 2; n++) {
+        if (single) {
+            float value = (float)values[n];
+            uint32_t bits;
+            (void)memcpy(&bits, &value, sizeof(bits));
+            keys[n] = (bits >> 31) ? (uint32_t)~bits : bits | UINT32_C(0x80000000);
+        } else {
+            uint64_t bits;
+            (void)memcpy(&bits, &values[n], sizeof(bits));
+            keys[n] = (bits >> 63) ? ~bits : bits | UINT64_C(0x8000000000000000);
+        }
+    }
+    return keys[0] > keys[1] ? keys[0] - keys[1] : keys[1] - keys[0];
+}
+
+static double _st_read_real(const void* elem, size_t elem_size)
+{
+    if (sizeof(float) == elem_size) {
+        float value;
+        (void)memcpy(&value, elem, sizeof(value));
+        return value;
+    }
+    if (sizeof(double) == elem_size) {
+        double value;
+        (void)memcpy(&value, elem, sizeof(value));
+        return value;
+    }
+    long double value;
+    (void)memcpy(&value, elem, sizeof(value));
+    return (double)value;
+}
+
+static size_t _st_find_not_near(const void* lhs, const void* rhs, size_t count,
+    size_t elem_size, double abs_tol, uint64_t max_ulps)
+{
+#if defined(__HAVE_X86_DISPATCH__)
+    if (sizeof(double) == elem_size) {
+        if (_st_cpu_has("avx512f")) {
+            return _st_find_not_near_f64_avx512(lhs, rhs, count, abs_tol, max_ulps);
+        } else if (_st_cpu_has("avx2")) {
+            return _st_find_not_near_f64_avx2(lhs, rhs, count, abs_tol, max_ulps);
+        }
+    } else if (sizeof(float) == elem_size) {
+        if (_st_cpu_has("avx512f")) {
+            return _st_find_not_near_f32_avx512(lhs, rhs, count, (float)abs_tol, max_ulps);
+        } else if (_st_cpu_has("avx2")) {
+            return _st_find_not_near_f32_avx2(lhs, rhs, count, (float)abs_tol, max_ulps);
+        }
+    }
+#else
+    _ST_UNUSED(lhs);
+    _ST_UNUSED(rhs);
+    _ST_UNUSED(count);
+    _ST_UNUSED(elem_size);
+    _ST_UNUSED(abs_tol);
+    _ST_UNUSED(max_ulps);
+#endif
+    return 0;
+}
+
+#if defined(__HAVE_X86_DISPATCH__)
+/* an element is certainly near if it is equal, within `abs_tol`, or finite, of the
+ * same sign (so that its magnitude bits are ordered like its value), and within
+ * `max_ulps`. the kernels stop at any other element (NaN included), and leave it to
+ * _st_elem_near. */
+_ST_TARGET("avx2")
+static size_t _st_find_not_near_f64_avx2(const double* lhs, const double* rhs, size_t count,
+    double abs_tol, uint64_t max_ulps)
+{
+    __m256i abs_mask = _mm256_set1_epi64x(INT64_MAX);
+    __m256d tol      = _mm256_set1_pd(abs_tol);
+    __m256i inf      = _mm256_set1_epi64x(INT64_C(0x7ff0000000000000));
+    __m256i ulps     = _mm256_set1_epi64x(max_ulps > INT64_MAX ? INT64_MAX
+        : (int64_t)max_ulps);
+    size_t off       = 0;
+    for (; off + 4 <= count; off += 4) {
+        __m256d a    = _mm256_loadu_pd(lhs + off);
+        __m256d b    = _mm256_loadu_pd(rhs + off);
+        __m256i ia   = _mm256_castpd_si256(a);
+        __m256i ib   = _mm256_castpd_si256(b);
+        __m256d diff = _mm256_and_pd(_mm256_sub_pd(a, b), _mm256_castsi256_pd(abs_mask));
+        __m256i near = _mm256_castpd_si256(_mm256_cmp_pd(diff, tol, _CMP_LE_OQ));
+
+        __m256i ma     = _mm256_and_si256(ia, abs_mask);
+        __m256i mb     = _mm256_and_si256(ib, abs_mask);
+        __m256i finite = _mm256_and_si256(_mm256_cmpgt_epi64(inf, ma),
+            _mm256_cmpgt_epi64(inf, mb));
+        __m256i apart  = _mm256_or_si256(_mm256_cmpgt_epi64(_mm256_setzero_si256(),
+            _mm256_xor_si256(ia, ib)), _mm256_or_si256(
+            _mm256_cmpgt_epi64(_mm256_sub_epi64(ma, mb), ulps),
+            _mm256_cmpgt_epi64(_mm256_sub_epi64(mb, ma), ulps)));
+        near = _mm256_and_si256(finite, _mm256_or_si256(near, _mm256_andnot_si256(apart,
+            _mm256_set1_epi64x(-1))));
+
+        __m256d ok    = _mm256_or_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ),
+            _mm256_castsi256_pd(near));
+        unsigned mask = (unsigned)_mm256_movemask_pd(ok);
+        if (0xf != mask) {
+            return off + (size_t)__builtin_ctz(~mask);
+        }
+    }
+    return off;
+}
+
+_ST_TARGET("avx2")
+static size_t _st_find_not_near_f32_avx2(const float* lhs, const float* rhs, size_t count,
+    float abs_tol, uint64_t max_ulps)
+{
+    __m256i abs_mask = _mm256_set1_epi32(INT32_MAX);
+    __m256 tol       = _mm256_set1_ps(abs_tol);
+    __m256i inf      = _mm256_set1_epi32(0x7f800000);
+    __m256i ulps     = _mm256_set1_epi32(max_ulps > INT32_MAX ? INT32_MAX : (int32_t)max_ulps);
+    size_t off       = 0;
+    for (; off + 8 <= count; off += 8) {
+        __m256 a    = _mm256_loadu_ps(lhs + off);
+        __m256 b    = _mm256_loadu_ps(rhs + off);
+        __m256i ia  = _mm256_castps_si256(a);
+        __m256i ib  = _mm256_castps_si256(b);
+        __m256 diff = _mm256_and_ps(_mm256_sub_ps(a, b), _mm256_castsi256_ps(abs_mask));
+        __m256i near = _mm256_castps_si256(_mm256_cmp_ps(diff, tol, _CMP_LE_OQ));
+
+        __m256i ma     = _mm256_and_si256(ia, abs_mask);
+        __m256i mb     = _mm256_and_si256(ib, abs_mask);
+        __m256i finite = _mm256_and_si256(_mm256_cmpgt_epi32(inf, ma),
+            _mm256_cmpgt_epi32(inf, mb));
+        __m256i apart  = _mm256_or_si256(_mm256_cmpgt_epi32(_mm256_setzero_si256(),
+            _mm256_xor_si256(ia, ib)), _mm256_or_si256(
+            _mm256_cmpgt_epi32(_mm256_sub_epi32(ma, mb), ulps),
+            _mm256_cmpgt_epi32(_mm256_sub_epi32(mb, ma), ulps)));
+        near = _mm256_and_si256(finite, _mm256_or_si256(near, _mm256_andnot_si256(apart,
+            _mm256_set1_epi32(-1))));
+
+        __m256 ok     = _mm256_or_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ),
+            _mm256_castsi256_ps(near));
+        unsigned mask = (unsigned)_mm256_movemask_ps(ok);
+        if (0xff != mask) {
+            return off + (size_t)__builtin_ctz(~mask);
+        }
+    }
+    return off;
+}
+
+_ST_TARGET("avx512f")
+static size_t _st_find_not_near_f64_avx512(const double* lhs, const double* rhs,
+    size_t count, double abs_tol, uint64_t max_ulps)
+{
+    __m512i abs_mask = _mm512_set1_epi64(INT64_MAX);
+    __m512d tol      = _mm512_set1_pd(abs_tol);
+    __m512i inf      = _mm512_set1_epi64(INT64_C(0x7ff0000000000000));
+    __m512i ulps     = _mm512_set1_epi64(max_ulps > INT64_MAX ? INT64_MAX : (int64_t)max_ulps);
+    size_t off       = 0;
+    for (; off + 8 <= count; off += 8) {
+        __m512d a    = _mm512_loadu_pd(lhs + off);
+        __m512d b    = _mm512_loadu_pd(rhs + off);
+        __m512i ia   = _mm512_castpd_si512(a);
+        __m512i ib   = _mm512_castpd_si512(b);
+        __m512d diff = _mm512_castsi512_pd(_mm512_and_si512(
+            _mm512_castpd_si512(_mm512_sub_pd(a, b)), abs_mask));
+
+        __m512i ma       = _mm512_and_si512(ia, abs_mask);
+        __m512i mb       = _mm512_and_si512(ib, abs_mask);
+        __mmask8 finite  = _mm512_cmplt_epi64_mask(ma, inf) &
+            _mm512_cmplt_epi64_mask(mb, inf);
+        __mmask8 close   = _mm512_cmpge_epi64_mask(_mm512_xor_si512(ia, ib),
+            _mm512_setzero_si512()) &
+            _mm512_cmple_epi64_mask(_mm512_abs_epi64(_mm512_sub_epi64(ma, mb)), ulps);
+        __mmask8 ok      = _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ) |
+            (finite & (_mm512_cmp_pd_mask(diff, tol, _CMP_LE_OQ) | close));
+
+        if (0xff != ok) {
+            return off + (size_t)__builtin_ctz(~(unsigned)ok);
+        }
+    }
+    return off;
+}
+
+_ST_TARGET("avx512f")
+static size_t _st_find_not_near_f32_avx512(const float* lhs, const float* rhs,
+    size_t count, float abs_tol, uint64_t max_ulps)
+{
+    __m512i abs_mask = _mm512_set1_epi32(INT32_MAX);
+    __m512 tol       = _mm512_set1_ps(abs_tol);
+    __m512i inf      = _mm512_set1_epi32(0x7f800000);
+    __m512i ulps     = _mm512_set1_epi32(max_ulps > INT32_MAX ? INT32_MAX : (int32_t)max_ulps);
+    size_t off       = 0;
+    for (; off + 16 <= count; off += 16) {
+        __m512 a     = _mm512_loadu_ps(lhs + off);
+        __m512 b     = _mm512_loadu_ps(rhs + off);
+        __m512i ia   = _mm512_castps_si512(a);
+        __m512i ib   = _mm512_castps_si512(b);
+        __m512 diff  = _mm512_castsi512_ps(_mm512_and_si512(
+            _mm512_castps_si512(_mm512_sub_ps(a, b)), abs_mask));
+
+        __m512i ma       = _mm512_and_si512(ia, abs_mask);
+        __m512i mb       = _mm512_and_si512(ib, abs_mask);
+        __mmask16 finite = _mm512_cmplt_epi32_mask(ma, inf) &
+            _mm512_cmplt_epi32_mask(mb, inf);
+        __mmask16 close  = _mm512_cmpge_epi32_mask(_mm512_xor_si512(ia, ib),
+            _mm512_setzero_si512()) &
+            _mm512_cmple_epi32_mask(_mm512_abs_epi32(_mm512_sub_epi32(ma, mb)), ulps);
+        __mmask16 ok     = _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ) |
+            (finite & (_mm512_cmp_ps_mask(diff, tol, _CMP_LE_OQ) | close));
+
+        if (0xffff != ok) {
+            return off + (size_t)__builtin_ctz(~(unsigned)ok);
+        }
+    }
+    return off;
+}
+#endif
+
+static const char* _st_format_ulps(uint64_t ulps, char str[ST_MAX_VALUE_STR_LEN])
+{
+    if (UINT64_MAX == ulps) {
+        (void)snprintf(str, ST_MAX_VALUE_STR_LEN, "%s", ST_LOC_NOT_COMPARABLE);
+    } else {
+        (void)snprintf(str, ST_MAX_VALUE_STR_LEN, "%"PRIu64" %s", ulps,
+            _ST_PLURAL(ST_LOC_ULP, ulps));
+    }
+    return str;
+}
+
+static size_t _st_find_utf8_invalid(const uint8_t* bytes, size_t len)
+{
+    size_t off = 0;
+    while (off < len) {
+        /* runs of ASCII are skipped a vector at a time; runs of multibyte sequences
+         * (e.g. CJK text) stay in this loop rather than dispatching for each one. */
+        if (bytes[off] < 0x80) {
+            off += _st_find_non_ascii(bytes + off, len - off);
+            continue;
+        }
+        size_t seq_len = _st_utf8_seq_len(bytes + off, len - off);
+        if (0 == seq_len) {
+            break;
+        }
+        off += seq_len;
+    }
+    return off;
+}
+
+static size_t _st_utf8_seq_len(const uint8_t* seq, size_t avail)
+{
+    /* RFC 3629: the range of the second byte excludes overlong forms, surrogates
+     * (U+D800-U+DFFF) and code points above U+10FFFF. */
+    size_t len = 0;
+    uint8_t lo = 0x80;
+    uint8_t hi = 0xbf;
+    if (seq[0] >= 0xc2 && seq[0] <= 0xdf) {
+        len = 2;
+    } else if (seq[0] >= 0xe0 && seq[0] <= 0xef) {
+        len = 3;
+        lo  = 0xe0 == seq[0] ? 0xa0 : lo;
+        hi  = 0xed == seq[0] ? 0x9f : hi;
+    } else if (seq[0] >= 0xf0 && seq[0] <= 0xf4) {
+        len = 4;
+        lo  = 0xf0 == seq[0] ? 0x90 : lo;
+        hi  = 0xf4 == seq[0] ? 0x8f : hi;
+    } else {
+        return 0;
+    }
+
+    if (avail < len || seq[1] < lo || seq[1] > hi) {
+        return 0;
+    }
+    for (size_t n = 2; n < len; n++) {
+        if (0x80 != (seq[n] & 0xc0)) {
+            return 0;
+        }
+    }
+    return len;
+}
+
+static const char* _st_format_char(uint8_t c, char str[8])
+{
+    if (c >= 0x20 && c < 0x7f) {
+        (void)snprintf(str, 8, "'%c'", c);
+    } else {
+        (void)snprintf(str, 8, "0x%02x", c);
+    }
+    return str;
+}
+
+static bool _st_snapshot_path(const char* name, char path[ST_MAX_SNAPSHOT_PATH_LEN])
+{
+    int len = snprintf(path, ST_MAX_SNAPSHOT_PATH_LEN, "%s/%s", ST_SNAPSHOT_DIR, name);
+    if (len < 0 || (size_t)len >= ST_MAX_SNAPSHOT_PATH_LEN) {
+        _ST_ERROR("%s " ST_LOC_SNAP_PATH, _ST_ERROR_PREFIX, name);
+        return false;
+    }
+    return true;
+}
+
+static bool _st_write_snapshot(const char* path, const void* data, size_t size)
+{
+    if (!_st_make_parent_dirs(path)) {
+        return false;
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        _ST_REPORT_ERROR(errno);
+        return false;
+    }
+
+    bool written = size == 0 || fwrite(data, 1, size, file) == size;
+    if (!written) {
+        _ST_REPORT_ERROR(errno);
+    }
+    if (0 != fclose(file) && written) {
+        _ST_REPORT_ERROR(errno);
+        written = false;
+    }
+
+    return written;
+}
+
+static bool _st_make_parent_dirs(const char* path)
+{
+    /* e.g. snapshots and snapshots/parser, for snapshots/parser/empty. */
+    char dir[ST_MAX_SNAPSHOT_PATH_LEN] = {0};
+    (void)snprintf(dir, sizeof(dir), "%s", path);
+    for (char* sep = dir + 1; *sep != '\0'; sep++) {
+#if !defined(__WIN__)
+        bool is_sep = '/' == *sep;
+#else /* __WIN__ */
+        bool is_sep = '/' == *sep || '\\' == *sep;
+#endif
+        if (!is_sep) {
+            continue;
+        }
+
+        char saved = *sep;
+        *sep = '\0';
+#if !defined(__WIN__)
+        int err = mkdir(dir, 0755);
+#else /* __WIN__ */
+        int err = _mkdir(dir);
+#endif
+        *sep = saved;
+        if (0 != err && EEXIST != errno) {
+            _ST_REPORT_ERROR(errno);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool _st_file_exists(const char* path)
+{
+#if !defined(__WIN__)
+    struct stat st;
+    return 0 == stat(path, &st) && S_ISREG(st.st_mode);
+#else /* __WIN__ */
+    DWORD attrs = GetFileAttributesA(path);
+    return INVALID_FILE_ATTRIBUTES != attrs && !(attrs & FILE_ATTRIBUTE_DIRECTORY);
+#endif
+}
+
+static inline uint64_t _st_read64le(const uint8_t* ptr)
+{
+    uint64_t value;
+    (void)memcpy(&value, ptr, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+static inline uint32_t _st_read32le(const uint8_t* ptr)
+{
+    uint32_t value;
+    (void)memcpy(&value, ptr, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap32(value);
+#endif
+    return value;
+}
+
+static inline uint64_t _st_bswap64(uint64_t value)
+{
+    value = ((value & UINT64_C(0x00FF00FF00FF00FF)) << 8) | ((value >> 8) & UINT64_C(0x00FF00FF00FF00FF));
+    value = ((value & UINT64_C(0x0000FFFF0000FFFF)) << 16) | ((value >> 16) & UINT64_C(0x0000FFFF0000FFFF));
+    return (value << 32) | (value >> 32);
+}
+
+static inline uint64_t _st_mul128_fold64(uint64_t lhs, uint64_t rhs)
+{
+#if defined(__HAVE_INT128__)
+    st_uint128 product = (st_uint128)lhs * rhs;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+#else
+    uint64_t lo_lo = (lhs & UINT32_MAX) * (rhs & UINT32_MAX);
+    uint64_t hi_lo = (lhs >> 32) * (rhs & UINT32_MAX);
+    uint64_t lo_hi = (lhs & UINT32_MAX) * (rhs >> 32);
+    uint64_t hi_hi = (lhs >> 32) * (rhs >> 32);
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & UINT32_MAX) + lo_hi;
+    uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    uint64_t lower = (cross << 32) | (lo_lo & UINT32_MAX);
+    return lower ^ upper;
+#endif
+}
+
+static inline uint64_t _st_xxh3_avalanche(uint64_t hash)
+{
+    hash ^= hash >> 37;
+    hash *= UINT64_C(0x165667919E3779F9);
+    return hash ^ (hash >> 32);
+}
+
+static inline uint64_t _st_xxh64_avalanche(uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= _ST_XXH_PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= _ST_XXH_PRIME64_3;
+    return hash ^ (hash >> 32);
+}
+
+static inline uint64_t _st_xxh3_mix16(const uint8_t* input, const uint8_t* secret)
+{
+    return _st_mul128_fold64(_st_read64le(input) ^ _st_read64le(secret),
+        _st_read64le(input + 8) ^ _st_read64le(secret + 8));
+}
+
+static uint64_t _st_xxh3_short(const uint8_t* input, size_t len)
+{
+    const uint8_t* secret = _st_xxh3_secret;
+
+    if (0 == len) {
+        return _st_xxh64_avalanche(_st_read64le(secret + 56) ^ _st_read64le(secret + 64));
+    }
+    if (len <= 3) {
+        uint32_t combined = ((uint32_t)input[0] << 16) | ((uint32_t)input[len >> 1] << 24) |
+            (uint32_t)input[len - 1] | ((uint32_t)len << 8);
+        uint64_t flip = _st_read32le(secret) ^ _st_read32le(secret + 4);
+        return _st_xxh64_avalanche(combined ^ flip);
+    }
+    if (len <= 8) {
+        uint64_t flip  = _st_read64le(secret + 8) ^ _st_read64le(secret + 16);
+        uint64_t keyed = (_st_read32le(input + len - 4) +
+            ((uint64_t)_st_read32le(input) << 32)) ^ flip;
+        keyed ^= ((keyed << 49) | (keyed >> 15)) ^ ((keyed << 24) | (keyed >> 40));
+        keyed *= UINT64_C(0x9FB21C651E98DF25);
+        keyed ^= (keyed >> 35) + len;
+        keyed *= UINT64_C(0x9FB21C651E98DF25);
+        return keyed ^ (keyed >> 28);
+    }
+    if (len <= 16) {
+        uint64_t lo = _st_read64le(input) ^
+            (_st_read64le(secret + 24) ^ _st_read64le(secret + 32));
+        uint64_t hi = _st_read64le(input + len - 8) ^
+            (_st_read64le(secret + 40) ^ _st_read64le(secret + 48));
+        uint64_t acc = len + _st_bswap64(lo) + hi + _st_mul128_fold64(lo, hi);
+        return _st_xxh3_avalanche(acc);
+    }
+
+    uint64_t acc = len * _ST_XXH_PRIME64_1;
+    if (len <= 128) {
+        /* pairs of 16-byte blocks from both ends, meeting in the middle (the loop ends
+         * when `n` wraps around). */
+        for (size_t n = (len - 1) / 32; n < 4; n--) {
+            acc += _st_xxh3_mix16(input + 16 * n, secret + 32 * n);
+            acc += _st_xxh3_mix16(input + len - 16 * (n + 1), secret + 32 * n + 16);
+        }
+        return _st_xxh3_avalanche(acc);
+    }
+
+    size_t rounds = len / 16;
+    for (size_t n = 0; n < 8; n++) {
+        acc += _st_xxh3_mix16(input + 16 * n, secret + 16 * n);
+    }
+    acc = _st_xxh3_avalanche(acc);
+    for (size_t n = 8; n < rounds; n++) {
+        acc += _st_xxh3_mix16(input + 16 * n, secret + 16 * (n - 8) + 3);
+    }
+    acc += _st_xxh3_mix16(input + len - 16, secret + _ST_XXH_SECRET_SIZE_MIN - 17);
+    return _st_xxh3_avalanche(acc);
+}
+
+static void _st_xxh3_consume(st_digest* digest, const uint8_t* input, size_t stripes)
+{
+    const uint8_t* secret = _st_xxh3_secret;
+    size_t per_block      = (_ST_XXH_SECRET_SIZE - _ST_XXH_STRIPE_LEN) / _ST_XXH_SECRET_CONSUME_RATE;
+
+    if (per_block - digest->stripes <= stripes) {
+        size_t to_end = per_block - digest->stripes;
+        _st_xxh3_accumulate(digest->acc, input,
+            secret + digest->stripes * _ST_XXH_SECRET_CONSUME_RATE, to_end);
+        _st_xxh3_scramble(digest->acc, secret + _ST_XXH_SECRET_SIZE - _ST_XXH_STRIPE_LEN);
+        _st_xxh3_accumulate(digest->acc, input + to_end * _ST_XXH_STRIPE_LEN, secret,
+            stripes - to_end);
+        digest->stripes = stripes - to_end;
+    } else {
+        _st_xxh3_accumulate(digest->acc, input,
+            secret + digest->stripes * _ST_XXH_SECRET_CONSUME_RATE, stripes);
+        digest->stripes += stripes;
+    }
+}
+
+static void _st_xxh3_accumulate(uint64_t* acc, const uint8_t* input, const uint8_t* secret,
+    size_t stripes)
+{
+#if defined(__HAVE_X86_DISPATCH__)
+    if (_st_cpu_has("avx2")) {
+        _st_xxh3_accumulate_avx2(acc, input, secret, stripes);
+        return;
+    }
+#endif
+#if defined(__SSE2__)
+    for (size_t s = 0; s < stripes; s++) {
+        const uint8_t* in  = input + s * _ST_XXH_STRIPE_LEN;
+        const uint8_t* key = secret + s * _ST_XXH_SECRET_CONSUME_RATE;
+        for (size_t n = 0; n < 4; n++) {
+            __m128i data    = _mm_loadu_si128((const __m128i*)(const void*)(in + 16 * n));
+            __m128i keyed   = _mm_xor_si128(data,
+                _mm_loadu_si128((const __m128i*)(const void*)(key + 16 * n)));
+            __m128i product = _mm_mul_epu32(keyed, _mm_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+            __m128i sum     = _mm_add_epi64(_mm_loadu_si128((const __m128i*)(void*)(acc + 2 * n)),
+                _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2)));
+            _mm_storeu_si128((__m128i*)(void*)(acc + 2 * n), _mm_add_epi64(product, sum));
+        }
+    }
+#else
+    for (size_t s = 0; s < stripes; s++) {
+        const uint8_t* in  = input + s * _ST_XXH_STRIPE_LEN;
+        const uint8_t* key = secret + s * _ST_XXH_SECRET_CONSUME_RATE;
+        for (size_t n = 0; n < 8; n++) {
+            uint64_t data  = _st_read64le(in + 8 * n);
+            uint64_t keyed = data ^ _st_read64le(key + 8 * n);
+            acc[n ^ 1] += data;
+            acc[n] += (keyed & UINT32_MAX) * (keyed >> 32);
+        }
+    }
+#endif
+}
+
+#if defined(__HAVE_X86_DISPATCH__)
+_ST_TARGET("avx2")
+static void _st_xxh3_accumulate_avx2(uint64_t* acc, const uint8_t* input,
+    const uint8_t* secret, size_t stripes)
+{
+    __m256i lanes[2] = {
+        _mm256_loadu_si256((const __m256i*)(void*)acc),
+        _mm256_loadu_si256((const __m256i*)(void*)(acc + 4))
+    };
+    for (size_t s = 0; s < stripes; s++) {
+        const uint8_t* in  = input + s * _ST_XXH_STRIPE_LEN;
+        const uint8_t* key = secret + s * _ST_XXH_SECRET_CONSUME_RATE;
+        for (size_t n = 0; n < 2; n++) {
+            __m256i data    = _mm256_loadu_si256((const __m256i*)(const void*)(in + 32 * n));
+            __m256i keyed   = _mm256_xor_si256(data,
+                _mm256_loadu_si256((const __m256i*)(const void*)(key + 32 * n)));
+            __m256i product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+            __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+            lanes[n] = _mm256_add_epi64(product, _mm256_add_epi64(lanes[n], swapped));
+        }
+    }
+    _mm256_storeu_si256((__m256i*)(void*)acc, lanes[0]);
+    _mm256_storeu_si256((__m256i*)(void*)(acc + 4), lanes[1]);
+}
+#endif
+
+static void _st_xxh3_scramble(uint64_t* acc, const uint8_t* secret)
+{
+    for (size_t n = 0; n < 8; n++) {
+        uint64_t value = acc[n] ^ (acc[n] >> 47);
+        acc[n] = (value ^ _st_read64le(secret + 8 * n)) * _ST_XXH_PRIME32_1;
+    }
+}
+
+static void _st_crc32c_init(void)
+{
+    static st_mutex lock = ST_MUTEX_INITIALIZER;
+    static bool ready    = false;
+
+    st_mutex_lock(&lock);
+    if (!ready) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t crc = n;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 1) ? (crc >> 1) ^ _ST_CRC32C_POLY : crc >> 1;
+            }
+            _st_crc32c_table[0][n] = crc;
+        }
+        for (uint32_t n = 0; n < 256; n++) {
+            for (size_t k = 1; k < 8; k++) {
+                uint32_t prev = _st_crc32c_table[k - 1][n];
+                _st_crc32c_table[k][n] = (prev >> 8) ^ _st_crc32c_table[0][prev & 0xff];
+            }
+        }
+#if defined(__HAVE_X86_DISPATCH__) && defined(__x86_64__)
+        _st_crc32c_zeros(_st_crc32c_long, _ST_CRC32C_LONG);
+        _st_crc32c_zeros(_st_crc32c_short, _ST_CRC32C_SHORT);
+#endif
+        ready = true;
+    }
+    st_mutex_unlock(&lock);
+}
+
+static uint32_t _st_crc32c_update(uint32_t crc, const uint8_t* data, size_t size)
+{
+#if defined(__HAVE_X86_DISPATCH__) && defined(__x86_64__)
+    if (_st_cpu_has("sse4.2")) {
+        return _st_crc32c_sse42(crc, data, size);
+    }
+#elif defined(__HAVE_ARM_CRC32__)
+    for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), data += sizeof(uint64_t)) {
+        crc = __crc32cd(crc, _st_read64le(data));
+    }
+    for (; size > 0; size--) {
+        crc = __crc32cb(crc, *data++);
+    }
+    return crc;
+#endif
+    /* slicing-by-8: eight table lookups per 64-bit word. */
+    for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), data += sizeof(uint64_t)) {
+        uint64_t word = _st_read64le(data) ^ crc;
+        crc = _st_crc32c_table[7][word & 0xff] ^ _st_crc32c_table[6][(word >> 8) & 0xff] ^
+            _st_crc32c_table[5][(word >> 16) & 0xff] ^ _st_crc32c_table[4][(word >> 24) & 0xff] ^
+            _st_crc32c_table[3][(word >> 32) & 0xff] ^ _st_crc32c_table[2][(word >> 40) & 0xff] ^
+            _st_crc32c_table[1][(word >> 48) & 0xff] ^ _st_crc32c_table[0][word >> 56];
+    }
+    for (; size > 0; size--) {
+        crc = _st_crc32c_table[0][(crc ^ *data++) & 0xff] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#if defined(__HAVE_X86_DISPATCH__) && defined(__x86_64__)
+_ST_TARGET("sse4.2")
+static uint32_t _st_crc32c_sse42(uint32_t crc, const uint8_t* data, size_t size)
+{
+    /* the crc32 instruction has a latency of three cycles, but a throughput of one
+     * per cycle: three independent streams are computed at once, then combined by
+     * shifting the CRCs of the first two over the length of those that follow. */
+    uint64_t crc0 = crc;
+    for (; size >= 3 * _ST_CRC32C_LONG; size -= 3 * _ST_CRC32C_LONG) {
+        uint64_t crc1 = 0;
+        uint64_t crc2 = 0;
+        for (const uint8_t* end = data + _ST_CRC32C_LONG; data < end; data += 8) {
+            crc0 = _mm_crc32_u64(crc0, _st_read64le(data));
+            crc1 = _mm_crc32_u64(crc1, _st_read64le(data + _ST_CRC32C_LONG));
+            crc2 = _mm_crc32_u64(crc2, _st_read64le(data + 2 * _ST_CRC32C_LONG));
+        }
+        crc0 = _st_crc32c_shift(_st_crc32c_long, (uint32_t)crc0) ^ crc1;
+        crc0 = _st_crc32c_shift(_st_crc32c_long, (uint32_t)crc0) ^ crc2;
+        data += 2 * _ST_CRC32C_LONG;
+    }
+    for (; size >= 3 * _ST_CRC32C_SHORT; size -= 3 * _ST_CRC32C_SHORT) {
+        uint64_t crc1 = 0;
+        uint64_t crc2 = 0;
+        for (const uint8_t* end = data + _ST_CRC32C_SHORT; data < end; data += 8) {
+            crc0 = _mm_crc32_u64(crc0, _st_read64le(data));
+            crc1 = _mm_crc32_u64(crc1, _st_read64le(data + _ST_CRC32C_SHORT));
+            crc2 = _mm_crc32_u64(crc2, _st_read64le(data + 2 * _ST_CRC32C_SHORT));
+        }
+        crc0 = _st_crc32c_shift(_st_crc32c_short, (uint32_t)crc0) ^ crc1;
+        crc0 = _st_crc32c_shift(_st_crc32c_short, (uint32_t)crc0) ^ crc2;
+        data += 2 * _ST_CRC32C_SHORT;
+    }
+    for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), data += sizeof(uint64_t)) {
+        crc0 = _mm_crc32_u64(crc0, _st_read64le(data));
+    }
+    for (; size > 0; size--) {
+        crc0 = _mm_crc32_u8((uint32_t)crc0, *data++);
+    }
+    return (uint32_t)crc0;
+}
+
+static uint32_t _st_gf2_times(const uint32_t* mat, uint32_t vec)
+{
+    uint32_t sum = 0;
+    for (; vec; vec >>= 1, mat++) {
+        if (vec & 1) {
+            sum ^= *mat;
+        }
+    }
+    return sum;
+}
+
+static void _st_crc32c_zeros(uint32_t zeros[4][256], size_t len)
+{
+    /* build the operator that appends `len` (a power of two) zero bytes to a CRC by
+     * repeatedly squaring the operator for one zero bit. */
+    uint32_t odd[32];
+    uint32_t even[32];
+    odd[0] = _ST_CRC32C_POLY;
+    for (uint32_t n = 1, row = 1; n < 32; n++, row <<= 1) {
+        odd[n] = row;
+    }
+    for (size_t n = 0; n < 32; n++) {
+        even[n] = _st_gf2_times(odd, odd[n]); /* two zero bits. */
+    }
+    for (size_t n = 0; n < 32; n++) {
+        odd[n] = _st_gf2_times(even, even[n]); /* four zero bits. */
+    }
+    const uint32_t* op = odd;
+    for (len <<= 3; len > 4; len >>= 1) {
+        uint32_t* sq = op == odd ? even : odd;
+        for (size_t n = 0; n < 32; n++) {
+            sq[n] = _st_gf2_times(op, op[n]);
+        }
+        op = sq;
+    }
+
+    for (uint32_t n = 0; n < 256; n++) {
+        zeros[0][n] = _st_gf2_times(op, n);
+        zeros[1][n] = _st_gf2_times(op, n << 8);
+        zeros[2][n] = _st_gf2_times(op, n << 16);
+        zeros[3][n] = _st_gf2_times(op, n << 24);
+    }
+}
+
+static inline uint32_t _st_crc32c_shift(uint32_t zeros[4][256], uint32_t crc)
+{
+    return zeros[0][crc & 0xff] ^ zeros[1][(crc >> 8) & 0xff] ^
+        zeros[2][(crc >> 16) & 0xff] ^ zeros[3][crc >> 24];
+}
+#endif
+
+static void _st_scratch_release(st_scratch* scratch, const st_scratch* mark)
+{
+    while (scratch->overflow != mark->overflow) {
+        st_scratch_chunk* next = scratch->overflow->next;
+        free(scratch->overflow);
+        scratch->overflow = next;
+    }
+    scratch->used = mark->used;
+}
+
+static void _st_scratch_reset(st_scratch* scratch)
+{
+    while (scratch->overflow) {
+        st_scratch_chunk* next = scratch->overflow->next;
+        free(scratch->overflow);
+        scratch->overflow = next;
     }
-#if !defined(__WIN__)
-    struct timespec ts = { msec / 1000, (msec % 1000) * 1000000 };
-    (void)nanosleep(&ts, NULL);
-#else /* __WIN__ */
-    (void)SleepEx((DWORD)msec, TRUE);
-#endif
+
+    /* grow the arena to the peak demand of the last test, so that a test making the
+     * same demands again is served from it. */
+    if (scratch->peak > scratch->size || !scratch->base) {
+        size_t size = ST_SCRATCH_MIN_SIZE;
+        while (size < scratch->peak) {
+            size *= 2;
+        }
+        free(scratch->base);
+        scratch->base = malloc(size);
+        scratch->size = scratch->base ? size : 0;
+    }
+
+    scratch->used = 0;
+    scratch->peak = 0;
 }
 
-char* st_getcwd(void)
+static void _st_scratch_free(st_scratch* scratch)
 {
-#if !defined(__WIN__)
-# if defined(__linux__) && defined(_GNU_SOURCE)
-    return get_current_dir_name();
-# else
-    return getcwd(NULL, 0);
-# endif
-#else /* __WIN__ */
-    return _getcwd(NULL, 0);
-#endif
+    scratch->peak = 0;
+    _st_scratch_reset(scratch);
+    _st_safefree(&scratch->base);
+    scratch->size = 0;
 }
 
-bool st_get_avail_fs_bytes(const char* restrict path, uint64_t* bytes)
+static bool _st_elem_table_init(st_elem_table* table, const void* elems, size_t count,
+    size_t elem_size, int kind)
 {
-    if (bytes) {
-        *bytes = 0;
+    size_t num_slots = 16;
+    while (num_slots < count * 2) {
+        num_slots *= 2;
     }
-    if (!bytes || !path || !*path) {
-        _ST_REPORT_ERROR(ST_E_INVALID);
+
+    *table = (st_elem_table){
+        .elems     = elems,
+        .elem_size = elem_size,
+        .kind      = kind,
+        .slots     = st_scratch_alloc(num_slots * sizeof(st_elem_slot)),
+        .mask      = num_slots - 1
+    };
+    if (!table->slots) {
         return false;
     }
-    _ST_DEBUG("getting available fs space (path: '%s')...", path);
-#if !defined(__WIN__)
-    struct statvfs stvfs = {0};
-    if (-1 == statvfs(path, &stvfs)) {
-        _ST_REPORT_ERROR(errno);
+
+    (void)memset(table->slots, 0, num_slots * sizeof(st_elem_slot));
+    return true;
+}
+
+static st_elem_slot* _st_elem_table_find(const st_elem_table* table, const void* elem)
+{
+    bool real     = ST_VALUE_REAL == table->kind;
+    uint64_t hash = real ? _st_hash_real(elem, table->elem_size) :
+        _st_hash_elem(elem, table->elem_size);
+    st_value value = real ? _st_read_value(elem, table->elem_size, table->kind) :
+        (st_value){0};
+
+    for (size_t pos = (size_t)hash & table->mask;; pos = (pos + 1) & table->mask) {
+        st_elem_slot* slot = &table->slots[pos];
+        if (!slot->index) {
+            return slot;
+        }
+        const unsigned char* other = table->elems + (slot->index - 1) * table->elem_size;
+        if (real) {
+            st_value other_value = _st_read_value(other, table->elem_size, table->kind);
+            if (_st_values_equal(&value, &other_value)) {
+                return slot;
+            }
+        } else if (0 == memcmp(other, elem, table->elem_size)) {
+            return slot;
+        }
+    }
+}
+
+static uint64_t _st_hash_elem(const void* elem, size_t size)
+{
+    if (size <= sizeof(uint64_t)) {
+        uint64_t value = 0;
+        (void)memcpy(&value, elem, size);
+        return _st_xxh64_avalanche(value + size);
+    }
+
+    uint64_t hash = 0;
+    const uint8_t* bytes = elem;
+    for (size_t n = 0; n < size; n += _ST_XXH_MID_SIZE_MAX) {
+        size_t len = size - n < _ST_XXH_MID_SIZE_MAX ? size - n : _ST_XXH_MID_SIZE_MAX;
+        hash = _st_xxh64_avalanche(hash ^ _st_xxh3_short(bytes + n, len));
+    }
+    return hash;
+}
+
+static uint64_t _st_hash_real(const void* elem, size_t size)
+{
+    /* by value, so that equal values hash alike: -0.0 as 0.0, and a long double not by
+     * its bytes (which include padding). */
+    double value = (double)_st_read_value(elem, size, ST_VALUE_REAL).f;
+    if (0.0 == value) {
+        value = 0.0;
+    }
+    return _st_hash_elem(&value, sizeof(value));
+}
+
+static st_value _st_read_value(const void* elem, size_t size, int kind)
+{
+    st_value value = {.kind = kind};
+    switch (kind) {
+        case ST_VALUE_SIGNED:
+            switch (size) {
+                case 1: { int8_t v;  (void)memcpy(&v, elem, size); value.i = v; return value; }
+                case 2: { int16_t v; (void)memcpy(&v, elem, size); value.i = v; return value; }
+                case 4: { int32_t v; (void)memcpy(&v, elem, size); value.i = v; return value; }
+                case 8: { int64_t v; (void)memcpy(&v, elem, size); value.i = v; return value; }
+                default: break;
+            }
+        break;
+        case ST_VALUE_UNSIGNED:
+            switch (size) {
+                case 1: { uint8_t v;  (void)memcpy(&v, elem, size); value.u = v; return value; }
+                case 2: { uint16_t v; (void)memcpy(&v, elem, size); value.u = v; return value; }
+                case 4: { uint32_t v; (void)memcpy(&v, elem, size); value.u = v; return value; }
+                case 8: { uint64_t v; (void)memcpy(&v, elem, size); value.u = v; return value; }
+                default: break;
+            }
+        break;
+        case ST_VALUE_REAL:
+            if (sizeof(float) == size) {
+                float v;
+                (void)memcpy(&v, elem, size);
+                value.f = v;
+                return value;
+            } else if (sizeof(double) == size) {
+                double v;
+                (void)memcpy(&v, elem, size);
+                value.f = v;
+                return value;
+            } else if (sizeof(long double) == size) {
+                (void)memcpy(&value.f, elem, size);
+                return value;
+            }
+        break;
+        case ST_VALUE_POINTER:
+            if (sizeof(uintptr_t) == size) {
+                uintptr_t v;
+                (void)memcpy(&v, elem, size);
+                value.u = v;
+                return value;
+            }
+        break;
+        default:
+        break;
+    }
+
+    value.kind = ST_VALUE_BYTES;
+    return value;
+}
+
+static bool _st_values_equal(const st_value* lhs, const st_value* rhs)
+{
+    if (ST_VALUE_BYTES == lhs->kind || ST_VALUE_BYTES == rhs->kind) {
         return false;
     }
-    *bytes = (stvfs.f_bavail * (stvfs.f_frsize ? stvfs.f_frsize : stvfs.f_bsize));
-#else
-    ULARGE_INTEGER free_bytes = {0};
-    if (!GetDiskFreeSpaceExA(NULL, &free_bytes, NULL, NULL)) {
-        _ST_REPORT_ERROR(GetLastError());
+    if (ST_VALUE_SIGNED == rhs->kind && ST_VALUE_SIGNED != lhs->kind) {
+        const st_value* tmp = lhs;
+        lhs = rhs;
+        rhs = tmp;
+    }
+
+    /* compare the values themselves, not as converted by C (e.g. -1 != UINT_MAX). */
+    if (ST_VALUE_REAL == lhs->kind || ST_VALUE_REAL == rhs->kind) {
+        return _st_value_to_real(lhs) == _st_value_to_real(rhs);
+    } else if (ST_VALUE_SIGNED == lhs->kind) {
+        return ST_VALUE_SIGNED == rhs->kind ? lhs->i == rhs->i :
+            lhs->i >= 0 && (uint64_t)lhs->i == rhs->u;
+    }
+    return lhs->u == rhs->u;
+}
+
+static long double _st_value_to_real(const st_value* value)
+{
+    switch (value->kind) {
+        case ST_VALUE_SIGNED:
+            return (long double)value->i;
+        case ST_VALUE_REAL:
+            return value->f;
+        default:
+            return (long double)value->u;
+    }
+}
+
+static bool _st_value_to_int(const st_value* value, int kind, size_t size, uint8_t* pattern)
+{
+    uint64_t bits = 0;
+    bool negative = false;
+    switch (value->kind) {
+        case ST_VALUE_SIGNED:
+            bits     = (uint64_t)value->i;
+            negative = value->i < 0;
+        break;
+        case ST_VALUE_UNSIGNED:
+            bits = value->u;
+        break;
+        case ST_VALUE_REAL:
+            /* only an integral value within range can equal an integer. */
+            if (value->f >= 0.0L && value->f < 0x1p64L) {
+                bits = (uint64_t)value->f;
+            } else if (value->f < 0.0L && value->f >= -0x1p63L) {
+                bits     = (uint64_t)(int64_t)value->f;
+                negative = true;
+            } else {
+                return false;
+            }
+            if ((negative ? (long double)(int64_t)bits : (long double)bits) != value->f) {
+                return false;
+            }
+        break;
+        default:
+            return false;
+    }
+
+    /* the value must be representable in the type of the elements. */
+    unsigned width = (unsigned)size * 8;
+    if (ST_VALUE_UNSIGNED == kind) {
+        if (negative || (width < 64 && bits >> width)) {
+            return false;
+        }
+    } else if (negative ? (width < 64 && ~bits >> (width - 1)) :
+        bits >> (width - 1)) {
         return false;
     }
-    *bytes = free_bytes.QuadPart;
-#endif
-    _ST_DEBUG("available fs space: %"PRIu64" bytes (%.02f GiB)", *bytes,
-        ((double)(*bytes) / 1024.0 / 1024.0));
+
+    switch (size) {
+        case 1: { uint8_t v  = (uint8_t)bits;  (void)memcpy(pattern, &v, size); break; }
+        case 2: { uint16_t v = (uint16_t)bits; (void)memcpy(pattern, &v, size); break; }
+        case 4: { uint32_t v = (uint32_t)bits; (void)memcpy(pattern, &v, size); break; }
+        default: (void)memcpy(pattern, &bits, size); break;
+    }
     return true;
 }
 
-bool st_have_inet_connection(void)
+static const char* _st_format_value(const st_value* value, char buf[ST_MAX_VALUE_STR_LEN])
 {
-#if defined(__WIN__)
-    WSADATA wsad = {0};
-    (void)WSAStartup(MAKEWORD(2, 2), &wsad);
-#endif
-    struct addrinfo hints = {
-        .ai_flags = 0,
-        .ai_family = AF_INET,
-        .ai_socktype = SOCK_STREAM
-    };
-    struct addrinfo* result = NULL;
-    int get = getaddrinfo(ST_INET_TARGET_HOST, ST_INET_TARGET_SRV,
-        (const struct addrinfo*)&hints, &result);
-    if (0 != get) {
-        __ST_REPORT_ERROR(get, gai_strerror(get));
-#if defined(__WIN__)
-        (void)WSACleanup();
+    int ret = 0;
+    switch (value->kind) {
+        case ST_VALUE_SIGNED:
+            ret = snprintf(buf, ST_MAX_VALUE_STR_LEN, "%" PRId64, value->i);
+        break;
+        case ST_VALUE_UNSIGNED:
+            ret = snprintf(buf, ST_MAX_VALUE_STR_LEN, "%" PRIu64, value->u);
+        break;
+        case ST_VALUE_REAL:
+            ret = snprintf(buf, ST_MAX_VALUE_STR_LEN, "%.*Lg", LDBL_DIG + 2, value->f);
+        break;
+        case ST_VALUE_POINTER:
+            ret = snprintf(buf, ST_MAX_VALUE_STR_LEN, "0x%" PRIx64, value->u);
+        break;
+        default:
+            ret = snprintf(buf, ST_MAX_VALUE_STR_LEN, "?");
+        break;
+    }
+    if (ret < 0) {
+        buf[0] = '\0';
+    }
+    return buf;
+}
+
+static const char* _st_format_elem(const void* elem, size_t size, int kind,
+    char buf[ST_MAX_VALUE_STR_LEN])
+{
+    st_value value = _st_read_value(elem, size, kind);
+    if (ST_VALUE_BYTES != value.kind) {
+        return _st_format_value(&value, buf);
+    }
+
+    /* as hex bytes, in memory order: {de ad be ef}. */
+    static const char digits[] = "0123456789abcdef";
+    const uint8_t* bytes = elem;
+    size_t len = 0;
+    buf[len++] = '{';
+    for (size_t n = 0; n < size; n++) {
+        if (len + sizeof("xx ...}") > ST_MAX_VALUE_STR_LEN) {
+            (void)memcpy(&buf[len], "...", 3);
+            len += 3;
+            break;
+        }
+        if (n > 0) {
+            buf[len++] = ' ';
+        }
+        buf[len++] = digits[bytes[n] >> 4];
+        buf[len++] = digits[bytes[n] & 0xf];
+    }
+    buf[len++] = '}';
+    buf[len]   = '\0';
+    return buf;
+}
+
+static size_t _st_span_find(const void* span, size_t count, size_t elem_size, int kind,
+    const st_value* value)
+{
+    uint8_t pattern[sizeof(uint64_t)];
+    bool integral = (ST_VALUE_SIGNED == kind || ST_VALUE_UNSIGNED == kind) &&
+        elem_size <= sizeof(uint64_t) && 0 == (elem_size & (elem_size - 1));
+
+    if (integral) {
+        if (!_st_value_to_int(value, kind, elem_size, pattern)) {
+            return count;
+        }
+        return _st_find_elem(span, count, elem_size, pattern);
+    } else if (ST_VALUE_BYTES == kind && ST_VALUE_POINTER == value->kind &&
+        sizeof(void*) == elem_size) {
+        uintptr_t address = (uintptr_t)value->u;
+        (void)memcpy(pattern, &address, elem_size);
+        return _st_find_elem(span, count, elem_size, pattern);
+    }
+
+    const unsigned char* elems = span;
+    for (size_t n = 0; n < count; n++) {
+        st_value elem = _st_read_value(elems + n * elem_size, elem_size, kind);
+        if (_st_values_equal(&elem, value)) {
+            return n;
+        }
+    }
+    return count;
+}
+
+static size_t _st_find_elem(const void* elems, size_t count, size_t elem_size,
+    const uint8_t* pattern)
+{
+    if (0 == count) {
+        return 0;
+    }
+
+    /* the vector kernels stop at the vector containing the element, or before the
+     * tail that doesn't fill one; either way, the scalar loops below finish. */
+    const uint8_t* bytes = elems;
+    size_t size          = count * elem_size;
+    size_t off           = 0;
+#if defined(__HAVE_X86_DISPATCH__)
+    if (_st_cpu_has("avx512bw")) {
+        off = _st_find_elem_avx512(bytes, size, elem_size, pattern);
+    } else if (_st_cpu_has("avx2")) {
+        off = _st_find_elem_avx2(bytes, size, elem_size, pattern);
+    } else if (_st_cpu_has("sse2")) {
+        off = _st_find_elem_sse2(bytes, size, elem_size, pattern);
+    }
 #endif
-        return false;
+
+    switch (elem_size) {
+        case 1: {
+            const uint8_t* found = memchr(bytes + off, pattern[0], size - off);
+            return found ? (size_t)(found - bytes) : count;
+        }
+        case 2: {
+            uint16_t want;
+            (void)memcpy(&want, pattern, sizeof(want));
+            for (; off < size; off += sizeof(want)) {
+                uint16_t elem;
+                (void)memcpy(&elem, bytes + off, sizeof(elem));
+                if (elem == want) {
+                    break;
+                }
+            }
+        }
+        break;
+        case 4: {
+            uint32_t want;
+            (void)memcpy(&want, pattern, sizeof(want));
+            for (; off < size; off += sizeof(want)) {
+                uint32_t elem;
+                (void)memcpy(&elem, bytes + off, sizeof(elem));
+                if (elem == want) {
+                    break;
+                }
+            }
+        }
+        break;
+        default: {
+            uint64_t want;
+            (void)memcpy(&want, pattern, sizeof(want));
+            for (; off < size; off += sizeof(want)) {
+                uint64_t elem;
+                (void)memcpy(&elem, bytes + off, sizeof(elem));
+                if (elem == want) {
+                    break;
+                }
+            }
+        }
+        break;
     }
 
-    _ST_DEBUG("getaddrinfo for %s [%s] OK; creating a suitable socket...",
-        ST_INET_TARGET_HOST, ST_INET_TARGET_SRV);
+    return off / elem_size;
+}
 
-    bool connected = false;
-    struct addrinfo* cur = result;
-    while (cur != NULL) {
-        st_descriptor sock = socket(AF_INET, cur->ai_socktype, cur->ai_protocol);
-        if (sock == ST_BAD_DESCRIPTOR) {
-            _ST_DEBUG("socket failed (%d)", st_last_sockerr());
-            cur = cur->ai_next;
-            continue;
+#if defined(__HAVE_X86_DISPATCH__)
+_ST_TARGET("sse2")
+static size_t _st_mismatch_sse2(const uint8_t* lhs, const uint8_t* rhs, size_t size)
+{
+    size_t off = 0;
+    for (; off + 4 * 16 <= size; off += 4 * 16) {
+        __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(const void*)(lhs + off)),
+            _mm_loadu_si128((const __m128i*)(const void*)(rhs + off)));
+        for (size_t n = 1; n < 4; n++) {
+            eq = _mm_and_si128(eq, _mm_cmpeq_epi8(
+                _mm_loadu_si128((const __m128i*)(const void*)(lhs + off + 16 * n)),
+                _mm_loadu_si128((const __m128i*)(const void*)(rhs + off + 16 * n))));
+        }
+        if (0xffff != _mm_movemask_epi8(eq)) {
+            break;
+        }
+    }
+    for (; off + 16 <= size; off += 16) {
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(
+            _mm_loadu_si128((const __m128i*)(const void*)(lhs + off)),
+            _mm_loadu_si128((const __m128i*)(const void*)(rhs + off))));
+        if (0xffff != mask) {
+            return off + (size_t)__builtin_ctz(~mask);
         }
+    }
+    return off;
+}
 
-        _ST_DEBUG("got socket descriptor %d; connecting to %s [%s]...", (int)sock,
-            ST_INET_TARGET_HOST, ST_INET_TARGET_SRV);
+_ST_TARGET("avx2")
+static size_t _st_mismatch_avx2(const uint8_t* lhs, const uint8_t* rhs, size_t size)
+{
+    size_t off = 0;
+    for (; off + 4 * 32 <= size; off += 4 * 32) {
+        __m256i eq = _mm256_cmpeq_epi8(
+            _mm256_loadu_si256((const __m256i*)(const void*)(lhs + off)),
+            _mm256_loadu_si256((const __m256i*)(const void*)(rhs + off)));
+        for (size_t n = 1; n < 4; n++) {
+            eq = _mm256_and_si256(eq, _mm256_cmpeq_epi8(
+                _mm256_loadu_si256((const __m256i*)(const void*)(lhs + off + 32 * n)),
+                _mm256_loadu_si256((const __m256i*)(const void*)(rhs + off + 32 * n))));
+        }
+        if (-1 != _mm256_movemask_epi8(eq)) {
+            break;
+        }
+    }
+    for (; off + 32 <= size; off += 32) {
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+            _mm256_loadu_si256((const __m256i*)(const void*)(lhs + off)),
+            _mm256_loadu_si256((const __m256i*)(const void*)(rhs + off))));
+        if (UINT32_MAX != mask) {
+            return off + (size_t)__builtin_ctz(~mask);
+        }
+    }
+    return off;
+}
 
-        const struct timeval timeout = {
-            .tv_sec = ST_INET_TIMEOUT,
-            .tv_usec = 0
-        };
+_ST_TARGET("avx512bw")
+static size_t _st_mismatch_avx512(const uint8_t* lhs, const uint8_t* rhs, size_t size)
+{
+    size_t off = 0;
+    for (; off + 4 * 64 <= size; off += 4 * 64) {
+        __mmask64 ne = 0;
+        for (size_t n = 0; n < 4; n++) {
+            ne |= _mm512_cmpneq_epi8_mask(_mm512_loadu_si512(lhs + off + 64 * n),
+                _mm512_loadu_si512(rhs + off + 64 * n));
+        }
+        if (0 != ne) {
+            break;
+        }
+    }
+    for (; off + 64 <= size; off += 64) {
+        __mmask64 ne = _mm512_cmpneq_epi8_mask(_mm512_loadu_si512(lhs + off),
+            _mm512_loadu_si512(rhs + off));
+        if (0 != ne) {
+            return off + (size_t)__builtin_ctzll(ne);
+        }
+    }
+    return off;
+}
 
-        (void)setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, (const void*)&timeout,
-            sizeof(timeout));
-        (void)setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const void*)&timeout,
-            sizeof(timeout));
+_ST_TARGET("sse2")
+static __m128i _st_cmpeq_sse2(__m128i lhs, __m128i rhs, size_t elem_size)
+{
+    switch (elem_size) {
+        case 1:
+            return _mm_cmpeq_epi8(lhs, rhs);
+        case 2:
+            return _mm_cmpeq_epi16(lhs, rhs);
+        case 4:
+            return _mm_cmpeq_epi32(lhs, rhs);
+        default: {
+            /* both halves of a 64-bit lane must be equal. */
+            __m128i eq = _mm_cmpeq_epi32(lhs, rhs);
+            return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+    }
+}
 
-        int conn = connect(sock, (const struct sockaddr*)cur->ai_addr,
-            (st_optlen)cur->ai_addrlen);
-        if (conn == 0) {
-            _ST_DEBUG("connected to %s!", ST_INET_TARGET_HOST);
-            connected = true;
-        } else {
-            _ST_DEBUG("connect failed (%d)", st_last_sockerr());
+_ST_TARGET("sse2")
+static size_t _st_find_elem_sse2(const uint8_t* elems, size_t size, size_t elem_size,
+    const uint8_t* pattern)
+{
+    uint8_t repeated[16];
+    for (size_t n = 0; n < sizeof(repeated); n += elem_size) {
+        (void)memcpy(&repeated[n], pattern, elem_size);
+    }
+    __m128i want = _mm_loadu_si128((const __m128i*)(const void*)repeated);
+
+    size_t off = 0;
+    for (; off + 4 * 16 <= size; off += 4 * 16) {
+        __m128i eq = _mm_setzero_si128();
+        for (size_t n = 0; n < 4; n++) {
+            eq = _mm_or_si128(eq, _st_cmpeq_sse2(
+                _mm_loadu_si128((const __m128i*)(const void*)(elems + off + 16 * n)), want,
+                elem_size));
         }
-#if !defined(__WIN__)
-        close(sock);
-#else
-        closesocket(sock);
-#endif
-        if (connected) {
+        if (0 != _mm_movemask_epi8(eq)) {
             break;
         }
-        cur = cur->ai_next;
     }
-    freeaddrinfo(result);
-#if defined(__WIN__)
-    (void)WSACleanup();
-#endif
-    return connected;
+    for (; off + 16 <= size; off += 16) {
+        unsigned mask = (unsigned)_mm_movemask_epi8(_st_cmpeq_sse2(
+            _mm_loadu_si128((const __m128i*)(const void*)(elems + off)), want, elem_size));
+        if (0 != mask) {
+            return off + (size_t)__builtin_ctz(mask);
+        }
+    }
+    return off;
+}
+
+_ST_TARGET("avx2")
+static __m256i _st_cmpeq_avx2(__m256i lhs, __m256i rhs, size_t elem_size)
+{
+    switch (elem_size) {
+        case 1:
+            return _mm256_cmpeq_epi8(lhs, rhs);
+        case 2:
+            return _mm256_cmpeq_epi16(lhs, rhs);
+        case 4:
+            return _mm256_cmpeq_epi32(lhs, rhs);
+        default:
+            return _mm256_cmpeq_epi64(lhs, rhs);
+    }
+}
+
+_ST_TARGET("avx2")
+static size_t _st_find_elem_avx2(const uint8_t* elems, size_t size, size_t elem_size,
+    const uint8_t* pattern)
+{
+    uint8_t repeated[32];
+    for (size_t n = 0; n < sizeof(repeated); n += elem_size) {
+        (void)memcpy(&repeated[n], pattern, elem_size);
+    }
+    __m256i want = _mm256_loadu_si256((const __m256i*)(const void*)repeated);
+
+    size_t off = 0;
+    for (; off + 4 * 32 <= size; off += 4 * 32) {
+        __m256i eq = _mm256_setzero_si256();
+        for (size_t n = 0; n < 4; n++) {
+            eq = _mm256_or_si256(eq, _st_cmpeq_avx2(
+                _mm256_loadu_si256((const __m256i*)(const void*)(elems + off + 32 * n)), want,
+                elem_size));
+        }
+        if (!_mm256_testz_si256(eq, eq)) {
+            break;
+        }
+    }
+    for (; off + 32 <= size; off += 32) {
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_st_cmpeq_avx2(
+            _mm256_loadu_si256((const __m256i*)(const void*)(elems + off)), want, elem_size));
+        if (0 != mask) {
+            return off + (size_t)__builtin_ctz(mask);
+        }
+    }
+    return off;
 }
+
+_ST_TARGET("avx512bw")
+static __mmask64 _st_cmpeq_avx512(__m512i lhs, __m512i rhs, size_t elem_size)
+{
+    /* one bit per element. */
+    switch (elem_size) {
+        case 1:
+            return _mm512_cmpeq_epi8_mask(lhs, rhs);
+        case 2:
+            return _mm512_cmpeq_epi16_mask(lhs, rhs);
+        case 4:
+            return _mm512_cmpeq_epi32_mask(lhs, rhs);
+        default:
+            return _mm512_cmpeq_epi64_mask(lhs, rhs);
+    }
+}
+
+_ST_TARGET("avx512bw")
+static size_t _st_find_elem_avx512(const uint8_t* elems, size_t size, size_t elem_size,
+    const uint8_t* pattern)
+{
+    uint8_t repeated[64];
+    for (size_t n = 0; n < sizeof(repeated); n += elem_size) {
+        (void)memcpy(&repeated[n], pattern, elem_size);
+    }
+    __m512i want = _mm512_loadu_si512(repeated);
+
+    size_t off = 0;
+    for (; off + 4 * 64 <= size; off += 4 * 64) {
+        __mmask64 eq = 0;
+        for (size_t n = 0; n < 4; n++) {
+            eq |= _st_cmpeq_avx512(_mm512_loadu_si512(elems + off + 64 * n), want, elem_size);
+        }
+        if (0 != eq) {
+            break;
+        }
+    }
+    for (; off + 64 <= size; off += 64) {
+        __mmask64 eq = _st_cmpeq_avx512(_mm512_loadu_si512(elems + off), want, elem_size);
+        if (0 != eq) {
+            return off + (size_t)__builtin_ctzll(eq) * elem_size;
+        }
+    }
+    return off;
+}
+#endif